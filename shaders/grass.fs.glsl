@@ -4,12 +4,45 @@ out vec4 FragColor;
 in vec2 TexCoords;
 in float GrassHeight; // Kommt vom Vertex Shader
 in vec3 WorldPos;
+in float LodFade;
+flat in float TextureLayer;
 
-uniform sampler2D texture_diffuse1;
+uniform sampler2DArray texture_diffuse1; // eine Ebene pro Gras-Typ
 uniform vec3 lightPos;
 uniform vec3 lightColor;
 uniform vec3 viewPos;
 
+// Gebackene Beleuchtung (TerrainLightBake): R = Himmels-AO, GBA = Horizont zu bis zu 3 Lichtquellen
+uniform bool useBakedLighting;
+uniform sampler2D bakedLighting;
+uniform vec2 bakedLightingMin;
+uniform vec2 bakedLightingSize;
+uniform int bakedLightChannel; // 1-3 = Horizont-Kanal des aktuellen Lichts, 0 = keiner
+
+// x = Himmels-AO, y = Sichtbarkeit des Lichts (weicher Übergang um den Horizont)
+vec2 sampleBakedLighting(vec3 worldPos, vec3 lightDir)
+{
+    if (!useBakedLighting) return vec2(1.0);
+    vec2 uv = (worldPos.xz - bakedLightingMin) / bakedLightingSize;
+    if (any(lessThan(uv, vec2(0.0))) || any(greaterThan(uv, vec2(1.0)))) return vec2(1.0);
+    vec2 texel = 1.0 / vec2(textureSize(bakedLighting, 0));
+    vec4 baked = textureLod(bakedLighting, uv * (1.0 - texel) + 0.5 * texel, 0.0);
+    float visibility = 1.0;
+    if (bakedLightChannel > 0) {
+        float horizon = baked[bakedLightChannel];
+        visibility = smoothstep(horizon - 0.05, horizon + 0.05, lightDir.y);
+    }
+    return vec2(baked.r, visibility);
+}
+
+// 4x4 Bayer-Schwelle für das Ausblenden per Dithering (kein Alpha Blending nötig)
+float bayer4(vec2 fragCoord) {
+    const float thresholds[16] = float[](0.0, 8.0, 2.0, 10.0, 12.0, 4.0, 14.0, 6.0,
+                                         3.0, 11.0, 1.0, 9.0, 15.0, 7.0, 13.0, 5.0);
+    ivec2 p = ivec2(mod(fragCoord, 4.0));
+    return (thresholds[p.y * 4 + p.x] + 0.5) / 16.0;
+}
+
 // Simple Noise Funktion für Farbvariation
 float random(vec2 st) {
     return fract(sin(dot(st.xy, vec2(12.9898,78.233))) * 43758.5453123);
@@ -17,7 +50,11 @@ float random(vec2 st) {
 
 void main()
 {
-    vec4 texColor = texture(texture_diffuse1, TexCoords);
+    // 0. LOD-Übergang
+    if (LodFade < 1.0 && LodFade < bayer4(gl_FragCoord.xy))
+        discard;
+
+    vec4 texColor = texture(texture_diffuse1, vec3(TexCoords, TextureLayer));
 
     // 1. Alpha Test
     if(texColor.a < 0.2)
@@ -51,8 +88,9 @@ void main()
     // Ambient
     vec3 ambient = 0.4 * lightColor;
 
-    // Final Mix
-    vec3 finalColor = (ambient + diffuse) * objectColor;
+    // Final Mix (gebackenes AO + Horizont-Schatten des Terrains)
+    vec2 baked = sampleBakedLighting(WorldPos, lightDir);
+    vec3 finalColor = (ambient * baked.x + diffuse * baked.y) * objectColor;
 
     // Nebel-Support (optional, falls du Nebel nutzt)
     // mix(finalColor, fogColor, fogFactor)... hier weggelassen für Übersicht
@@ -1,32 +1,188 @@
 #version 330 core
-layout (location = 0) in vec3 aPos;
-layout (location = 1) in vec2 aTexCoords;
-layout (location = 3) in mat4 aInstanceMatrix;
+#ifndef GRASS_PATCHES
+layout (location = 3) in vec3 aInstancePos;   // Fußpunkt (Welt)
+layout (location = 4) in uint aInstancePacked; // GrassInstance::packed: up (Oktaeder), yaw, Skalierung
+layout (location = 7) in uint aInstanceMeta; // Bit 0-15: Rang im Chunk (unorm16, niedriger Rang bleibt länger sichtbar), 16-23: Textur-Ebene
+#endif
 
 out vec2 TexCoords;
 out float GrassHeight; // 0.0 = Boden, 1.0 = Spitze
+flat out float TextureLayer;
 out vec3 WorldPos;     // Für Farbvariation
+out float LodFade;     // 1 = voll sichtbar, darunter gedithert ausgeblendet
 
 uniform mat4 view;
 uniform mat4 projection;
 uniform float time;
+uniform vec3 viewPos;
+
+// Distanz-LOD (wie GrassSystem::lodDensity)
+uniform float lodFullDistance;
+uniform float lodMaxDistance;
+const float LOD_FADE_BAND = 0.2; // Anteil der Dichte, über den ein Halm ein-/ausgeblendet wird
+
+const float MAX_SCALE = 1.0;     // GrassSystem::MAX_SCALE
+const float TWO_PI = 6.28318530718;
+
+// Oktaeder-Dekodierung (Y = Hauptachse, wie im terrain.vs.glsl)
+vec3 octDecode(vec2 p)
+{
+    vec3 n = vec3(p.x, 1.0 - abs(p.x) - abs(p.y), p.y);
+    float t = max(-n.y, 0.0);
+    n.x += (n.x >= 0.0) ? -t : t;
+    n.z += (n.z >= 0.0) ? -t : t;
+    return normalize(n);
+}
+
+// Kürzeste Drehung, die Y auf up abbildet (wie upRotation() in GrassSystem.cpp)
+mat3 upRotation(vec3 up)
+{
+    float h = 1.0 / max(1.0 + up.y, 1e-4);
+    return mat3(vec3(1.0 - up.x * up.x * h, -up.x, -up.x * up.z * h),
+                up,
+                vec3(-up.x * up.z * h, -up.z, 1.0 - up.z * up.z * h));
+}
+
+#ifdef GRASS_PATCHES
+// --- PROZEDURALE PATCHES ---
+// Eine Instanz = eine Patch-Zelle des Welt-Gitters, gl_VertexID / CARD_VERTICES = Karte im Patch.
+// Position, Drehung und Größe jeder Karte kommen aus einem Hash von Zelle + Karte, die Höhe aus der Raster-Textur.
+uniform sampler2D patchHeightMap;
+uniform vec2 patchHeightMin;
+uniform vec2 patchHeightSize;
+uniform vec2 patchBlockOrigin;  // Patch-Zelle der Block-Ecke (ganzzahlig)
+uniform int patchBlockSize;     // Patches pro Block-Seite
+uniform int cardsPerPatch;
+uniform float patchSpacing;
+uniform float patchScale;
+uniform float patchRadius;
+uniform int patchSeed;
+uniform int patchLayer;         // Ebene im Gras-Textur-Array
+uniform vec2 grassHeightRange;  // wie GrassSystem::isGrassSurface
+
+uint hashUint(uint x)
+{
+    x ^= x >> 16; x *= 0x7feb352du;
+    x ^= x >> 15; x *= 0x846ca68bu;
+    x ^= x >> 16;
+    return x;
+}
+
+float nextRandom(inout uint state)
+{
+    state = hashUint(state);
+    return float(state >> 8) / 16777216.0;
+}
+
+float patchHeight(vec2 worldXZ)
+{
+    vec2 texel = 1.0 / vec2(textureSize(patchHeightMap, 0));
+    vec2 uv = (worldXZ - patchHeightMin) / patchHeightSize * (1.0 - texel) + 0.5 * texel;
+    return textureLod(patchHeightMap, uv, 0.0).r;
+}
+#endif
+
+// --- KARTEN-UMRISS ---
+// Karte = Fächer aus 6 Dreiecken über 8 Umriss-Ecken (UV) pro Textur-Ebene, wie GrassSystem::computeCardOutline
+uniform sampler2D cardOutlines;
+const int CARD_VERTICES = 18;
+
+vec2 cardCorner(int vertex, int layer)
+{
+    int triangle = vertex / 3;
+    int k = vertex - triangle * 3;
+    int corner = k == 0 ? 0 : triangle + k;
+    return texelFetch(cardOutlines, ivec2(corner, layer), 0).rg;
+}
+
+// Rotation * Skalierung der Instanz
+mat3 instanceTransform(uint packed)
+{
+    vec2 oct = vec2(float(packed & 255u), float((packed >> 8) & 255u)) / 255.0 * 2.0 - 1.0;
+    float yaw = float((packed >> 16) & 255u) / 255.0 * TWO_PI;
+    float scale = float(packed >> 24) / 255.0 * MAX_SCALE;
+    float c = cos(yaw), s = sin(yaw);
+    mat3 yawRotation = mat3(vec3(c, 0.0, -s), vec3(0.0, 1.0, 0.0), vec3(s, 0.0, c));
+    return upRotation(octDecode(oct)) * yawRotation * scale;
+}
+
+float lodDensity(float d)
+{
+    if (d >= lodMaxDistance) return 0.0;
+    float density = d <= lodFullDistance ? 1.0 : (lodFullDistance * lodFullDistance) / (d * d);
+    return density * (1.0 - smoothstep(0.8 * lodMaxDistance, lodMaxDistance, d));
+}
+
+void discardVertex()
+{
+    TexCoords = vec2(0.0); GrassHeight = 0.0; WorldPos = vec3(0.0); LodFade = 0.0; TextureLayer = 0.0;
+    gl_Position = vec4(2.0, 2.0, 2.0, 1.0); // außerhalb des Clip-Raums
+}
 
 void main()
 {
-    TexCoords = aTexCoords;
-    GrassHeight = aPos.y; // Da dein Quad von 0.0 bis 1.0 in Y geht
+#ifdef GRASS_PATCHES
+    int card = gl_VertexID / CARD_VERTICES;
+    int vertex = gl_VertexID - card * CARD_VERTICES;
+    ivec2 cell = ivec2(patchBlockOrigin) + ivec2(gl_InstanceID % patchBlockSize, gl_InstanceID / patchBlockSize);
+    uint state = hashUint(uint(cell.x) * 73856093u ^ uint(cell.y) * 19349663u ^ uint(patchSeed));
+    state = hashUint(state ^ uint(card) * 0x9e3779b9u);
+
+    vec2 xz = (vec2(cell) + vec2(nextRandom(state), nextRandom(state))) * patchSpacing;
+    float yaw = nextRandom(state) * TWO_PI;
+    float scale = patchScale * mix(0.7, 1.3, nextRandom(state));
+
+    // Nur auf Grasflächen: Höhenband + maximal 45 Grad Neigung
+    float e = 0.5 * patchSpacing;
+    float h = patchHeight(xz);
+    vec3 normal = normalize(vec3(patchHeight(xz - vec2(e, 0.0)) - patchHeight(xz + vec2(e, 0.0)), 2.0 * e,
+                                 patchHeight(xz - vec2(0.0, e)) - patchHeight(xz + vec2(0.0, e))));
+    if (h < grassHeightRange.x || h > grassHeightRange.y || normal.y < 0.7071 || distance(viewPos.xz, xz) > patchRadius) {
+        discardVertex();
+        return;
+    }
+
+    vec3 instancePos = vec3(xz.x, h, xz.y);
+    float c = cos(yaw), s = sin(yaw);
+    mat3 yawRotation = mat3(vec3(c, 0.0, -s), vec3(0.0, 1.0, 0.0), vec3(s, 0.0, c));
+    // Wie addGrassType: 80% der Neigung zur Terrain-Normale
+    mat3 instanceBasis = upRotation(normalize(mix(vec3(0.0, 1.0, 0.0), normal, 0.8))) * yawRotation * scale;
+    float lodRank = (float(card) + 0.5) / float(cardsPerPatch);
+    int layer = patchLayer;
+#else
+    vec3 instancePos = aInstancePos;
+    mat3 instanceBasis = instanceTransform(aInstancePacked);
+    float lodRank = float(aInstanceMeta & 0xFFFFu) / 65535.0;
+    int vertex = gl_VertexID;
+    int layer = int(aInstanceMeta >> 16);
+#endif
+    // UV (0,0) = oben links, Karte von -0.5 bis 0.5 in X und 0 bis 1 in Y
+    vec2 texCoords = cardCorner(vertex, layer);
+    vec3 localPos = vec3(texCoords.x - 0.5, 1.0 - texCoords.y, 0.0);
+
+    // Instanzen mit Rang über der Dichte an ihrer Position fallen weg (aus dem Clip-Raum schieben)
+    float density = lodDensity(distance(viewPos, instancePos));
+    LodFade = clamp((density - lodRank) / max(density * LOD_FADE_BAND, 1e-4), 0.0, 1.0);
+    if (LodFade <= 0.0) {
+        discardVertex();
+        return;
+    }
+
+    TexCoords = texCoords;
+    TextureLayer = float(layer);
+    GrassHeight = localPos.y; // Da dein Quad von 0.0 bis 1.0 in Y geht
 
-    vec3 pos = aPos;
+    vec3 pos = localPos;
 
     // Wind Animation (Behalten wir bei)
     if(pos.y > 0.1) {
-        float noise = aInstanceMatrix[3][0] * 0.5 + aInstanceMatrix[3][2] * 0.5;
+        float noise = instancePos.x * 0.5 + instancePos.z * 0.5;
         float wave = sin(time * 2.0 + noise);
         pos.x += wave * 0.1 * pos.y; // * pos.y damit es unten fest bleibt
         pos.z += wave * 0.05 * pos.y;
     }
 
-    vec4 worldPosition = aInstanceMatrix * vec4(pos, 1.0);
+    vec4 worldPosition = vec4(instancePos + instanceBasis * pos, 1.0);
     WorldPos = worldPosition.xyz;
     gl_Position = projection * view * worldPosition;
 }
\ No newline at end of file
@@ -17,6 +17,29 @@ uniform vec3 lightColor;
 uniform bool useNormalMap;
 uniform bool useARMMap;
 
+// Gebackene Beleuchtung (TerrainLightBake): R = Himmels-AO, GBA = Horizont zu bis zu 3 Lichtquellen
+uniform bool useBakedLighting;
+uniform sampler2D bakedLighting;
+uniform vec2 bakedLightingMin;
+uniform vec2 bakedLightingSize;
+uniform int bakedLightChannel; // 1-3 = Horizont-Kanal des aktuellen Lichts, 0 = keiner
+
+// x = Himmels-AO, y = Sichtbarkeit des Lichts (weicher Übergang um den Horizont)
+vec2 sampleBakedLighting(vec3 worldPos, vec3 lightDir)
+{
+    if (!useBakedLighting) return vec2(1.0);
+    vec2 uv = (worldPos.xz - bakedLightingMin) / bakedLightingSize;
+    if (any(lessThan(uv, vec2(0.0))) || any(greaterThan(uv, vec2(1.0)))) return vec2(1.0);
+    vec2 texel = 1.0 / vec2(textureSize(bakedLighting, 0));
+    vec4 baked = textureLod(bakedLighting, uv * (1.0 - texel) + 0.5 * texel, 0.0);
+    float visibility = 1.0;
+    if (bakedLightChannel > 0) {
+        float horizon = baked[bakedLightChannel];
+        visibility = smoothstep(horizon - 0.05, horizon + 0.05, lightDir.y);
+    }
+    return vec2(baked.r, visibility);
+}
+
 void main()
 {
     vec4 albedoSample = texture(mapAlbedo, TexCoords);
@@ -63,7 +86,8 @@ void main()
     float spec = pow(max(dot(norm, halfwayDir), 0.0), max(specPower, 0.001));
     vec3 specular = vec3(0.5) * spec * (1.0 - roughness);
 
-    vec3 result = ambient + diffuse + specular;
+    vec2 baked = sampleBakedLighting(WorldPos, lightDir);
+    vec3 result = ambient * baked.x + (diffuse + specular) * baked.y;
 
     // Output (Linear, da GL_FRAMEBUFFER_SRGB aktiviert ist)
     FragColor = vec4(result, 1.0);
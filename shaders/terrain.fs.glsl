@@ -8,26 +8,90 @@ in VS_OUT {
     mat3 TBN;
 } fs_in;
 
-// Texturen
-uniform sampler2D pebblesAlbedo;
-uniform sampler2D pebblesNormal;
-uniform sampler2D pebblesARM;
-
-uniform sampler2D groundAlbedo;
-uniform sampler2D groundNormal;
-uniform sampler2D groundARM;
-
-uniform sampler2D rockAlbedo;
-uniform sampler2D rockNormal;
-uniform sampler2D rockARM;
+// Material-Texturen als Arrays, Ebene = Material (0 pebbles, 1 ground, 2 rock)
+uniform sampler2DArray albedoArray;
+uniform sampler2DArray normalArray;
+uniform sampler2DArray armArray;
 
 uniform vec3 lightPos;
 uniform vec3 lightColor;
 uniform vec3 viewPos;
 uniform float tiling;
 
-vec3 getNormalFromMap(sampler2D normalMap, vec2 uv) {
-    vec3 tangentNormal = texture(normalMap, uv).rgb * 2.0 - 1.0;
+// Gebackene Material-Gewichte (RGB = Gewicht der Ebenen 0, 1, 2) über die XZ-Ausdehnung des Terrains
+uniform sampler2D splatMap;
+uniform vec2 splatWorldMin;
+uniform vec2 splatWorldSize;
+
+// Gewichte darunter werden verworfen (Material wird gar nicht erst gesampelt), wie SPLAT_EPSILON in Terrain.h
+const float SPLAT_EPSILON = 0.02;
+
+// Ebenen der Shader-Variante (Bit 0 pebbles, 1 ground, 2 rock), wird von Terrain::loadShaders gesetzt.
+// Die Chunks einer Variante haben garantiert kein Gewicht in den fehlenden Ebenen.
+#ifndef TERRAIN_LAYERS
+#define TERRAIN_LAYERS 7
+#endif
+
+// Virtual Texture für die Albedo (optional, siehe VirtualTexture.h)
+uniform bool useVirtualTexture;
+uniform sampler2D vtPageTable;
+uniform sampler2D vtPhysical;
+uniform vec2 vtWorldMin;
+uniform vec2 vtWorldSize;
+uniform float vtPagesPerSide;
+uniform float vtMaxMip;
+uniform float vtPhysicalPages;
+
+const float VT_PAGE_SIZE = 128.0;  // VirtualTexture::PAGE_SIZE
+const float VT_PAGE_BORDER = 4.0;  // VirtualTexture::PAGE_BORDER
+
+// Gebackene Beleuchtung (TerrainLightBake): R = Himmels-AO, GBA = Horizont zu bis zu 3 Lichtquellen
+uniform bool useBakedLighting;
+uniform sampler2D bakedLighting;
+uniform vec2 bakedLightingMin;
+uniform vec2 bakedLightingSize;
+uniform int bakedLightChannel; // 1-3 = Horizont-Kanal des aktuellen Lichts, 0 = keiner
+
+// x = Himmels-AO, y = Sichtbarkeit des Lichts (weicher Übergang um den Horizont)
+vec2 sampleBakedLighting(vec3 worldPos, vec3 lightDir)
+{
+    if (!useBakedLighting) return vec2(1.0);
+    vec2 uv = (worldPos.xz - bakedLightingMin) / bakedLightingSize;
+    if (any(lessThan(uv, vec2(0.0))) || any(greaterThan(uv, vec2(1.0)))) return vec2(1.0);
+    vec2 texel = 1.0 / vec2(textureSize(bakedLighting, 0));
+    vec4 baked = textureLod(bakedLighting, uv * (1.0 - texel) + 0.5 * texel, 0.0);
+    float visibility = 1.0;
+    if (bakedLightChannel > 0) {
+        float horizon = baked[bakedLightChannel];
+        visibility = smoothstep(horizon - 0.05, horizon + 0.05, lightDir.y);
+    }
+    return vec2(baked.r, visibility);
+}
+
+// Page Table -> physischer Atlas. Alpha 0 = noch keine Page geladen.
+// Muss in uniformem Kontrollfluss aufgerufen werden (dFdx)
+vec4 sampleVirtualAlbedo(vec3 worldPos)
+{
+    float content = VT_PAGE_SIZE - 2.0 * VT_PAGE_BORDER;
+    vec2 vuv = clamp((worldPos.xz - vtWorldMin) / vtWorldSize, 0.0, 0.99999);
+    vec2 texels = vuv * vtPagesPerSide * content;
+    vec2 dx = dFdx(texels), dy = dFdy(texels);
+    float mip = clamp(floor(0.5 * log2(max(dot(dx, dx), dot(dy, dy)))), 0.0, vtMaxMip);
+
+    ivec2 page = ivec2(vuv * (vtPagesPerSide / exp2(mip)));
+    vec4 entry = floor(texelFetch(vtPageTable, page, int(mip)) * 255.0 + 0.5);
+    if (entry.a < 1.0) return vec4(0.0);
+
+    // Die Page kann von einem gröberen Vorfahren stammen (entry.b = dessen Mip)
+    vec2 inPage = fract(vuv * (vtPagesPerSide / exp2(entry.b)));
+    vec2 phys = (entry.rg * VT_PAGE_SIZE + VT_PAGE_BORDER + inPage * content) / (vtPhysicalPages * VT_PAGE_SIZE);
+    return vec4(textureLod(vtPhysical, phys, 0.0).rgb, 1.0);
+}
+
+// textureGrad statt texture: die Samples liegen in nicht-uniformen Branches,
+// dort sind die impliziten Ableitungen undefiniert
+vec3 getNormalFromMap(vec3 coord, vec2 dx, vec2 dy) {
+    vec3 tangentNormal = textureGrad(normalArray, coord, dx, dy).rgb * 2.0 - 1.0;
     return normalize(fs_in.TBN * tangentNormal);
 }
 
@@ -35,45 +99,50 @@ void main()
 {
     vec2 uv = fs_in.TexCoords * tiling;
 
-    // --- 1. Mix-Faktoren ---
-    float slope = dot(normalize(fs_in.Normal), vec3(0.0, 1.0, 0.0));
-    float height = fs_in.FragPos.y;
-
-    float pebblesWeight = 1.0 - smoothstep(-2.5, -2.0, height);
-    float rockWeight = 1.0 - smoothstep(0.5, 0.8, slope);
-    float groundWeight = 1.0 - max(pebblesWeight, rockWeight);
-
-    float total = pebblesWeight + rockWeight + groundWeight;
-    pebblesWeight /= total; rockWeight /= total; groundWeight /= total;
-
-    // --- 2. Sampling ---
-    // HINWEIS: Wir multiplizieren albedo leicht mit einer Farbe, um sie satter zu machen,
-    // oder wir machen es ganz unten global.
-    vec3 colPebbles = texture(pebblesAlbedo, uv).rgb;
-    vec3 colGround  = texture(groundAlbedo, uv).rgb;
-    vec3 colRock    = texture(rockAlbedo, uv).rgb;
-
-    vec3 nPebbles = getNormalFromMap(pebblesNormal, uv);
-    vec3 nGround  = getNormalFromMap(groundNormal, uv);
-    vec3 nRock    = getNormalFromMap(rockNormal, uv);
-
-    vec3 armPebbles = texture(pebblesARM, uv).rgb;
-    vec3 armGround  = texture(groundARM, uv).rgb;
-    vec3 armRock    = texture(rockARM, uv).rgb;
-
-    // --- 3. Blending ---
-    vec3 albedo = colPebbles * pebblesWeight + colGround * groundWeight + colRock * rockWeight;
-    vec3 normal = normalize(nPebbles * pebblesWeight + nGround * groundWeight + nRock * rockWeight);
-    vec3 arm    = armPebbles * pebblesWeight + armGround * groundWeight + armRock * rockWeight;
+    vec2 dx = dFdx(uv), dy = dFdy(uv);
+
+    // --- 1. Mix-Faktoren (aus der Splat Map) ---
+#if TERRAIN_LAYERS == 2
+    // Reiner Boden: kein Splat-Lookup nötig
+    vec3 weights = vec3(0.0, 1.0, 0.0);
+#else
+    vec2 texel = 1.0 / vec2(textureSize(splatMap, 0));
+    vec2 splatUV = (fs_in.FragPos.xz - splatWorldMin) / splatWorldSize * (1.0 - texel) + 0.5 * texel;
+    vec3 weights = texture(splatMap, splatUV).rgb;
+    weights *= step(SPLAT_EPSILON, weights);
+    weights /= max(weights.r + weights.g + weights.b, 0.0001);
+#endif
+
+    vec4 virtualAlbedo = useVirtualTexture ? sampleVirtualAlbedo(fs_in.FragPos) : vec4(0.0);
+    bool hasVirtualAlbedo = virtualAlbedo.a > 0.5;
+
+    // --- 2. Sampling + Blending ---
+    // Nur Materialien mit Gewicht > 0 werden gesampelt (meist 1 Material = 3 statt 9 Samples)
+    vec3 albedo = vec3(0.0);
+    vec3 normal = vec3(0.0);
+    vec3 arm    = vec3(0.0);
+
+    for (int layer = 0; layer < 3; layer++) {
+        if ((TERRAIN_LAYERS & (1 << layer)) == 0) continue; // zur Compile-Zeit entfernt
+        float w = weights[layer];
+        if (w <= 0.0) continue;
+        vec3 coord = vec3(uv, float(layer));
+        if (!hasVirtualAlbedo) albedo += textureGrad(albedoArray, coord, dx, dy).rgb * w;
+        normal += getNormalFromMap(coord, dx, dy) * w;
+        arm    += textureGrad(armArray, coord, dx, dy).rgb * w;
+    }
+    normal = normalize(normal);
+    if (hasVirtualAlbedo) albedo = virtualAlbedo.rgb;
 
     float ao = arm.r;
     float roughness = arm.g;
     float metallic = arm.b;
 
-    // --- 4. Beleuchtung ---
+    // --- 3. Beleuchtung ---
     vec3 ambient = 0.1 * albedo * ao; // Ambient etwas erhöht für sattere Schatten
 
     vec3 lightDir = normalize(lightPos - fs_in.FragPos);
+    vec2 baked = sampleBakedLighting(fs_in.FragPos, lightDir);
     vec3 viewDir = normalize(viewPos - fs_in.FragPos);
     vec3 halfwayDir = normalize(lightDir + viewDir);
 
@@ -85,9 +154,9 @@ void main()
     float spec = pow(max(dot(normal, halfwayDir), 0.0), specPower);
     vec3 specular = vec3(spec) * metallic * lightColor * 0.5;
 
-    vec3 result = ambient + diffuse + specular;
+    vec3 result = ambient * baked.x + (diffuse + specular) * baked.y;
 
-    // --- 5. Post-Processing Tweaks ---
+    // --- 4. Post-Processing Tweaks ---
 
     // Sättigung erhöhen (Saturation Boost)
     float saturation = 1.3; // Wert > 1.0 macht es bunter, < 1.0 macht es grauer
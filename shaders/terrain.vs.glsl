@@ -1,8 +1,9 @@
 #version 330 core
-layout (location = 0) in vec3 aPos;
-layout (location = 1) in vec3 aNormal;
-layout (location = 2) in vec2 aTexCoords;
-layout (location = 3) in vec3 aTangent;
+// Mesh: unorm16 relativ zu den Chunk-Bounds (w = Chunk-Index) | CDLOD: Grid-Position im Patch
+layout (location = 0) in vec4 aPos;
+layout (location = 1) in vec2 aNormalOct; // Oktaeder-kodierte Normale
+layout (location = 2) in vec2 aTexCoords; // half float
+layout (location = 4) in vec4 aPatch; // CDLOD: offset.xz, Größe, LOD (pro Instanz)
 
 out VS_OUT {
     vec3 FragPos;
@@ -15,16 +16,85 @@ uniform mat4 model;
 uniform mat4 view;
 uniform mat4 projection;
 
+// --- Kompaktes Mesh-Format ---
+uniform sampler2D chunkBounds; // 2 Texel pro Chunk: min, extent
+uniform vec3 tangentHint;      // Tangente wird aus der Normalen rekonstruiert
+
+// --- CDLOD Heightmap-Modus ---
+uniform bool useHeightmap;
+uniform sampler2D heightMap;
+uniform vec2 heightmapWorldMin;
+uniform vec2 heightmapWorldSize;
+uniform float patchGrid;
+uniform vec2 morphRanges[12]; // (Start, Ende) des Morph-Bereichs pro LOD
+uniform vec3 viewPos;
+
+float sampleHeight(vec2 worldXZ)
+{
+    // Texel-Mittelpunkte liegen auf den Rändern des Weltbereichs
+    vec2 texel = 1.0 / vec2(textureSize(heightMap, 0));
+    vec2 uv = (worldXZ - heightmapWorldMin) / heightmapWorldSize * (1.0 - texel) + 0.5 * texel;
+    return textureLod(heightMap, uv, 0.0).r;
+}
+
+// Oktaeder-Dekodierung (Y = Hauptachse, passend zu Terrain.cpp)
+vec3 octDecode(vec2 p)
+{
+    vec3 n = vec3(p.x, 1.0 - abs(p.x) - abs(p.y), p.y);
+    float t = max(-n.y, 0.0);
+    n.x += (n.x >= 0.0) ? -t : t;
+    n.z += (n.z >= 0.0) ? -t : t;
+    return normalize(n);
+}
+
 void main()
 {
-    vec4 worldPos = model * vec4(aPos, 1.0);
+    vec3 localPos;
+    vec3 localNormal;
+    vec3 localTangent;
+    vec2 texCoords = aTexCoords;
+
+    if (!useHeightmap) {
+        int chunk = int(aPos.w * 65535.0 + 0.5);
+        vec3 cMin = texelFetch(chunkBounds, ivec2(chunk * 2, 0), 0).xyz;
+        vec3 cExtent = texelFetch(chunkBounds, ivec2(chunk * 2 + 1, 0), 0).xyz;
+        localPos = cMin + aPos.xyz * cExtent;
+        localNormal = octDecode(aNormalOct);
+        localTangent = tangentHint;
+    } else {
+        // Grid-Position im Patch [0,1] -> Welt
+        vec2 gridPos = aPos.xz;
+        vec2 worldXZ = aPatch.xy + gridPos * aPatch.z;
+        float dist = distance(viewPos, vec3(worldXZ.x, sampleHeight(worldXZ), worldXZ.y));
+
+        // Morph: ungerade Vertices wandern auf das gröbere Grid der nächsten LOD-Stufe
+        vec2 range = morphRanges[int(aPatch.w + 0.5)];
+        float morphK = clamp((dist - range.x) / max(range.y - range.x, 0.0001), 0.0, 1.0);
+        vec2 fracPart = fract(gridPos * patchGrid * 0.5) * 2.0 / patchGrid;
+        gridPos -= fracPart * morphK;
+        worldXZ = aPatch.xy + gridPos * aPatch.z;
+
+        localPos = vec3(worldXZ.x, sampleHeight(worldXZ), worldXZ.y);
+
+        // Normale per Finite Differences über einen Texel
+        vec2 step = heightmapWorldSize / vec2(textureSize(heightMap, 0) - 1);
+        float hL = sampleHeight(worldXZ - vec2(step.x, 0.0));
+        float hR = sampleHeight(worldXZ + vec2(step.x, 0.0));
+        float hD = sampleHeight(worldXZ - vec2(0.0, step.y));
+        float hU = sampleHeight(worldXZ + vec2(0.0, step.y));
+        localNormal = normalize(vec3((hL - hR) / (2.0 * step.x), 1.0, (hD - hU) / (2.0 * step.y)));
+        localTangent = normalize(vec3(1.0, 0.0, 0.0) - localNormal * localNormal.x);
+        texCoords = (worldXZ - heightmapWorldMin) / heightmapWorldSize;
+    }
+
+    vec4 worldPos = model * vec4(localPos, 1.0);
     vs_out.FragPos = worldPos.xyz;
-    vs_out.TexCoords = aTexCoords;
+    vs_out.TexCoords = texCoords;
 
     // Normal Matrix für korrekte Normalen-Rotation
     mat3 normalMatrix = transpose(inverse(mat3(model)));
-    vec3 T = normalize(normalMatrix * aTangent);
-    vec3 N = normalize(normalMatrix * aNormal);
+    vec3 T = normalize(normalMatrix * localTangent);
+    vec3 N = normalize(normalMatrix * localNormal);
     // Gram-Schmidt Orthogonalisierung (optional aber besser)
     T = normalize(T - dot(T, N) * N);
     vec3 B = cross(N, T);
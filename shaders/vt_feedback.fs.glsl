@@ -0,0 +1,30 @@
+#version 330 core
+// Virtual Texture Feedback: schreibt pro Pixel die benötigte Page (x, z, mip) in ein Integer-Target
+layout (location = 0) out uvec4 FragFeedback;
+
+in VS_OUT {
+    vec3 FragPos;
+    vec2 TexCoords;
+    vec3 Normal;
+    mat3 TBN;
+} fs_in;
+
+uniform vec2 vtWorldMin;
+uniform vec2 vtWorldSize;
+uniform float vtPagesPerSide;
+uniform float vtMaxMip;
+uniform float vtFeedbackScale; // Feedback läuft in reduzierter Auflösung -> Ableitungen sind so viel größer
+
+const float VT_PAGE_CONTENT = 120.0; // VirtualTexture::PAGE_CONTENT
+
+void main()
+{
+    vec2 vuv = clamp((fs_in.FragPos.xz - vtWorldMin) / vtWorldSize, 0.0, 0.99999);
+    vec2 texels = vuv * vtPagesPerSide * VT_PAGE_CONTENT;
+    vec2 dx = dFdx(texels), dy = dFdy(texels);
+    float mip = 0.5 * log2(max(dot(dx, dx), dot(dy, dy))) - log2(vtFeedbackScale);
+    mip = clamp(floor(mip), 0.0, vtMaxMip);
+
+    uvec2 page = uvec2(vuv * (vtPagesPerSide / exp2(mip)));
+    FragFeedback = uvec4(page, uint(mip), 1u);
+}
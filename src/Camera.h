@@ -25,6 +25,7 @@ public:
     glm::vec3 getFront() const { return front; }
     glm::vec3 getWorldUp() const { return up; }
     float getFov() const { return fov; }
+    void setPosition(const glm::vec3& p) { position = p; }
 
     CameraMode mode;
     CameraMode lastMode;
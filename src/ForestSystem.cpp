@@ -18,94 +18,12 @@ ForestSystem::~ForestSystem() {
 
 // --- 1. TERRAIN DATEN & GRID ---
 
-void ForestSystem::initTerrainData(const std::vector<float>& terrainVertices, const std::vector<unsigned int>& terrainIndices, float terrainScale) {
-    grid.vertices = terrainVertices;
-    grid.indices = terrainIndices;
-    grid.minX = 100000.0f; grid.maxX = -100000.0f;
-    grid.minZ = 100000.0f; grid.maxZ = -100000.0f;
-
-    // Bounds berechnen & Skalieren
-    for (size_t i = 0; i < grid.vertices.size(); i += 11) {
-        grid.vertices[i]   *= terrainScale;
-        grid.vertices[i+1] *= terrainScale;
-        grid.vertices[i+2] *= terrainScale;
-
-        float x = grid.vertices[i];
-        float z = grid.vertices[i+2];
-        if (x < grid.minX) grid.minX = x;
-        if (x > grid.maxX) grid.maxX = x;
-        if (z < grid.minZ) grid.minZ = z;
-        if (z > grid.maxZ) grid.maxZ = z;
-    }
-
-    grid.minX -= 1.0f; grid.maxX += 1.0f;
-    grid.minZ -= 1.0f; grid.maxZ += 1.0f;
-
-    // Grid aufbauen
-    grid.resolution = 200;
-    grid.cellWidth = (grid.maxX - grid.minX) / grid.resolution;
-    grid.cellDepth = (grid.maxZ - grid.minZ) / grid.resolution;
-    grid.cells.resize(grid.resolution * grid.resolution);
-
-    for (size_t i = 0; i < grid.indices.size(); i += 3) {
-        unsigned int idx1 = grid.indices[i];
-        unsigned int idx2 = grid.indices[i+1];
-        unsigned int idx3 = grid.indices[i+2];
-
-        // Vereinfacht: Nur X/Z prüfen für Zuweisung
-        glm::vec3 p1(grid.vertices[idx1*11], 0, grid.vertices[idx1*11+2]);
-        glm::vec3 p2(grid.vertices[idx2*11], 0, grid.vertices[idx2*11+2]);
-        glm::vec3 p3(grid.vertices[idx3*11], 0, grid.vertices[idx3*11+2]);
-
-        float minX = std::min({p1.x, p2.x, p3.x}); float maxX = std::max({p1.x, p2.x, p3.x});
-        float minZ = std::min({p1.z, p2.z, p3.z}); float maxZ = std::max({p1.z, p2.z, p3.z});
-
-        int startX = std::max(0, std::min(grid.resolution - 1, (int)((minX - grid.minX) / grid.cellWidth)));
-        int endX   = std::max(0, std::min(grid.resolution - 1, (int)((maxX - grid.minX) / grid.cellWidth)));
-        int startZ = std::max(0, std::min(grid.resolution - 1, (int)((minZ - grid.minZ) / grid.cellDepth)));
-        int endZ   = std::max(0, std::min(grid.resolution - 1, (int)((maxZ - grid.minZ) / grid.cellDepth)));
-
-        for (int x = startX; x <= endX; x++) {
-            for (int z = startZ; z <= endZ; z++) {
-                grid.cells[z * grid.resolution + x].push_back(i);
-            }
-        }
-    }
-    grid.isBuilt = true;
-    std::cout << "[Forest] Terrain Grid initialisiert." << std::endl;
+void ForestSystem::initTerrainData(const TerrainQuery& terrainQuery) {
+    terrain = &terrainQuery;
+    std::cout << "[Forest] Terrain Service gesetzt." << std::endl;
 }
 
-float ForestSystem::getYFromGrid(float x, float z) {
-    if (!grid.isBuilt) return 0.0f;
-    int gridX = (int)((x - grid.minX) / grid.cellWidth);
-    int gridZ = (int)((z - grid.minZ) / grid.cellDepth);
-
-    if (gridX < 0 || gridX >= grid.resolution || gridZ < 0 || gridZ >= grid.resolution) return -1000.0f;
-
-    for (int idxStart : grid.cells[gridZ * grid.resolution + gridX]) {
-        unsigned int idx1 = grid.indices[idxStart];
-        unsigned int idx2 = grid.indices[idxStart+1];
-        unsigned int idx3 = grid.indices[idxStart+2];
-
-        glm::vec3 p1(grid.vertices[idx1*11], grid.vertices[idx1*11+1], grid.vertices[idx1*11+2]);
-        glm::vec3 p2(grid.vertices[idx2*11], grid.vertices[idx2*11+1], grid.vertices[idx2*11+2]);
-        glm::vec3 p3(grid.vertices[idx3*11], grid.vertices[idx3*11+1], grid.vertices[idx3*11+2]);
-
-        float det = (p2.z - p3.z) * (p1.x - p3.x) + (p3.x - p2.x) * (p1.z - p3.z);
-        if (std::abs(det) < 0.001f) continue;
-        float l1 = ((p2.z - p3.z) * (x - p3.x) + (p3.x - p2.x) * (z - p3.z)) / det;
-        float l2 = ((p3.z - p1.z) * (x - p3.x) + (p1.x - p3.x) * (z - p3.z)) / det;
-        float l3 = 1.0f - l1 - l2;
-
-        if (l1 >= 0.0f && l2 >= 0.0f && l3 >= 0.0f) {
-            return l1 * p1.y + l2 * p2.y + l3 * p3.y;
-        }
-    }
-    return -1000.0f;
-}
-
-bool ForestSystem::isForestSurface(float x, float z) {
-    float y = getYFromGrid(x, z);
+bool ForestSystem::isForestSurface(float y) {
     if (y < -500.0f) return false;
     // Höhenbegrenzung: Nicht im Wasser, nicht auf Gipfeln
     if (y < 2.0f || y > 35.0f) return false;
@@ -125,18 +43,48 @@ Model* ForestSystem::getOrLoadModel(const std::string& path) {
         std::cout << "Lade Asset: " << path << std::endl;
         ForestType newType;
         newType.model = new Model(path);
+        glm::vec3 bMin(1e30f), bMax(-1e30f);
+        for (const auto& mesh : newType.model->meshes) {
+            for (const auto& v : mesh.vertices) {
+                bMin = glm::min(bMin, v.Position);
+                bMax = glm::max(bMax, v.Position);
+            }
+        }
+        if (bMin.x <= bMax.x) { newType.boundsMin = bMin; newType.boundsMax = bMax; }
         forestTypes[path] = newType;
     }
     return forestTypes[path].model;
 }
 
+// Welt-AABB jeder Instanz -> Kugel im oberen Teil (Krone), etwas kleiner als die Ausdehnung
+void ForestSystem::collectOccluders(std::vector<glm::vec4>& out) const {
+    for (const auto& pair : forestTypes) {
+        const ForestType& type = pair.second;
+        for (const auto& instance : type.instances) {
+            glm::vec3 wMin(1e30f), wMax(-1e30f);
+            for (int c = 0; c < 8; c++) {
+                glm::vec3 corner((c & 1) ? type.boundsMax.x : type.boundsMin.x,
+                                 (c & 2) ? type.boundsMax.y : type.boundsMin.y,
+                                 (c & 4) ? type.boundsMax.z : type.boundsMin.z);
+                glm::vec3 w = glm::vec3(instance.transform * glm::vec4(corner, 1.0f));
+                wMin = glm::min(wMin, w);
+                wMax = glm::max(wMax, w);
+            }
+            glm::vec3 extent = wMax - wMin;
+            float radius = 0.4f * (extent.x + extent.z) * 0.5f;
+            if (radius <= 0.0f) continue;
+            glm::vec3 center((wMin.x + wMax.x) * 0.5f, wMin.y + extent.y * 0.65f, (wMin.z + wMax.z) * 0.5f);
+            out.push_back(glm::vec4(center, radius));
+        }
+    }
+}
+
 // --- 2. SPAWNING LOGIK ---
 
-void ForestSystem::spawnObject(const std::string& path, float x, float z, float scale, float rotationVar) {
-    if (!isForestSurface(x, z)) return;
+void ForestSystem::spawnObject(const std::string& path, float x, float y, float z, float scale, float rotationVar) {
+    if (!isForestSurface(y)) return;
 
     getOrLoadModel(path);
-    float y = getYFromGrid(x, z);
 
     glm::mat4 model = glm::mat4(1.0f);
     model = glm::translate(model, glm::vec3(x, y, z));
@@ -163,6 +111,30 @@ void ForestSystem::spawnObject(const std::string& path, float x, float z, float
     globalPositions.push_back(glm::vec2(x, z));
 }
 
+// Merkt sich einen Spawn-Kandidaten, die Höhe wird später gesammelt abgefragt
+void ForestSystem::queueSpawn(const std::string& path, float x, float z, float scale, float minDist) {
+    pendingSpawns.push_back({path, x, z, scale, minDist});
+}
+
+// Fragt alle Kandidaten eines Clusters in einem Batch ab und spawnt sie in Reihenfolge
+void ForestSystem::flushSpawns() {
+    if (pendingSpawns.empty()) return;
+
+    size_t count = pendingSpawns.size();
+    std::vector<float> xs(count), zs(count), ys(count);
+    for (size_t i = 0; i < count; i++) {
+        xs[i] = pendingSpawns[i].x;
+        zs[i] = pendingSpawns[i].z;
+    }
+    terrain->sampleBatch(xs.data(), zs.data(), count, ys.data(), nullptr, TerrainQueryMode::Exact);
+
+    for (size_t i = 0; i < count; i++) {
+        const SpawnRequest& req = pendingSpawns[i];
+        if (checkDistance(req.x, req.z, req.minDist)) spawnObject(req.path, req.x, ys[i], req.z, req.scale, 360.0f);
+    }
+    pendingSpawns.clear();
+}
+
 // --- NEUE FUNKTION: Simuliertes Perlin-Noise für Biome ---
 // Gibt Werte zwischen ca. -1.0 und 1.0 zurück.
 // Erzeugt organische, große Formen.
@@ -179,13 +151,13 @@ float getBiomeNoise(float x, float z) {
 }
 
 void ForestSystem::addBiomeCluster(const std::string& type, int groups, const std::string& assetPath) {
-    if (!grid.isBuilt) return;
+    if (!terrain) return;
 
     std::random_device rd;
     std::mt19937 gen(rd());
     // Randbereich nutzen
-    std::uniform_real_distribution<float> disX(grid.minX + 10.0f, grid.maxX - 10.0f);
-    std::uniform_real_distribution<float> disZ(grid.minZ + 10.0f, grid.maxZ - 10.0f);
+    std::uniform_real_distribution<float> disX(terrain->getMinX() + 10.0f, terrain->getMaxX() - 10.0f);
+    std::uniform_real_distribution<float> disZ(terrain->getMinZ() + 10.0f, terrain->getMaxZ() - 10.0f);
 
     // Radius groß lassen für fließende Übergänge
     std::normal_distribution<float> clusterDist(0.0f, 16.0f);
@@ -201,7 +173,7 @@ void ForestSystem::addBiomeCluster(const std::string& type, int groups, const st
         float centerX = disX(gen);
         float centerZ = disZ(gen);
 
-        if (!isForestSurface(centerX, centerZ)) continue;
+        if (!isForestSurface(terrain->getHeight(centerX, centerZ))) continue;
 
         // 2. [NEU] BIOME CHECK - "Darf dieser Wald hier wachsen?"
         float noise = getBiomeNoise(centerX, centerZ);
@@ -242,21 +214,21 @@ void ForestSystem::addBiomeCluster(const std::string& type, int groups, const st
                 float ox = centerX + clusterDist(gen);
                 float oz = centerZ + clusterDist(gen);
                 std::string treeName = (rand()%2 == 0) ? "Birch_Tree_1.glb" : "Birch_Tree_2.glb";
-                if(checkDistance(ox, oz, 0.3f)) spawnObject(assetPath + treeName, ox, oz, 0.0025f, 360.0f);
+                queueSpawn(assetPath + treeName, ox, oz, 0.0025f, 0.3f);
             }
             // Junge Birken
             for(int t=0; t<25; t++) {
                 float ox = centerX + clusterDist(gen);
                 float oz = centerZ + clusterDist(gen);
-                if(checkDistance(ox, oz, 0.2f)) spawnObject(assetPath + "Young_Birch_Tree_1.glb", ox, oz, 0.0015f, 360.0f);
+                queueSpawn(assetPath + "Young_Birch_Tree_1.glb", ox, oz, 0.0015f, 0.2f);
             }
             // Unterholz
             int bushCount = 60 + rand() % 20;
             for(int b=0; b<bushCount; b++) {
                 float ox = centerX + clusterDist(gen) * 1.5f;
                 float oz = centerZ + clusterDist(gen) * 1.5f;
-                if(rand()%2==0) { if(checkDistance(ox, oz, 0.25f)) spawnObject(assetPath + "Blackberry_Bush_1a.glb", ox, oz, 0.0015f, 360.0f); }
-                else { if(checkDistance(ox, oz, 0.2f)) spawnObject(assetPath + "Fern_1a.glb", ox, oz, 0.002f, 360.0f); }
+                if(rand()%2==0) { queueSpawn(assetPath + "Blackberry_Bush_1a.glb", ox, oz, 0.0015f, 0.25f); }
+                else { queueSpawn(assetPath + "Fern_1a.glb", ox, oz, 0.002f, 0.2f); }
             }
         }
         else if (type == "Pine") {
@@ -268,19 +240,19 @@ void ForestSystem::addBiomeCluster(const std::string& type, int groups, const st
                 std::string treeName;
                 int roll = rand() % 3;
                 if(roll == 0) treeName = "Pine_Tree_1.glb"; else if(roll == 1) treeName = "Pine_Tree_2.glb"; else treeName = "Fir_Tree_1.glb";
-                if(checkDistance(ox, oz, 0.25f)) spawnObject(assetPath + treeName, ox, oz, 0.0025f, 360.0f);
+                queueSpawn(assetPath + treeName, ox, oz, 0.0025f, 0.25f);
             }
             // Junge Tannen
             for(int t=0; t<25; t++) {
                 float ox = centerX + clusterDist(gen); float oz = centerZ + clusterDist(gen);
-                if(checkDistance(ox, oz, 0.2f)) spawnObject(assetPath + "Young_Fir_Tree_1.glb", ox, oz, 0.0015f, 360.0f);
+                queueSpawn(assetPath + "Young_Fir_Tree_1.glb", ox, oz, 0.0015f, 0.2f);
             }
             // Details
             int detailCount = 50 + rand() % 20;
             for(int d=0; d<detailCount; d++) {
                 float ox = centerX + clusterDist(gen); float oz = centerZ + clusterDist(gen);
-                if(rand()%2==0) { if(checkDistance(ox, oz, 0.4f)) spawnObject(assetPath + "Rock_1.glb", ox, oz, 0.005f, 360.0f); }
-                else { if(checkDistance(ox, oz, 0.1f)) spawnObject(assetPath + "Fly_Agaric_Group_1.glb", ox, oz, 0.002f, 360.0f); }
+                if(rand()%2==0) { queueSpawn(assetPath + "Rock_1.glb", ox, oz, 0.005f, 0.4f); }
+                else { queueSpawn(assetPath + "Fly_Agaric_Group_1.glb", ox, oz, 0.002f, 0.1f); }
             }
         }
         else if (type == "Oak") {
@@ -288,14 +260,14 @@ void ForestSystem::addBiomeCluster(const std::string& type, int groups, const st
              int treeCount = 18 + rand() % 5;
              for(int t=0; t<treeCount; t++) {
                 float ox = centerX + clusterDist(gen); float oz = centerZ + clusterDist(gen);
-                if(checkDistance(ox, oz, 0.6f)) spawnObject(assetPath + "Oak_Tree_1.glb", ox, oz, 0.0028f, 360.0f);
+                queueSpawn(assetPath + "Oak_Tree_1.glb", ox, oz, 0.0028f, 0.6f);
              }
              // Brennnesseln
              int nettleCount = 90 + rand() % 30;
              for(int n=0; n<nettleCount; n++) {
                  float ox = centerX + clusterDist(gen) * 1.3f; float oz = centerZ + clusterDist(gen) * 1.3f;
-                 if(rand()%2==0) { if(checkDistance(ox, oz, 0.15f)) spawnObject(assetPath + "Stinging_Nettle_1.glb", ox, oz, 0.002f, 360.0f); }
-                 else { if(checkDistance(ox, oz, 0.15f)) spawnObject(assetPath + "Forest_Grass_1.glb", ox, oz, 0.002f, 360.0f); }
+                 if(rand()%2==0) { queueSpawn(assetPath + "Stinging_Nettle_1.glb", ox, oz, 0.002f, 0.15f); }
+                 else { queueSpawn(assetPath + "Forest_Grass_1.glb", ox, oz, 0.002f, 0.15f); }
              }
         }
         else if (type == "Scrub") {
@@ -307,16 +279,47 @@ void ForestSystem::addBiomeCluster(const std::string& type, int groups, const st
                 float oz = centerZ + clusterDist(gen) * 2.5f;
 
                 int roll = rand() % 4;
-                if(roll == 0) { if(checkDistance(ox,oz,0.2f)) spawnObject(assetPath + "Fern_1a.glb", ox, oz, 0.002f, 360.0f); }
-                else if (roll == 1) { if(checkDistance(ox,oz,0.2f)) spawnObject(assetPath + "Blackberry_Bush_1a.glb", ox, oz, 0.0015f, 360.0f); }
-                else if (roll == 2) { if(checkDistance(ox,oz,0.5f)) spawnObject(assetPath + "Rock_2.glb", ox, oz, 0.004f, 360.0f); }
-                else { if(checkDistance(ox,oz,0.2f)) spawnObject(assetPath + "Forest_Grass_1.glb", ox, oz, 0.002f, 360.0f); }
+                if(roll == 0) { queueSpawn(assetPath + "Fern_1a.glb", ox, oz, 0.002f, 0.2f); }
+                else if (roll == 1) { queueSpawn(assetPath + "Blackberry_Bush_1a.glb", ox, oz, 0.0015f, 0.2f); }
+                else if (roll == 2) { queueSpawn(assetPath + "Rock_2.glb", ox, oz, 0.004f, 0.5f); }
+                else { queueSpawn(assetPath + "Forest_Grass_1.glb", ox, oz, 0.002f, 0.2f); }
             }
         }
+
+        // Höhen aller Kandidaten dieses Clusters gesammelt abfragen und spawnen
+        flushSpawns();
     }
     std::cout << "Biome Cluster '" << type << "' erstellt: " << groupsCreated << " Gruppen." << std::endl;
 }
 
+// --- EDITOR: RE-SNAP ---
+// Wie beim Spawnen: Translation = Fußpunkt, Höhe exakt aus dem Grid. Betroffene Typen werden neu hochgeladen.
+void ForestSystem::resnapRegion(const glm::vec2& regionMin, const glm::vec2& regionMax) {
+    if (!terrain) return;
+
+    std::vector<glm::mat4*> hits;
+    std::vector<float> xs, zs, ys;
+    for (auto& entry : forestTypes) {
+        ForestType& fType = entry.second;
+        hits.clear(); xs.clear(); zs.clear();
+        for (auto& inst : fType.instances) {
+            const glm::vec4& p = inst.transform[3];
+            if (p.x < regionMin.x || p.x > regionMax.x || p.z < regionMin.y || p.z > regionMax.y) continue;
+            hits.push_back(&inst.transform);
+            xs.push_back(p.x);
+            zs.push_back(p.z);
+        }
+        if (hits.empty()) continue;
+
+        ys.resize(hits.size());
+        terrain->sampleBatch(xs.data(), zs.data(), hits.size(), ys.data(), nullptr, TerrainQueryMode::Exact);
+        for (size_t h = 0; h < hits.size(); h++) {
+            if (ys[h] > TerrainQuery::NO_HEIGHT) (*hits[h])[3].y = ys[h];
+        }
+        fType.isSetup = false;
+    }
+}
+
 // --- 3. INSTANCED RENDERING SETUP ---
 
 void ForestSystem::updateInstances() {
@@ -8,6 +8,7 @@
 
 #include "Shader.h"
 #include "Model.h"
+#include "TerrainQuery.h"
 
 // Definition einer einzelnen Instanz (Position/Rotation/Scale als Matrix)
 struct TreeInstance {
@@ -18,6 +19,8 @@ struct TreeInstance {
 // Enthält das 3D-Modell und eine Liste ALLER Positionen dieses Baums
 struct ForestType {
     Model* model = nullptr;
+    glm::vec3 boundsMin = glm::vec3(0.0f); // Model-Space, aus den Vertices beim Laden
+    glm::vec3 boundsMax = glm::vec3(0.0f);
 
     // CPU-Daten: Liste aller Instanzen
     std::vector<TreeInstance> instances;
@@ -33,14 +36,18 @@ public:
     ForestSystem();
     ~ForestSystem();
 
-    // Initialisiert das Terrain-Grid für Höhenberechnung
-    void initTerrainData(const std::vector<float>& vertices,
-                         const std::vector<unsigned int>& indices,
-                         float terrainScale);
+    // Setzt den geteilten Terrain-Service für Höhenberechnung
+    void initTerrainData(const TerrainQuery& terrainQuery);
 
     // Erstellt thematische Wälder ("Birch", "Pine", "Oak", "Scrub")
     void addBiomeCluster(const std::string& type, int groups, const std::string& assetPath);
 
+    // Editor: Instanzen im XZ-Bereich auf die aktuelle Terrain-Höhe setzen (nach einem Terrain-Edit)
+    void resnapRegion(const glm::vec2& regionMin, const glm::vec2& regionMax);
+
+    // Baumkronen als Kugeln (xyz = Mitte, w = Radius) für den Licht-Bake
+    void collectOccluders(std::vector<glm::vec4>& out) const;
+
     // Zeichnet alle Bäume (nutzt Instancing für Performance)
     void draw(Shader& shader, const glm::mat4& view, const glm::mat4& projection, const glm::vec3& viewPos);
 
@@ -48,8 +55,19 @@ private:
     // Lädt die Matrizen in den VBO (wird automatisch von draw aufgerufen)
     void updateInstances();
 
-    // Hilfsfunktion: Platziert ein einzelnes Objekt
-    void spawnObject(const std::string& path, float x, float z, float scale, float rotationVar);
+    // Hilfsfunktion: Platziert ein einzelnes Objekt (Höhe y kommt aus dem Batch-Lookup)
+    void spawnObject(const std::string& path, float x, float y, float z, float scale, float rotationVar);
+
+    // Spawn-Kandidaten eines Clusters sammeln und gemeinsam abfragen
+    struct SpawnRequest {
+        std::string path;
+        float x, z;
+        float scale;
+        float minDist;
+    };
+    std::vector<SpawnRequest> pendingSpawns;
+    void queueSpawn(const std::string& path, float x, float z, float scale, float minDist);
+    void flushSpawns();
 
     // Hilfsfunktion: Lädt Modell nur einmal (Caching)
     Model* getOrLoadModel(const std::string& path);
@@ -61,17 +79,8 @@ private:
     std::vector<glm::vec2> globalPositions;
     bool checkDistance(float x, float z, float minDist);
 
-    // Grid-System für schnelle Höhenabfrage (wie beim Gras)
-    struct Grid {
-        std::vector<float> vertices;
-        std::vector<unsigned int> indices;
-        float minX, maxX, minZ, maxZ;
-        float cellWidth, cellDepth;
-        int resolution;
-        bool isBuilt = false;
-        std::vector<std::vector<int>> cells;
-    } grid;
-
-    float getYFromGrid(float x, float z);
-    bool isForestSurface(float x, float z);
+    // Geteilter Terrain-Service (Höhenabfrage, gleiche Daten wie beim Gras)
+    const TerrainQuery* terrain = nullptr;
+
+    bool isForestSurface(float y);
 };
\ No newline at end of file
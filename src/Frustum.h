@@ -0,0 +1,45 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+// View-Frustum aus einer (Projection * View * Model) Matrix.
+// Die Ebenen liegen im Raum der Matrix-Eingabe: mit proj * view * model kann man
+// direkt gegen Bounding Boxes im Model-Space testen.
+struct Frustum {
+    glm::vec4 planes[6]; // left, right, bottom, top, near, far (Normale zeigt nach innen)
+
+    Frustum() = default;
+    explicit Frustum(const glm::mat4& m) { extract(m); }
+
+    // Gribb/Hartmann Ebenen-Extraktion
+    void extract(const glm::mat4& m) {
+        glm::vec4 row0(m[0][0], m[1][0], m[2][0], m[3][0]);
+        glm::vec4 row1(m[0][1], m[1][1], m[2][1], m[3][1]);
+        glm::vec4 row2(m[0][2], m[1][2], m[2][2], m[3][2]);
+        glm::vec4 row3(m[0][3], m[1][3], m[2][3], m[3][3]);
+
+        planes[0] = row3 + row0;
+        planes[1] = row3 - row0;
+        planes[2] = row3 + row1;
+        planes[3] = row3 - row1;
+        planes[4] = row3 + row2;
+        planes[5] = row3 - row2;
+
+        for (auto& p : planes) {
+            float len = glm::length(glm::vec3(p));
+            if (len > 0.0f) p /= len;
+        }
+    }
+
+    // Achsen-parallele Box: sichtbar, wenn sie nicht komplett hinter einer Ebene liegt
+    bool isBoxVisible(const glm::vec3& boxMin, const glm::vec3& boxMax) const {
+        for (const auto& p : planes) {
+            // "Positive Vertex": die Ecke, die am weitesten in Richtung Normale liegt
+            glm::vec3 pv(p.x >= 0.0f ? boxMax.x : boxMin.x,
+                         p.y >= 0.0f ? boxMax.y : boxMin.y,
+                         p.z >= 0.0f ? boxMax.z : boxMin.z);
+            if (p.x * pv.x + p.y * pv.y + p.z * pv.z + p.w < 0.0f) return false;
+        }
+        return true;
+    }
+};
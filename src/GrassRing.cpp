@@ -0,0 +1,187 @@
+#include "GrassRing.h"
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+
+GrassRing::GrassRing(float size, int ringRadius, int capacity, TileGenerator gen, int workerCount)
+    : tileSize(size), radius(std::max(ringRadius, 1)), slotCapacity(std::max(capacity, 1)), generator(std::move(gen)) {
+    ringSize = 2 * radius + 1;
+    slots.resize((size_t)ringSize * ringSize);
+
+    // Fester Puffer für alle Slots, danach nur noch glBufferSubData
+    size_t instances = slots.size() * (size_t)slotCapacity;
+    glGenBuffers(1, &instanceVBO);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, instances * sizeof(GrassInstance), nullptr, GL_DYNAMIC_DRAW);
+    glGenBuffers(1, &metaVBO);
+    glBindBuffer(GL_ARRAY_BUFFER, metaVBO);
+    glBufferData(GL_ARRAY_BUFFER, instances * sizeof(uint32_t), nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    stats.bufferBytes = instances * (sizeof(GrassInstance) + sizeof(uint32_t));
+
+    workerCount = std::max(1, workerCount);
+    for (int i = 0; i < workerCount; i++) workers.emplace_back(&GrassRing::workerLoop, this);
+
+    std::cout << "Gras-Ring: " << ringSize << "x" << ringSize << " Tiles a " << tileSize << "m, " << slotCapacity
+              << " Instanzen pro Slot (" << stats.bufferBytes / (1024 * 1024) << " MB), "
+              << workerCount << " Worker-Threads." << std::endl;
+}
+
+GrassRing::~GrassRing() {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopWorkers = true;
+    }
+    queueCondition.notify_all();
+    for (auto& worker : workers) {
+        if (worker.joinable()) worker.join();
+    }
+    glDeleteBuffers(1, &instanceVBO);
+    glDeleteBuffers(1, &metaVBO);
+}
+
+int GrassRing::slotOf(int tileX, int tileZ) const {
+    int sx = ((tileX % ringSize) + ringSize) % ringSize;
+    int sz = ((tileZ % ringSize) + ringSize) % ringSize;
+    return sz * ringSize + sx;
+}
+
+// Erwartet queueMutex gehalten
+void GrassRing::request(int slot) {
+    Slot& s = slots[slot];
+    queue.push_back({ s.key, slot, s.generation });
+    s.requested = true;
+}
+
+// --- UPDATE ---
+void GrassRing::update(const glm::vec3& camPos) {
+    int cx = (int)std::floor(camPos.x / tileSize);
+    int cz = (int)std::floor(camPos.z / tileSize);
+
+    // 1. Slots den Tiles im Quadrat um die Kamera zuordnen, nahe Tiles zuerst anfordern
+    std::vector<std::pair<int, int>> wanted; // (Abstand², Slot)
+    for (int dz = -radius; dz <= radius; dz++) {
+        for (int dx = -radius; dx <= radius; dx++) {
+            int slot = slotOf(cx + dx, cz + dz);
+            Slot& s = slots[slot];
+            uint64_t key = makeKey(cx + dx, cz + dz);
+            if (!s.assigned || s.key != key) {
+                // Tile hat den Ring verlassen: Slot sofort frei, laufende Anforderungen verfallen
+                s.assigned = true;
+                s.key = key;
+                s.resident = false;
+                s.count = 0;
+                s.generation++;
+                s.requested = false;
+            }
+            if (!s.requested && (!s.resident || s.residentGeneration != s.generation))
+                wanted.push_back({ dx * dx + dz * dz, slot });
+        }
+    }
+    std::sort(wanted.begin(), wanted.end());
+
+    std::vector<Result> ready;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        // Veraltete Anforderungen entfernen, bevor ein Worker sie anfasst
+        queue.erase(std::remove_if(queue.begin(), queue.end(), [this](const Request& r) {
+            return slots[r.slot].generation != r.generation;
+        }), queue.end());
+        for (const auto& w : wanted) request(w.second);
+
+        // 2. Fertige Tiles übernehmen (begrenzt pro Frame)
+        size_t take = std::min(results.size(), (size_t)MAX_UPLOADS_PER_FRAME);
+        ready.assign(std::make_move_iterator(results.begin()), std::make_move_iterator(results.begin() + take));
+        results.erase(results.begin(), results.begin() + take);
+        stats.tilesPending = (int)(queue.size() + results.size()) + inFlight;
+    }
+    queueCondition.notify_all();
+
+    for (Result& result : ready) {
+        Slot& s = slots[result.slot];
+        if (result.generation != s.generation) continue; // Kamera ist inzwischen woanders oder neu angefordert
+
+        // Instanzen liegen in LOD-Reihenfolge: bei Überlauf fallen die höchsten Ränge weg
+        const GrassRingTile& tile = result.tile;
+        int count = std::min((int)tile.instances.size(), slotCapacity);
+        s.truncated = (int)tile.instances.size() > slotCapacity;
+        s.boundsMin = tile.boundsMin;
+        s.boundsMax = tile.boundsMax;
+        if (s.truncated && count > 0) {
+            // Bounds nur über die behaltenen Instanzen (engeres Culling)
+            s.boundsMin = glm::vec3(1e30f);
+            s.boundsMax = glm::vec3(-1e30f);
+            for (int i = 0; i < count; i++) {
+                const GrassInstance& g = tile.instances[i];
+                glm::vec3 p(g.x, g.y, g.z);
+                float extent = GrassSystem::instanceExtent(g);
+                s.boundsMin = glm::min(s.boundsMin, p - extent);
+                s.boundsMax = glm::max(s.boundsMax, p + extent);
+            }
+        }
+        if (count > 0) {
+            size_t first = (size_t)result.slot * slotCapacity;
+            glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+            glBufferSubData(GL_ARRAY_BUFFER, first * sizeof(GrassInstance), count * sizeof(GrassInstance), tile.instances.data());
+            glBindBuffer(GL_ARRAY_BUFFER, metaVBO);
+            glBufferSubData(GL_ARRAY_BUFFER, first * sizeof(uint32_t), count * sizeof(uint32_t), tile.meta.data());
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+        }
+        s.resident = true;
+        s.residentGeneration = result.generation;
+        s.requested = false;
+        s.count = count;
+    }
+
+    rebuildChunks();
+}
+
+// Ein Terrain-Edit ändert Höhen und Grasflächen: betroffene Tiles neu erzeugen
+void GrassRing::invalidateRegion(const glm::vec2& regionMin, const glm::vec2& regionMax) {
+    for (Slot& s : slots) {
+        if (!s.assigned) continue;
+        float x0 = (float)keyX(s.key) * tileSize, z0 = (float)keyZ(s.key) * tileSize;
+        if (x0 + tileSize < regionMin.x || x0 > regionMax.x || z0 + tileSize < regionMin.y || z0 > regionMax.y) continue;
+        s.generation++;
+        s.requested = false;
+    }
+}
+
+void GrassRing::rebuildChunks() {
+    chunks.clear();
+    stats.tilesResident = 0;
+    stats.tilesTruncated = 0;
+    for (size_t slot = 0; slot < slots.size(); slot++) {
+        const Slot& s = slots[slot];
+        if (!s.resident) continue;
+        stats.tilesResident++;
+        if (s.truncated) stats.tilesTruncated++;
+        if (s.count > 0) chunks.push_back({ s.boundsMin, s.boundsMax, (int)slot * slotCapacity, s.count });
+    }
+}
+
+// --- WORKER-THREADS ---
+void GrassRing::workerLoop() {
+    while (true) {
+        Request req;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueCondition.wait(lock, [this] {
+                return stopWorkers || (!queue.empty() && (int)results.size() < MAX_READY_TILES);
+            });
+            if (stopWorkers) return;
+            req = queue.front();
+            queue.pop_front();
+            inFlight++;
+        }
+
+        Result result;
+        result.slot = req.slot;
+        result.generation = req.generation;
+        generator(keyX(req.key), keyZ(req.key), result.tile);
+
+        std::lock_guard<std::mutex> lock(queueMutex);
+        inFlight--;
+        results.push_back(std::move(result));
+    }
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include <deque>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+#include "GrassSystem.h"
+
+// Inhalt eines Gras-Tiles: Instanzen in LOD-Reihenfolge, meta wie im GrassSystem (Rang unorm16 | Ebene << 16)
+struct GrassRingTile {
+    std::vector<GrassInstance> instances;
+    std::vector<uint32_t> meta;
+    glm::vec3 boundsMin = glm::vec3(0.0f);
+    glm::vec3 boundsMax = glm::vec3(0.0f);
+};
+
+// Statistiken für die UI
+struct GrassRingStats {
+    int tilesResident = 0;
+    int tilesPending = 0;   // angefordert, im Worker oder fertig aber noch nicht hochgeladen
+    int tilesTruncated = 0; // residente Tiles mit mehr Instanzen als die Slot-Kapazität (die höchsten Ränge fehlen)
+    size_t bufferBytes = 0;
+};
+
+// Ring aus Gras-Tiles um die Kamera, toroidal adressiert: Tile (x, z) liegt immer in Slot (x mod N, z mod N),
+// N = 2 * radius + 1. Kommt ein Tile in Reichweite, übernimmt es den Slot des Tiles, das auf der anderen Seite
+// herausgefallen ist.
+// - Ein Instanz-Puffer fester Größe (N² Slots mit fester Kapazität), der Grafikspeicher hängt nicht von der Karte ab
+// - Worker-Threads erzeugen die Tiles über den TileGenerator (deterministisch aus den Tile-Koordinaten),
+//   der Haupt-Thread lädt höchstens MAX_UPLOADS_PER_FRAME Tiles pro Frame in ihren Slot hoch
+// - invalidateRegion() erzeugt Tiles nach einem Terrain-Edit neu (die alten bleiben bis zum Upload sichtbar)
+class GrassRing {
+public:
+    // Läuft in den Worker-Threads, darf also nur read-only auf geteilte Daten zugreifen
+    using TileGenerator = std::function<void(int tileX, int tileZ, GrassRingTile& out)>;
+
+    GrassRing(float tileSize, int radius, int slotCapacity, TileGenerator generator, int workerCount = 2);
+    ~GrassRing();
+
+    GrassRing(const GrassRing&) = delete;
+    GrassRing& operator=(const GrassRing&) = delete;
+
+    // 1x pro Frame: Slots der Kamera-Umgebung zuordnen, Anforderungen erneuern, fertige Tiles hochladen
+    void update(const glm::vec3& camPos);
+    void invalidateRegion(const glm::vec2& regionMin, const glm::vec2& regionMax);
+
+    // Ein Chunk pro belegtem Slot (first = Slot * Kapazität), Instanzen in instanceVBO/metaVBO
+    const std::vector<GrassChunk>& getChunks() const { return chunks; }
+    unsigned int getInstanceVBO() const { return instanceVBO; }
+    unsigned int getMetaVBO() const { return metaVBO; }
+
+    const GrassRingStats& getStats() const { return stats; }
+
+private:
+    static constexpr int MAX_UPLOADS_PER_FRAME = 4;
+    static constexpr int MAX_READY_TILES = 16;
+
+    // Tile-Schlüssel: x | z (je 32 Bit mit Vorzeichen), wie im TerrainStreamer
+    static uint64_t makeKey(int x, int z) { return ((uint64_t)(uint32_t)x << 32) | (uint32_t)z; }
+    static int keyX(uint64_t key) { return (int)(int32_t)(uint32_t)(key >> 32); }
+    static int keyZ(uint64_t key) { return (int)(int32_t)(uint32_t)(key & 0xFFFFFFFFu); }
+
+    float tileSize;
+    int radius;
+    int ringSize;     // N
+    int slotCapacity; // Instanzen pro Slot
+
+    struct Slot {
+        bool assigned = false;
+        uint64_t key = 0;              // Tile, das diesem Slot gerade zugeordnet ist
+        uint32_t generation = 0;       // erhöht bei Zuordnung und invalidateRegion, ältere Ergebnisse werden verworfen
+        bool resident = false;         // Instanzen von key liegen im Puffer
+        uint32_t residentGeneration = 0;
+        bool requested = false;        // Anforderung für die aktuelle generation läuft
+        int count = 0;
+        bool truncated = false;
+        glm::vec3 boundsMin = glm::vec3(0.0f), boundsMax = glm::vec3(0.0f);
+    };
+    std::vector<Slot> slots;
+    std::vector<GrassChunk> chunks;
+    unsigned int instanceVBO = 0, metaVBO = 0;
+    GrassRingStats stats;
+
+    int slotOf(int tileX, int tileZ) const;
+    void rebuildChunks();
+
+    // Worker-Threads
+    struct Request { uint64_t key; int slot; uint32_t generation; };
+    struct Result { int slot; uint32_t generation; GrassRingTile tile; };
+    TileGenerator generator;
+    std::vector<std::thread> workers;
+    std::mutex queueMutex;
+    std::condition_variable queueCondition;
+    bool stopWorkers = false;
+    std::deque<Request> queue;
+    std::vector<Result> results;
+    int inFlight = 0;
+
+    void request(int slot);
+    void workerLoop();
+};
@@ -1,194 +1,47 @@
 #define GLM_ENABLE_EXPERIMENTAL
 #include "GrassSystem.h"
+#include "GrassRing.h"
+#include "Parallel.h"
+#include "HashRandom.h"
 #include <stb_image.h>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtx/rotate_vector.hpp>
+#include <glm/gtc/constants.hpp>
 #include <iostream>
-#include <random>
+#include <chrono>
 #include <algorithm>
 #include <cmath>
+#include <cfloat>
+#include <cstdint>
+#include <cstddef>
 
 GrassSystem::GrassSystem() {
     // Shader laden
     shader = new Shader("../shaders/grass.vs.glsl", "../shaders/grass.fs.glsl");
-
-    // Standard Quad
-    float q[] = {
-        -0.5f,  1.0f, 0.0f,  0.0f, 0.0f,
-        -0.5f,  0.0f, 0.0f,  0.0f, 1.0f,
-         0.5f,  0.0f, 0.0f,  1.0f, 1.0f,
-        -0.5f,  1.0f, 0.0f,  0.0f, 0.0f,
-         0.5f,  0.0f, 0.0f,  1.0f, 1.0f,
-         0.5f,  1.0f, 0.0f,  1.0f, 0.0f
-    };
-    std::copy(std::begin(q), std::end(q), std::begin(quadVertices));
+    patchShader = new Shader("../shaders/grass.vs.glsl", "../shaders/grass.fs.glsl", "#define GRASS_PATCHES 1\n");
 }
 
 GrassSystem::~GrassSystem() {
+    ring.reset(); // Worker beenden, bevor grassTypes/terrain verschwinden
+    glDeleteVertexArrays(1, &ringVAO);
     delete shader;
-    for (auto& g : grassTypes) {
-        glDeleteVertexArrays(1, &g.VAO);
-        glDeleteBuffers(1, &g.VBO);
-        glDeleteBuffers(1, &g.instanceVBO);
-        glDeleteTextures(1, &g.textureID);
-    }
+    delete patchShader;
+    glDeleteVertexArrays(1, &patchVAO);
+    glDeleteTextures(1, &heightTexture);
+    glDeleteVertexArrays(1, &VAO);
+    glDeleteTextures(1, &outlineTexture);
+    glDeleteBuffers(1, &instanceVBO);
+    glDeleteBuffers(1, &metaVBO);
+    glDeleteTextures(1, &textureArray);
 }
 
-// --- GITTER AUFBAU ---
-void GrassSystem::initTerrainData(const std::vector<float>& terrainVertices,
-                                  const std::vector<unsigned int>& terrainIndices,
-                                  float terrainScale) {
-    std::cout << "Baue Acceleration Grid..." << std::endl;
-
-    grid.vertices = terrainVertices;
-    grid.indices = terrainIndices;
-
-    grid.minX = 100000.0f; grid.maxX = -100000.0f;
-    grid.minZ = 100000.0f; grid.maxZ = -100000.0f;
-
-    // Skalieren und Grenzen finden
-    for (size_t i = 0; i < grid.vertices.size(); i += 11) {
-        grid.vertices[i]   *= terrainScale;
-        grid.vertices[i+1] *= terrainScale;
-        grid.vertices[i+2] *= terrainScale;
-
-        float x = grid.vertices[i];
-        float z = grid.vertices[i+2];
-
-        if (x < grid.minX) grid.minX = x;
-        if (x > grid.maxX) grid.maxX = x;
-        if (z < grid.minZ) grid.minZ = z;
-        if (z > grid.maxZ) grid.maxZ = z;
-    }
-
-    grid.minX -= 1.0f; grid.maxX += 1.0f;
-    grid.minZ -= 1.0f; grid.maxZ += 1.0f;
-
-    grid.resolution = 200;
-    grid.cellWidth = (grid.maxX - grid.minX) / grid.resolution;
-    grid.cellDepth = (grid.maxZ - grid.minZ) / grid.resolution;
-
-    grid.cells.clear();
-    grid.cells.resize(grid.resolution * grid.resolution);
-
-    // Dreiecke einsortieren
-    for (size_t i = 0; i < grid.indices.size(); i += 3) {
-        unsigned int idx1 = grid.indices[i];
-        unsigned int idx2 = grid.indices[i+1];
-        unsigned int idx3 = grid.indices[i+2];
-
-        glm::vec3 p1(grid.vertices[idx1*11], grid.vertices[idx1*11+1], grid.vertices[idx1*11+2]);
-        glm::vec3 p2(grid.vertices[idx2*11], grid.vertices[idx2*11+1], grid.vertices[idx2*11+2]);
-        glm::vec3 p3(grid.vertices[idx3*11], grid.vertices[idx3*11+1], grid.vertices[idx3*11+2]);
-
-        float triMinX = std::min({p1.x, p2.x, p3.x});
-        float triMaxX = std::max({p1.x, p2.x, p3.x});
-        float triMinZ = std::min({p1.z, p2.z, p3.z});
-        float triMaxZ = std::max({p1.z, p2.z, p3.z});
-
-        int startX = (int)((triMinX - grid.minX) / grid.cellWidth);
-        int endX   = (int)((triMaxX - grid.minX) / grid.cellWidth);
-        int startZ = (int)((triMinZ - grid.minZ) / grid.cellDepth);
-        int endZ   = (int)((triMaxZ - grid.minZ) / grid.cellDepth);
-
-        startX = std::max(0, std::min(grid.resolution - 1, startX));
-        endX   = std::max(0, std::min(grid.resolution - 1, endX));
-        startZ = std::max(0, std::min(grid.resolution - 1, startZ));
-        endZ   = std::max(0, std::min(grid.resolution - 1, endZ));
-
-        for (int x = startX; x <= endX; x++) {
-            for (int z = startZ; z <= endZ; z++) {
-                grid.cells[z * grid.resolution + x].push_back(i);
-            }
-        }
-    }
-    grid.isBuilt = true;
-    std::cout << "Grid fertig." << std::endl;
-}
-
-// --- HÖHE FINDEN (Grid Lookup) ---
-float GrassSystem::getYFromGrid(float x, float z) {
-    if (!grid.isBuilt) return 0.0f;
-    if (x < grid.minX || x > grid.maxX || z < grid.minZ || z > grid.maxZ) return -1000.0f;
-
-    int gridX = (int)((x - grid.minX) / grid.cellWidth);
-    int gridZ = (int)((z - grid.minZ) / grid.cellDepth);
-
-    if (gridX < 0 || gridX >= grid.resolution || gridZ < 0 || gridZ >= grid.resolution) return -1000.0f;
-
-    const auto& cellIndices = grid.cells[gridZ * grid.resolution + gridX];
-
-    for (int idxStart : cellIndices) {
-        unsigned int idx1 = grid.indices[idxStart];
-        unsigned int idx2 = grid.indices[idxStart+1];
-        unsigned int idx3 = grid.indices[idxStart+2];
-
-        glm::vec3 p1(grid.vertices[idx1*11], grid.vertices[idx1*11+1], grid.vertices[idx1*11+2]);
-        glm::vec3 p2(grid.vertices[idx2*11], grid.vertices[idx2*11+1], grid.vertices[idx2*11+2]);
-        glm::vec3 p3(grid.vertices[idx3*11], grid.vertices[idx3*11+1], grid.vertices[idx3*11+2]);
-
-        float det = (p2.z - p3.z) * (p1.x - p3.x) + (p3.x - p2.x) * (p1.z - p3.z);
-        if (std::abs(det) < 0.001f) continue;
-
-        float l1 = ((p2.z - p3.z) * (x - p3.x) + (p3.x - p2.x) * (z - p3.z)) / det;
-        float l2 = ((p3.z - p1.z) * (x - p3.x) + (p1.x - p3.x) * (z - p3.z)) / det;
-        float l3 = 1.0f - l1 - l2;
-
-        if (l1 >= 0.0f && l2 >= 0.0f && l3 >= 0.0f) {
-            return l1 * p1.y + l2 * p2.y + l3 * p3.y;
-        }
-    }
-    return -1000.0f;
-}
-
-// --- NEU: NORMALE BERECHNEN ---
-glm::vec3 GrassSystem::getNormalFromGrid(float x, float z) {
-    if (!grid.isBuilt) return glm::vec3(0.0f, 1.0f, 0.0f);
-    if (x < grid.minX || x > grid.maxX || z < grid.minZ || z > grid.maxZ)
-        return glm::vec3(0.0f, 1.0f, 0.0f);
-
-    int gridX = (int)((x - grid.minX) / grid.cellWidth);
-    int gridZ = (int)((z - grid.minZ) / grid.cellDepth);
-
-    if (gridX < 0 || gridX >= grid.resolution || gridZ < 0 || gridZ >= grid.resolution)
-        return glm::vec3(0.0f, 1.0f, 0.0f);
-
-    const auto& cellIndices = grid.cells[gridZ * grid.resolution + gridX];
-
-    for (int idxStart : cellIndices) {
-        unsigned int idx1 = grid.indices[idxStart];
-        unsigned int idx2 = grid.indices[idxStart+1];
-        unsigned int idx3 = grid.indices[idxStart+2];
-
-        glm::vec3 p1(grid.vertices[idx1*11], grid.vertices[idx1*11+1], grid.vertices[idx1*11+2]);
-        glm::vec3 p2(grid.vertices[idx2*11], grid.vertices[idx2*11+1], grid.vertices[idx2*11+2]);
-        glm::vec3 p3(grid.vertices[idx3*11], grid.vertices[idx3*11+1], grid.vertices[idx3*11+2]);
-
-        // Prüfe ob Punkt im Dreieck
-        float det = (p2.z - p3.z) * (p1.x - p3.x) + (p3.x - p2.x) * (p1.z - p3.z);
-        if (std::abs(det) < 0.001f) continue;
-
-        float l1 = ((p2.z - p3.z) * (x - p3.x) + (p3.x - p2.x) * (z - p3.z)) / det;
-        float l2 = ((p3.z - p1.z) * (x - p3.x) + (p1.x - p3.x) * (z - p3.z)) / det;
-        float l3 = 1.0f - l1 - l2;
-
-        if (l1 >= 0.0f && l2 >= 0.0f && l3 >= 0.0f) {
-            // Hole die Normalen aus den Vertex-Daten (Offset 3,4,5)
-            glm::vec3 n1(grid.vertices[idx1*11+3], grid.vertices[idx1*11+4], grid.vertices[idx1*11+5]);
-            glm::vec3 n2(grid.vertices[idx2*11+3], grid.vertices[idx2*11+4], grid.vertices[idx2*11+5]);
-            glm::vec3 n3(grid.vertices[idx3*11+3], grid.vertices[idx3*11+4], grid.vertices[idx3*11+5]);
-
-            // Interpoliere die Normale
-            glm::vec3 normal = l1 * n1 + l2 * n2 + l3 * n3;
-            return glm::normalize(normal);
-        }
-    }
-    return glm::vec3(0.0f, 1.0f, 0.0f);
+// --- TERRAIN SERVICE ---
+void GrassSystem::initTerrainData(const TerrainQuery& terrainQuery) {
+    terrain = &terrainQuery;
 }
 
 // --- NEU: PRÜFE OB GRASFLÄCHE (anhand der Y-Höhe des Terrains) ---
-bool GrassSystem::isGrassSurface(float x, float z) {
-    float y = getYFromGrid(x, z);
+bool GrassSystem::isGrassSurface(float y, const glm::vec3& normal) const {
     if (y < -500.0f) return false;
 
     // Das Terrain hat unterschiedliche Höhen für verschiedene Materialien:
@@ -197,11 +50,10 @@ bool GrassSystem::isGrassSurface(float x, float z) {
     // - Hohe Bereiche (Felsen): y > 15
 
     // Nur auf Gras spawnen (mittlere Höhe)
-    if (y < -3.0f || y > 18.0f) return false;
+    if (y < GRASS_MIN_HEIGHT || y > GRASS_MAX_HEIGHT) return false;
 
     // Prüfe Steigung - kein Gras auf zu steilen Hängen
-    glm::vec3 normal = getNormalFromGrid(x, z);
-    float slope = std::acos(glm::dot(normal, glm::vec3(0.0f, 1.0f, 0.0f)));
+    float slope = std::acos(glm::clamp(glm::dot(normal, glm::vec3(0.0f, 1.0f, 0.0f)), -1.0f, 1.0f));
 
     // Maximal 45 Grad Neigung
     if (slope > glm::radians(45.0f)) return false;
@@ -210,7 +62,7 @@ bool GrassSystem::isGrassSurface(float x, float z) {
 }
 
 // --- NEU: VERBESSERTES NOISE FÜR NATÜRLICHERE VERTEILUNG ---
-float GrassSystem::getDetailedNoise(float x, float z) {
+float GrassSystem::getDetailedNoise(float x, float z) const {
     // Multi-Oktaven Perlin-ähnliches Noise
     float n = 0.0f;
 
@@ -232,202 +84,1091 @@ float GrassSystem::getDetailedNoise(float x, float z) {
     return n;
 }
 
-// --- VERBESSERTE GRAS-PLATZIERUNG ---
-void GrassSystem::addGrassType(const std::string& texturePath, int amount, float spreadRadius, float scale, bool isLeaf) {
-    if (!grid.isBuilt) return;
+// --- ORIENTIERUNG ---
+// Oktaeder-Kodierung mit Y als Hauptachse (wie die Terrain-Normalen), Ergebnis in [-1, 1]²
+static glm::vec2 octEncode(glm::vec3 n) {
+    n /= (std::abs(n.x) + std::abs(n.y) + std::abs(n.z));
+    glm::vec2 p(n.x, n.z);
+    if (n.y < 0.0f) {
+        p = glm::vec2((1.0f - std::abs(p.y)) * (p.x >= 0.0f ? 1.0f : -1.0f),
+                      (1.0f - std::abs(p.x)) * (p.y >= 0.0f ? 1.0f : -1.0f));
+    }
+    return p;
+}
+
+static uint32_t quantizeUnorm8(float v) {
+    return (uint32_t)std::clamp((int)std::lround(v * 255.0f), 0, 255);
+}
 
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_real_distribution<float> dis(-spreadRadius, spreadRadius);
-    std::uniform_real_distribution<float> rotDis(0.0f, 360.0f);
-    std::uniform_real_distribution<float> scaleVar(0.7f, 1.3f);
-    std::uniform_real_distribution<float> prob(0.0f, 1.0f);
-    std::uniform_real_distribution<float> tilt(-5.0f, 5.0f); // Leichte zusätzliche Variation
+// Kürzeste Drehung, die Y auf up abbildet (gleiche Formel wie upRotation() im grass.vs.glsl)
+static glm::mat3 upRotation(const glm::vec3& up) {
+    float h = 1.0f / std::max(1.0f + up.y, 1e-4f);
+    return glm::mat3(glm::vec3(1.0f - up.x * up.x * h, -up.x, -up.x * up.z * h),
+                     up,
+                     glm::vec3(-up.x * up.z * h, -up.z, 1.0f - up.z * up.z * h));
+}
 
-    std::vector<glm::mat4> tempMatrices;
-    tempMatrices.reserve(amount);
+static glm::vec3 octDecode(const glm::vec2& p) {
+    glm::vec3 n(p.x, 1.0f - std::abs(p.x) - std::abs(p.y), p.y);
+    float t = std::max(-n.y, 0.0f);
+    n.x += (n.x >= 0.0f) ? -t : t;
+    n.z += (n.z >= 0.0f) ? -t : t;
+    return glm::normalize(n);
+}
 
-    int placed = 0;
-    int attempts = 0;
-    int maxAttempts = amount * 5; // Mehr Versuche für bessere Platzierung
+// Drehung um Y (wie yawRotation im grass.vs.glsl)
+static glm::mat3 yawRotation(float yaw) {
+    float c = std::cos(yaw), s = std::sin(yaw);
+    return glm::mat3(glm::vec3(c, 0.0f, -s), glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(s, 0.0f, c));
+}
 
-    while (placed < amount && attempts < maxAttempts) {
-        attempts++;
-        float x = dis(gen);
-        float z = dis(gen);
+// Y um factor * (Winkel zwischen Y und normal) zur Normale gedreht
+static glm::vec3 tiltedUp(const glm::vec3& normal, float factor) {
+    glm::vec3 side(normal.x, 0.0f, normal.z);
+    float sideLength = glm::length(side);
+    if (sideLength < 1e-6f) return glm::vec3(0.0f, 1.0f, 0.0f);
+    float angle = std::acos(glm::clamp(normal.y, -1.0f, 1.0f)) * factor;
+    return glm::vec3(0.0f, std::cos(angle), 0.0f) + side / sideLength * std::sin(angle);
+}
 
-        // 1. MATERIAL-CHECK: Nur auf Grasflächen spawnen
-        if (!isGrassSurface(x, z)) continue;
+// Rotation einer kodierten Instanz (ohne Skalierung), wie instanceTransform() im grass.vs.glsl
+static glm::mat3 decodeRotation(uint32_t packed) {
+    glm::vec2 oct((float)(packed & 255u), (float)((packed >> 8) & 255u));
+    oct = oct / 255.0f * 2.0f - 1.0f;
+    float yaw = (float)((packed >> 16) & 255u) / 255.0f * glm::two_pi<float>();
+    return upRotation(octDecode(oct)) * yawRotation(yaw);
+}
 
-        // 2. NOISE-BASED DENSITY: Natürlichere Cluster
-        float noise = getDetailedNoise(x, z);
-        float density = (noise + 1.0f) * 0.5f; // Normalisiere auf 0-1
+// --- GRAS-PLATZIERUNG ---
+// Poisson-Disk-Sampling (Bridson) pro Tile. Die Tiles laufen in vier Phasen (2x2-Färbung) parallel:
+// Tiles einer Phase liegen mindestens ein Tile auseinander, lesen also nur Punkte aus früheren Phasen.
+// Jedes Tile zieht aus einem eigenen Zufallsstrom (Seed, Typ, Tile) -> gleiches Ergebnis bei jeder Thread-Anzahl.
+glm::mat4 GrassSystem::buildInstanceMatrix(const glm::vec3& position, const glm::vec3& normal, float scale,
+                                           bool isLeaf, HashRandom& rng) const {
+    // Rotation um die (geneigte) Hochachse (zufällig)
+    float yaw = glm::radians(rng.range(0.0f, 360.0f));
+
+    glm::mat4 model;
+    if (isLeaf) {
+        // LEAFS: Flach auf den Boden legen, parallel zur Terrain-Oberfläche, entlang der Normale leicht angehoben
+        // damit sie nicht komplett im Boden versinken
+        model = glm::translate(glm::mat4(1.0f), position + normal * LEAF_LIFT);
+        model = model * glm::mat4(upRotation(normal) * yawRotation(yaw));
+
+        // Rotiere 90° um X-Achse um das Leaf flach hinzulegen, dazu leichte zufällige Rotation
+        model = glm::rotate(model, glm::radians(90.0f), glm::vec3(1.0f, 0.0f, 0.0f));
+        model = glm::rotate(model, glm::radians(rng.range(-5.0f, 5.0f) * 2.0f), glm::vec3(0.0f, 0.0f, 1.0f));
+    } else {
+        // GRAS: Aufrecht stehend, GRASS_TILT der Neigung der Terrain-Normale
+        model = glm::translate(glm::mat4(1.0f), position);
+        model = model * glm::mat4(upRotation(tiltedUp(normal, GRASS_TILT)) * yawRotation(yaw));
 
-        // Verwende Noise für Wahrscheinlichkeit (mehr Gras in "hellen" Bereichen)
-        if (prob(gen) > density * 0.8f + 0.2f) continue; // 20-100% Chance je nach Noise
+        // Füge leichte zufällige Neigung für Natürlichkeit hinzu
+        model = glm::rotate(model, glm::radians(rng.range(-5.0f, 5.0f)), glm::vec3(1.0f, 0.0f, 0.0f));
+        model = glm::rotate(model, glm::radians(rng.range(-5.0f, 5.0f)), glm::vec3(0.0f, 0.0f, 1.0f));
+    }
 
-        float y = getYFromGrid(x, z);
-        if (y < -500.0f) continue;
+    // Skalierung mit Variation
+    return glm::scale(model, glm::vec3(scale * rng.range(0.7f, 1.3f)));
+}
 
-        // 3. NORMALE-BASIERTE AUSRICHTUNG
-        glm::vec3 normal = getNormalFromGrid(x, z);
+// Anteil der Fläche, der nach Material-Check und Noise-Ausdünnung Gras trägt (gejittertes Gitter, deterministisch)
+float GrassSystem::estimateAcceptance(float spreadRadius, uint32_t seed) const {
+    const int n = 64;
+    std::vector<float> xs(n * n), zs(n * n), ys(n * n);
+    std::vector<glm::vec3> normals(n * n);
+    HashRandom rng(seed);
+    float cell = 2.0f * spreadRadius / (float)n;
+    for (int z = 0; z < n; z++) {
+        for (int x = 0; x < n; x++) {
+            xs[z * n + x] = -spreadRadius + ((float)x + rng.next()) * cell;
+            zs[z * n + x] = -spreadRadius + ((float)z + rng.next()) * cell;
+        }
+    }
+    terrain->sampleBatch(xs.data(), zs.data(), xs.size(), ys.data(), normals.data(), TerrainQueryMode::Raster);
 
-        // Erstelle Transformation
-        glm::mat4 model = glm::mat4(1.0f);
-        model = glm::translate(model, glm::vec3(x, y, z));
+    float accepted = 0.0f;
+    for (size_t i = 0; i < xs.size(); i++) {
+        if (!isGrassSurface(ys[i], normals[i])) continue;
+        float density = (getDetailedNoise(xs[i], zs[i]) + 1.0f) * 0.5f;
+        accepted += std::clamp(density * 0.8f + 0.2f, 0.0f, 1.0f);
+    }
+    return accepted / (float)xs.size();
+}
 
-        // Rotation um Y-Achse (zufällig)
-        float yRotation = rotDis(gen);
-        model = glm::rotate(model, glm::radians(yRotation), glm::vec3(0.0f, 1.0f, 0.0f));
+// Hintergrund-Gitter: Zellgröße r/sqrt(2) -> höchstens ein Punkt pro Zelle (FLT_MAX = leer)
+struct GrassSystem::PoissonGrid {
+    glm::vec2 origin;
+    float cellSize;
+    int res;
+    std::vector<glm::vec2> cells;
+
+    PoissonGrid(const glm::vec2& gridOrigin, float size, float radius)
+        : origin(gridOrigin), cellSize(radius / std::sqrt(2.0f)),
+          res((int)std::ceil(size / (radius / std::sqrt(2.0f)))), cells((size_t)res * res, glm::vec2(FLT_MAX)) {}
+};
+
+// Bridson in den Zellen [cellMin, cellMax) des Gitters. Liest Nachbarzellen bis 2 Zellen außerhalb, schreibt nur eigene.
+void GrassSystem::samplePoisson(PoissonGrid& grid, const glm::ivec2& cellMin, const glm::ivec2& cellMax, float radius,
+                                const glm::vec2& areaMax, HashRandom& rng, std::vector<glm::vec2>& points) const {
+    const float cellSize = grid.cellSize;
+    glm::vec2 tileMin = grid.origin + glm::vec2((float)cellMin.x, (float)cellMin.y) * cellSize;
+    glm::vec2 tileMax = glm::min(grid.origin + glm::vec2((float)cellMax.x, (float)cellMax.y) * cellSize, areaMax);
+
+    auto fits = [&](const glm::vec2& p) {
+        int cx = (int)((p.x - grid.origin.x) / cellSize);
+        int cz = (int)((p.y - grid.origin.y) / cellSize);
+        for (int z = std::max(cz - 2, 0); z <= std::min(cz + 2, grid.res - 1); z++) {
+            for (int x = std::max(cx - 2, 0); x <= std::min(cx + 2, grid.res - 1); x++) {
+                glm::vec2 d = grid.cells[(size_t)z * grid.res + x] - p;
+                if (glm::dot(d, d) < radius * radius) return false;
+            }
+        }
+        return true;
+    };
+    std::vector<glm::vec2> active;
+    auto insert = [&](const glm::vec2& p) {
+        int cx = std::min((int)((p.x - grid.origin.x) / cellSize), cellMax.x - 1);
+        int cz = std::min((int)((p.y - grid.origin.y) / cellSize), cellMax.y - 1);
+        grid.cells[(size_t)cz * grid.res + cx] = p;
+        points.push_back(p);
+        active.push_back(p);
+    };
+    auto insideTile = [&](const glm::vec2& p) {
+        return p.x >= tileMin.x && p.x < tileMax.x && p.y >= tileMin.y && p.y < tileMax.y;
+    };
 
-        if (isLeaf) {
-            // LEAFS: Flach auf den Boden legen, parallel zur Terrain-Oberfläche
+    // Startpunkte: jeder freie Bereich im Tile wächst von hier aus
+    for (int s = 0; s < POISSON_ATTEMPTS; s++) {
+        glm::vec2 p(rng.range(tileMin.x, tileMax.x), rng.range(tileMin.y, tileMax.y));
+        if (insideTile(p) && fits(p)) insert(p);
+
+        while (!active.empty()) {
+            size_t index = (size_t)(rng.next() * (float)active.size());
+            index = std::min(index, active.size() - 1);
+            glm::vec2 origin = active[index];
+            bool found = false;
+            for (int k = 0; k < POISSON_ATTEMPTS && !found; k++) {
+                float angle = rng.next() * glm::two_pi<float>();
+                float distance = radius * (1.0f + rng.next());
+                glm::vec2 candidate = origin + distance * glm::vec2(std::cos(angle), std::sin(angle));
+                if (insideTile(candidate) && fits(candidate)) {
+                    insert(candidate);
+                    found = true;
+                }
+            }
+            if (!found) {
+                active[index] = active.back();
+                active.pop_back();
+            }
+        }
+    }
+}
 
-            // Berechne Rotationsachse und Winkel um Leaf flach zu machen
-            glm::vec3 up = glm::vec3(0.0f, 1.0f, 0.0f);
-            glm::vec3 rotAxis = glm::cross(up, normal);
-            float rotAxisLen = glm::length(rotAxis);
+// Material-Check (gesammelt, SIMD Batch-Lookup im Raster), Noise-Ausdünnung und Ausrichtung
+void GrassSystem::finishPlacement(const std::vector<glm::vec2>& points, float scale, bool isLeaf,
+                                  HashRandom& rng, std::vector<GrassInstance>& out) const {
+    if (points.empty()) return;
+    std::vector<float> xs(points.size()), zs(points.size()), ys(points.size());
+    std::vector<glm::vec3> normals(points.size());
+    for (size_t i = 0; i < points.size(); i++) { xs[i] = points[i].x; zs[i] = points[i].y; }
+    terrain->sampleBatch(xs.data(), zs.data(), points.size(), ys.data(), normals.data(), TerrainQueryMode::Raster);
 
-            if (rotAxisLen > 0.001f) {
-                rotAxis = glm::normalize(rotAxis);
-                float angle = std::acos(glm::clamp(glm::dot(up, normal), -1.0f, 1.0f));
+    for (size_t i = 0; i < points.size(); i++) {
+        if (!isGrassSurface(ys[i], normals[i])) continue;
 
-                // Wende die volle Rotation an um parallel zum Terrain zu sein
-                model = glm::rotate(model, angle, rotAxis);
-            }
+        // Noise-Ausdünnung: mehr Gras in "hellen" Bereichen (20-100% Chance)
+        float density = (getDetailedNoise(xs[i], zs[i]) + 1.0f) * 0.5f;
+        if (rng.next() > density * 0.8f + 0.2f) continue;
 
-            // Rotiere 90° um X-Achse um das Leaf flach hinzulegen
-            model = glm::rotate(model, glm::radians(90.0f), glm::vec3(1.0f, 0.0f, 0.0f));
+        out.push_back(encodeInstance(buildInstanceMatrix(glm::vec3(xs[i], ys[i], zs[i]), normals[i], scale, isLeaf, rng)));
+    }
+}
 
-            // Leichte zufällige Rotation für Variation
-            model = glm::rotate(model, glm::radians(tilt(gen) * 2.0f), glm::vec3(0.0f, 0.0f, 1.0f));
+void GrassSystem::addGrassType(const std::string& texturePath, int amount, float spreadRadius, float scale, bool isLeaf) {
+    if (!terrain || amount <= 0) return;
+    auto start = std::chrono::high_resolution_clock::now();
 
-            // Hebe Leafs leicht an damit sie nicht komplett im Boden versinken
-            model = glm::translate(model, glm::vec3(0.0f, 0.02f, 0.0f));
+    uint32_t typeSeed = hashUint(placementSeed ^ hashUint((uint32_t)(grassTypes.size() + 1) * 0x85EBCA6Bu));
+    float acceptance = estimateAcceptance(spreadRadius, typeSeed);
+    if (acceptance <= 0.0f) {
+        std::cout << "WARNUNG: Kein Gras platziert für " << texturePath << std::endl;
+        return;
+    }
 
-        } else {
-            // GRAS: Aufrecht stehend, folgt der Terrain-Normale
-            glm::vec3 up = glm::vec3(0.0f, 1.0f, 0.0f);
+    // Mindestabstand aus der Zieldichte: ein gesättigtes Poisson-Disk-Muster hat ~POISSON_PACKING / r² Punkte pro Fläche
+    float area = 4.0f * spreadRadius * spreadRadius;
+    float targetPoints = (float)amount / acceptance;
+    float radius = std::max(std::sqrt(POISSON_PACKING * area / targetPoints), 0.01f);
+
+    GrassType type;
+    type.amount = amount;
+    type.density = (float)amount / area;
+    type.radius = radius;
+    type.scale = scale;
+    type.isLeaf = isLeaf;
+
+    // Ring-Modus: platziert wird erst, wenn die Tiles um die Kamera angefordert werden
+    if (ringRadius > 0) {
+        type.layer = addLayer(texturePath);
+        if (type.layer < 0) return;
+        ring.reset(); // Worker lesen grassTypes, der Ring wird mit dem neuen Typ neu angelegt
+        grassTypes.push_back(type);
+        std::cout << "Gras (Ring): " << type.density << " pro m², Abstand " << radius << " - " << texturePath << std::endl;
+        return;
+    }
 
-            // Berechne Rotationsachse und Winkel
-            glm::vec3 rotAxis = glm::cross(up, normal);
-            float rotAxisLen = glm::length(rotAxis);
+    PoissonGrid grid(glm::vec2(-spreadRadius), 2.0f * spreadRadius, radius);
+    int tileCells = std::max(4, (int)std::ceil(PLACEMENT_TILE / grid.cellSize));
+    int tileRes = (grid.res + tileCells - 1) / tileCells;
 
-            if (rotAxisLen > 0.001f) {
-                rotAxis = glm::normalize(rotAxis);
-                float angle = std::acos(glm::clamp(glm::dot(up, normal), -1.0f, 1.0f));
+    std::vector<std::vector<GrassInstance>> tileInstances((size_t)tileRes * tileRes);
+    std::vector<int> tileCandidates((size_t)tileRes * tileRes, 0);
 
-                // Wende die Rotation an (aber nicht zu extrem - 80% der vollen Neigung)
-                model = glm::rotate(model, angle * 0.8f, rotAxis);
-            }
+    auto placeTile = [&](int tile) {
+        int tx = tile % tileRes, tz = tile / tileRes;
+        glm::ivec2 cellMin(tx * tileCells, tz * tileCells);
+        glm::ivec2 cellMax(std::min(cellMin.x + tileCells, grid.res), std::min(cellMin.y + tileCells, grid.res));
+        HashRandom rng(typeSeed ^ hashUint((uint32_t)tile * 0x27D4EB2Du + 1u));
 
-            // Füge leichte zufällige Neigung für Natürlichkeit hinzu
-            model = glm::rotate(model, glm::radians(tilt(gen)), glm::vec3(1.0f, 0.0f, 0.0f));
-            model = glm::rotate(model, glm::radians(tilt(gen)), glm::vec3(0.0f, 0.0f, 1.0f));
-        }
+        std::vector<glm::vec2> points;
+        samplePoisson(grid, cellMin, cellMax, radius, glm::vec2(spreadRadius), rng, points);
+        tileCandidates[tile] = (int)points.size();
+        finishPlacement(points, scale, isLeaf, rng, tileInstances[tile]);
+    };
 
-        // Skalierung mit Variation
-        float finalScale = scale * scaleVar(gen);
-        model = glm::scale(model, glm::vec3(finalScale));
+    for (int phase = 0; phase < 4; phase++) {
+        std::vector<int> phaseTiles;
+        for (int tz = (phase >> 1); tz < tileRes; tz += 2)
+            for (int tx = (phase & 1); tx < tileRes; tx += 2)
+                phaseTiles.push_back(tz * tileRes + tx);
+        parallelFor(0, (int)phaseTiles.size(), [&](int i) { placeTile(phaseTiles[i]); });
+    }
 
-        tempMatrices.push_back(model);
-        placed++;
+    // Tiles in fester Reihenfolge zusammenfügen
+    std::vector<GrassInstance> instances;
+    int candidates = 0;
+    size_t total = 0;
+    for (const auto& t : tileInstances) total += t.size();
+    instances.reserve(total);
+    for (size_t t = 0; t < tileInstances.size(); t++) {
+        instances.insert(instances.end(), tileInstances[t].begin(), tileInstances[t].end());
+        candidates += tileCandidates[t];
     }
+    int placed = (int)instances.size();
 
     if (placed == 0) {
         std::cout << "WARNUNG: Kein Gras platziert für " << texturePath << std::endl;
         return;
     }
 
-    unsigned int texID = loadTexture(texturePath.c_str());
-    GrassType newType(texID, placed);
-    newType.modelMatrices = tempMatrices;
+    type.layer = addLayer(texturePath);
+    if (type.layer < 0) return;
+    type.amount = placed;
+    grassTypes.push_back(type);
+    pendingInstances.insert(pendingInstances.end(), instances.begin(), instances.end());
+    pendingLayers.insert(pendingLayers.end(), instances.size(), (uint8_t)type.layer);
 
-    setupBuffers(newType);
-    grassTypes.push_back(newType);
-
-    float successRate = (float)placed / (float)attempts * 100.0f;
+    float ms = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    float successRate = (float)placed / (float)std::max(candidates, 1) * 100.0f;
     std::cout << "Gras platziert: " << placed << "/" << amount
-              << " (" << successRate << "% Erfolgsrate) - " << texturePath << std::endl;
+              << " (Abstand " << radius << ", " << successRate << "% Erfolgsrate, " << ms << " ms) - " << texturePath << std::endl;
 }
 
-void GrassSystem::setupBuffers(GrassType& grass) {
-    if (grass.modelMatrices.empty()) return;
+// --- CHUNK-BINNING ---
+// Bit-Umkehr der unteren 16 Bit
+static uint32_t reverseBits16(uint32_t v) {
+    v = ((v & 0x5555) << 1) | ((v >> 1) & 0x5555);
+    v = ((v & 0x3333) << 2) | ((v >> 2) & 0x3333);
+    v = ((v & 0x0F0F) << 4) | ((v >> 4) & 0x0F0F);
+    v = ((v & 0x00FF) << 8) | ((v >> 8) & 0x00FF);
+    return v & 0xFFFF;
+}
 
-    glGenVertexArrays(1, &grass.VAO);
-    glGenBuffers(1, &grass.VBO);
-    glGenBuffers(1, &grass.instanceVBO);
+// 16 Bit pro Achse -> 32-Bit Morton-Code
+static uint32_t spreadBits16(uint32_t v) {
+    v &= 0xFFFF;
+    v = (v | (v << 8)) & 0x00FF00FF;
+    v = (v | (v << 4)) & 0x0F0F0F0F;
+    v = (v | (v << 2)) & 0x33333333;
+    v = (v | (v << 1)) & 0x55555555;
+    return v;
+}
 
-    glBindVertexArray(grass.VAO);
+// Sortiert die Instanzen nach einem Morton-Code über ein feines Zell-Gitter. Die oberen Bits des Codes
+// sind die Chunk-Koordinaten, also liegen die Instanzen eines Chunks danach am Stück (und die Chunks selbst
+// in Morton-Reihenfolge, benachbarte sichtbare Chunks ergeben oft einen zusammenhängenden Bereich).
+// Im Chunk wird nach dem bit-umgekehrten lokalen Code sortiert: jedes Präfix ist dann gleichmäßig über den
+// Chunk verteilt (erst ein Halm pro Quadrant, dann pro Unter-Quadrant, ...) und dient als stabiler LOD-Rang.
+// Die Typen werden dabei gemischt, jeder Typ dünnt also im gleichen Verhältnis aus.
+void GrassSystem::buildChunks(std::vector<GrassInstance>& instances, std::vector<uint8_t>& layers,
+                              const glm::vec2& areaMin, std::vector<GrassChunk>& chunks) const {
+    chunks.clear();
+    if (instances.empty()) return;
+
+    const float cellSize = CHUNK_SIZE / (float)(1 << MORTON_CHUNK_BITS);
+    std::vector<uint64_t> keys(instances.size());
+    for (size_t i = 0; i < instances.size(); i++) {
+        uint32_t gx = (uint32_t)std::clamp((int)((instances[i].x - areaMin.x) / cellSize), 0, 0xFFFF);
+        uint32_t gz = (uint32_t)std::clamp((int)((instances[i].z - areaMin.y) / cellSize), 0, 0xFFFF);
+        uint32_t morton = spreadBits16(gx) | (spreadBits16(gz) << 1);
+        uint32_t local = morton & ((1u << (2 * MORTON_CHUNK_BITS)) - 1);
+        uint32_t rankOrder = reverseBits16(local << (16 - 2 * MORTON_CHUNK_BITS));
+        keys[i] = ((uint64_t)((morton - local) | rankOrder) << 32) | (uint32_t)i;
+    }
+    std::sort(keys.begin(), keys.end());
+
+    std::vector<GrassInstance> sorted(instances.size());
+    std::vector<uint8_t> sortedLayers(layers.size());
+    const int chunkShift = 32 + 2 * MORTON_CHUNK_BITS;
+    for (size_t i = 0; i < keys.size(); i++) {
+        const GrassInstance& g = instances[keys[i] & 0xFFFFFFFFu];
+        sorted[i] = g;
+        sortedLayers[i] = layers[keys[i] & 0xFFFFFFFFu];
+
+        glm::vec3 p(g.x, g.y, g.z);
+        float extent = instanceExtent(g);
+        if (i == 0 || (keys[i] >> chunkShift) != (keys[i - 1] >> chunkShift)) {
+            chunks.push_back({ p - extent, p + extent, (int)i, 0 });
+        }
+        GrassChunk& chunk = chunks.back();
+        chunk.boundsMin = glm::min(chunk.boundsMin, p - extent);
+        chunk.boundsMax = glm::max(chunk.boundsMax, p + extent);
+        chunk.count++;
+    }
+    instances.swap(sorted);
+    layers.swap(sortedLayers);
+}
+
+// --- KOMPAKTE INSTANZEN ---
+// Jede Rotation R zerlegt sich exakt in upRotation(R * Y) * Ry(yaw)
+GrassInstance GrassSystem::encodeInstance(const glm::mat4& model) {
+    GrassInstance g;
+    g.x = model[3].x; g.y = model[3].y; g.z = model[3].z;
+
+    float scale = glm::length(glm::vec3(model[0]));
+    glm::vec3 up = glm::normalize(glm::vec3(model[1]));
+    glm::vec3 facing = glm::transpose(upRotation(up)) * glm::normalize(glm::vec3(model[0])); // = (cos yaw, 0, -sin yaw)
+    float yaw = std::atan2(-facing.z, facing.x);
+    if (yaw < 0.0f) yaw += glm::two_pi<float>();
+
+    glm::vec2 oct = octEncode(up) * 0.5f + 0.5f;
+    g.packed = quantizeUnorm8(oct.x) | (quantizeUnorm8(oct.y) << 8) |
+               (quantizeUnorm8(yaw / glm::two_pi<float>()) << 16) |
+               (quantizeUnorm8(scale / MAX_SCALE) << 24);
+    return g;
+}
 
-    glBindBuffer(GL_ARRAY_BUFFER, grass.VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), quadVertices, GL_STATIC_DRAW);
+// Karte reicht vom Fußpunkt etwa 1.12 * Skalierung weit (Quad 1 x 1), dazu der Wind-Ausschlag
+float GrassSystem::instanceExtent(const GrassInstance& g) {
+    return 1.25f * (float)(g.packed >> 24) / 255.0f * MAX_SCALE;
+}
+
+// --- PROZEDURALE PATCHES ---
+void GrassSystem::addPatchGrassType(const std::string& texturePath, int cardsPerPatch, float patchSpacing, float radius, float scale) {
+    if (!terrain) return;
+    if (heightTexture == 0) createHeightTexture();
+    if (patchVAO == 0) glGenVertexArrays(1, &patchVAO);
+
+    GrassPatchType type;
+    type.layer = addLayer(texturePath);
+    if (type.layer < 0) return;
+    type.cardsPerPatch = std::max(cardsPerPatch, 1);
+    type.patchSpacing = std::max(patchSpacing, 0.05f);
+    type.radius = radius;
+    type.scale = scale;
+    type.seed = 0x9E3779B9u * (uint32_t)(patchTypes.size() + 1);
+    patchTypes.push_back(type);
+
+    int patchesAcross = (int)(2.0f * radius / type.patchSpacing);
+    std::cout << "Gras-Patches: bis zu " << patchesAcross * patchesAcross * type.cardsPerPatch
+              << " Karten ohne Instanz-Daten - " << texturePath << std::endl;
+}
 
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
+// Texel ohne Terrain bleiben NO_HEIGHT (liegt unter GRASS_MIN_HEIGHT -> kein Gras)
+void GrassSystem::createHeightTexture() {
+    int res = terrain->getRasterResolution();
+    const std::vector<float>& heights = terrain->getRasterHeights();
+    if (res < 2 || heights.size() != (size_t)res * res) return;
+
+    glGenTextures(1, &heightTexture);
+    glBindTexture(GL_TEXTURE_2D, heightTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R32F, res, res, 0, GL_RED, GL_FLOAT, heights.data());
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
 
-    glBindBuffer(GL_ARRAY_BUFFER, grass.instanceVBO);
-    glBufferData(GL_ARRAY_BUFFER, grass.amount * sizeof(glm::mat4), &grass.modelMatrices[0], GL_STATIC_DRAW);
+void GrassSystem::updateHeightTexture(const glm::vec2& regionMin, const glm::vec2& regionMax) {
+    if (heightTexture == 0) return;
+    int res = terrain->getRasterResolution();
+    float stepX = (terrain->getMaxX() - terrain->getMinX()) / (float)(res - 1);
+    float stepZ = (terrain->getMaxZ() - terrain->getMinZ()) / (float)(res - 1);
+    int x0 = std::clamp((int)std::floor((regionMin.x - terrain->getMinX()) / stepX) - 1, 0, res - 1);
+    int x1 = std::clamp((int)std::ceil ((regionMax.x - terrain->getMinX()) / stepX) + 1, 0, res - 1);
+    int z0 = std::clamp((int)std::floor((regionMin.y - terrain->getMinZ()) / stepZ) - 1, 0, res - 1);
+    int z1 = std::clamp((int)std::ceil ((regionMax.y - terrain->getMinZ()) / stepZ) + 1, 0, res - 1);
+
+    glBindTexture(GL_TEXTURE_2D, heightTexture);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, res);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, x0, z0, x1 - x0 + 1, z1 - z0 + 1, GL_RED, GL_FLOAT,
+                    &terrain->getRasterHeights()[(size_t)z0 * res + x0]);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
 
-    std::size_t vec4Size = sizeof(glm::vec4);
-    for (int i = 0; i < 4; i++) {
-        glEnableVertexAttribArray(3 + i);
-        glVertexAttribPointer(3 + i, 4, GL_FLOAT, GL_FALSE, 4 * vec4Size, (void*)(i * vec4Size));
-        glVertexAttribDivisor(3 + i, 1);
+// Blöcke im Quadrat um die Kamera (auf das Terrain begrenzt). Pro Block wird nur das Karten-Präfix gezeichnet,
+// das die LOD-Dichte am nächsten Punkt braucht; Karten sind nach Rang sortiert (Rang = Karte / cardsPerPatch).
+void GrassSystem::drawPatches(const Frustum& frustum, const glm::vec3& camPos) {
+    if (patchTypes.empty() || heightTexture == 0) return;
+    Shader& s = *patchShader;
+    s.setInt("patchHeightMap", HEIGHT_TEXTURE_UNIT);
+    s.setVec2("patchHeightMin", glm::vec2(terrain->getMinX(), terrain->getMinZ()));
+    s.setVec2("patchHeightSize", glm::vec2(terrain->getMaxX() - terrain->getMinX(), terrain->getMaxZ() - terrain->getMinZ()));
+    s.setVec2("grassHeightRange", glm::vec2(GRASS_MIN_HEIGHT, GRASS_MAX_HEIGHT));
+    s.setInt("patchBlockSize", PATCH_BLOCK);
+    glActiveTexture(GL_TEXTURE0 + HEIGHT_TEXTURE_UNIT);
+    glBindTexture(GL_TEXTURE_2D, heightTexture);
+    glActiveTexture(GL_TEXTURE0);
+    glBindVertexArray(patchVAO);
+
+    for (const GrassPatchType& type : patchTypes) {
+        float reach = std::min(type.radius, lodMaxDistance);
+        float blockSize = type.patchSpacing * PATCH_BLOCK;
+        float extent = 1.25f * 1.3f * type.scale; // größte Karte inkl. Wind
+        int bx0 = (int)std::floor(std::max(camPos.x - reach, terrain->getMinX()) / blockSize);
+        int bx1 = (int)std::floor(std::min(camPos.x + reach, terrain->getMaxX()) / blockSize);
+        int bz0 = (int)std::floor(std::max(camPos.z - reach, terrain->getMinZ()) / blockSize);
+        int bz1 = (int)std::floor(std::min(camPos.z + reach, terrain->getMaxZ()) / blockSize);
+
+        bool bound = false;
+        for (int bz = bz0; bz <= bz1; bz++) {
+            for (int bx = bx0; bx <= bx1; bx++) {
+                glm::vec3 bMin((float)bx * blockSize - extent, GRASS_MIN_HEIGHT - extent, (float)bz * blockSize - extent);
+                glm::vec3 bMax((float)(bx + 1) * blockSize + extent, GRASS_MAX_HEIGHT + extent, (float)(bz + 1) * blockSize + extent);
+                float distance = glm::length(glm::clamp(camPos, bMin, bMax) - camPos);
+                if (distance > reach) continue;
+                int cards = std::min(type.cardsPerPatch, (int)std::ceil(lodDensity(distance) * (float)type.cardsPerPatch));
+                if (cards <= 0 || !frustum.isBoxVisible(bMin, bMax)) continue;
+
+                if (!bound) {
+                    s.setInt("patchLayer", type.layer);
+                    s.setInt("cardsPerPatch", type.cardsPerPatch);
+                    s.setFloat("patchSpacing", type.patchSpacing);
+                    s.setFloat("patchScale", type.scale);
+                    s.setFloat("patchRadius", type.radius);
+                    s.setInt("patchSeed", (int)type.seed);
+                    bound = true;
+                }
+                s.setVec2("patchBlockOrigin", glm::vec2((float)(bx * PATCH_BLOCK), (float)(bz * PATCH_BLOCK)));
+                glDrawArraysInstanced(GL_TRIANGLES, 0, CARD_VERTICES * cards, PATCH_BLOCK * PATCH_BLOCK);
+                stats.patchCardsDrawn += cards * PATCH_BLOCK * PATCH_BLOCK;
+                stats.drawCalls++;
+            }
+        }
     }
     glBindVertexArray(0);
 }
 
+// --- EDITOR: RE-SNAP ---
+// Fußpunkt auf die neue Höhe setzen und die Ausrichtung wie bei der Platzierung aus der neuen Normale ableiten.
+// Gras: Hochachse = GRASS_TILT der Neigung (+ zufällige Neigung aus der Position, bleibt bei jedem Re-Snap gleich),
+// Yaw und Skalierung bleiben. Leafs: um die Drehung alte -> neue Normale mitgedreht, LEAF_LIFT neu angewendet.
+// Betroffene Chunks werden vom GPU-Puffer gelesen und wieder hochgeladen.
+void GrassSystem::resnapRegion(const glm::vec2& regionMin, const glm::vec2& regionMax) {
+    if (!terrain) return;
+    updateHeightTexture(regionMin, regionMax);
+    if (ring) ring->invalidateRegion(regionMin, regionMax);
+    flushPendingInstances();
+    if (instanceVBO == 0) return;
+
+    std::vector<bool> leafLayer(MAX_LAYERS, false);
+    for (const GrassType& type : grassTypes) leafLayer[type.layer] = type.isLeaf;
+
+    std::vector<GrassInstance> instances;
+    std::vector<uint32_t> meta;
+    std::vector<int> hits;
+    std::vector<float> xs, zs, ys;
+    std::vector<glm::vec3> oldNormals, normals; // oldNormals nur für Leafs (aus der Rotation rekonstruiert)
+    for (GrassChunk& chunk : chunks) {
+        if (chunk.boundsMax.x < regionMin.x || chunk.boundsMin.x > regionMax.x ||
+            chunk.boundsMax.z < regionMin.y || chunk.boundsMin.z > regionMax.y) continue;
+
+        instances.resize(chunk.count);
+        meta.resize(chunk.count);
+        glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+        glGetBufferSubData(GL_ARRAY_BUFFER, chunk.first * sizeof(GrassInstance), chunk.count * sizeof(GrassInstance), instances.data());
+        glBindBuffer(GL_ARRAY_BUFFER, metaVBO);
+        glGetBufferSubData(GL_ARRAY_BUFFER, chunk.first * sizeof(uint32_t), chunk.count * sizeof(uint32_t), meta.data());
+
+        hits.clear(); xs.clear(); zs.clear(); oldNormals.clear();
+        for (int i = 0; i < chunk.count; i++) {
+            const GrassInstance& g = instances[i];
+            if (g.x < regionMin.x || g.x > regionMax.x || g.z < regionMin.y || g.z > regionMax.y) continue;
+            glm::vec3 foot(g.x, g.y, g.z);
+            glm::vec3 oldNormal(0.0f, 1.0f, 0.0f);
+            if (leafLayer[meta[i] >> 16]) {
+                // Flach gelegt: die Karten-Z-Achse zeigt entgegen der Normale
+                oldNormal = -(decodeRotation(g.packed) * glm::vec3(0.0f, 0.0f, 1.0f));
+                foot -= oldNormal * LEAF_LIFT;
+            }
+            hits.push_back(i);
+            xs.push_back(foot.x);
+            zs.push_back(foot.z);
+            oldNormals.push_back(oldNormal);
+        }
+        if (hits.empty()) continue;
+
+        ys.resize(hits.size());
+        normals.resize(hits.size());
+        terrain->sampleBatch(xs.data(), zs.data(), hits.size(), ys.data(), normals.data(), TerrainQueryMode::Raster);
+
+        int lo = chunk.count, hi = -1;
+        for (size_t h = 0; h < hits.size(); h++) {
+            if (ys[h] <= TerrainQuery::NO_HEIGHT) continue;
+            GrassInstance& g = instances[hits[h]];
+            const glm::vec3& normal = normals[h];
+            if (leafLayer[meta[hits[h]] >> 16]) {
+                glm::mat3 rotation = upRotation(normal) * glm::transpose(upRotation(oldNormals[h])) * decodeRotation(g.packed);
+                glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(xs[h], ys[h], zs[h]) + normal * LEAF_LIFT);
+                GrassInstance snapped = encodeInstance(model * glm::mat4(rotation));
+                g.x = snapped.x; g.y = snapped.y; g.z = snapped.z;
+                g.packed = (snapped.packed & 0x00FFFFFFu) | (g.packed & 0xFF000000u);
+            } else {
+                // Zufällige Neigung wie bei der Platzierung, aber aus der Position (gleiches Ergebnis bei jedem Re-Snap)
+                HashRandom rng(hashUint((uint32_t)std::lround(g.x * 1024.0f)) ^ hashUint((uint32_t)std::lround(g.z * 1024.0f) * 0x27D4EB2Du));
+                glm::mat3 jitter = glm::mat3(glm::rotate(glm::mat4(1.0f), glm::radians(rng.range(-5.0f, 5.0f)), glm::vec3(1.0f, 0.0f, 0.0f)) *
+                                             glm::rotate(glm::mat4(1.0f), glm::radians(rng.range(-5.0f, 5.0f)), glm::vec3(0.0f, 0.0f, 1.0f)));
+                glm::vec3 up = upRotation(tiltedUp(normal, GRASS_TILT)) * jitter * glm::vec3(0.0f, 1.0f, 0.0f);
+                // Yaw bezieht sich auf upRotation(up) und bleibt damit unverändert
+                glm::vec2 oct = octEncode(up) * 0.5f + 0.5f;
+                g.y = ys[h];
+                g.packed = quantizeUnorm8(oct.x) | (quantizeUnorm8(oct.y) << 8) | (g.packed & 0xFFFF0000u);
+            }
+            float extent = instanceExtent(g);
+            chunk.boundsMin = glm::min(chunk.boundsMin, glm::vec3(g.x, g.y, g.z) - extent);
+            chunk.boundsMax = glm::max(chunk.boundsMax, glm::vec3(g.x, g.y, g.z) + extent);
+            lo = std::min(lo, hits[h]);
+            hi = std::max(hi, hits[h]);
+        }
+        if (hi < lo) continue;
+        glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+        glBufferSubData(GL_ARRAY_BUFFER, (chunk.first + lo) * sizeof(GrassInstance), (hi - lo + 1) * sizeof(GrassInstance), &instances[lo]);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+// --- INSTANZ-PUFFER ---
+// Neue Instanzen werden mit den vorhandenen (vom GPU-Puffer zurückgelesen) neu einsortiert.
+// Beim Start passiert das genau einmal, nachdem alle Typen hinzugefügt sind.
+void GrassSystem::flushPendingInstances() {
+    if (textureArrayLayers != (int)layerPaths.size()) buildTextureArray();
+    if (pendingInstances.empty()) return;
+
+    std::vector<GrassInstance> instances(instanceCount);
+    std::vector<uint8_t> layers(instanceCount);
+    if (instanceCount > 0) {
+        std::vector<uint32_t> meta(instanceCount);
+        glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+        glGetBufferSubData(GL_ARRAY_BUFFER, 0, instances.size() * sizeof(GrassInstance), instances.data());
+        glBindBuffer(GL_ARRAY_BUFFER, metaVBO);
+        glGetBufferSubData(GL_ARRAY_BUFFER, 0, meta.size() * sizeof(uint32_t), meta.data());
+        for (size_t i = 0; i < meta.size(); i++) layers[i] = (uint8_t)(meta[i] >> 16);
+    }
+    instances.insert(instances.end(), pendingInstances.begin(), pendingInstances.end());
+    layers.insert(layers.end(), pendingLayers.begin(), pendingLayers.end());
+    std::vector<GrassInstance>().swap(pendingInstances);
+    std::vector<uint8_t>().swap(pendingLayers);
+
+    glm::vec2 areaMin(FLT_MAX);
+    for (const auto& g : instances) areaMin = glm::min(areaMin, glm::vec2(g.x, g.z));
+    buildChunks(instances, layers, areaMin, chunks);
+    instanceCount = (int)instances.size();
+
+    // LOD-Rang = Position im Chunk (die Instanzen sind dort schon nach Rang sortiert)
+    std::vector<uint32_t> meta(instances.size());
+    for (const GrassChunk& chunk : chunks) {
+        for (int i = 0; i < chunk.count; i++) {
+            uint32_t rank = (uint32_t)std::lround(((float)i + 0.5f) / (float)chunk.count * 65535.0f);
+            meta[chunk.first + i] = rank | ((uint32_t)layers[chunk.first + i] << 16);
+        }
+    }
+
+    if (VAO == 0) {
+        glGenVertexArrays(1, &VAO);
+        glGenBuffers(1, &instanceVBO);
+        glGenBuffers(1, &metaVBO);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, instances.size() * sizeof(GrassInstance), instances.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, metaVBO);
+    glBufferData(GL_ARRAY_BUFFER, meta.size() * sizeof(uint32_t), meta.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    std::cout << "Gras: " << instanceCount << " Instanzen aus " << grassTypes.size() << " Typen in "
+              << chunks.size() << " Chunks" << std::endl;
+}
+
+// Erwartet das VAO gebunden, lässt GL_ARRAY_BUFFER auf metaVBO
+void GrassSystem::bindInstanceAttributes(unsigned int instanceVBO, unsigned int metaVBO, size_t firstInstance) const {
+    std::size_t base = firstInstance * sizeof(GrassInstance);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    glEnableVertexAttribArray(3);
+    glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(GrassInstance), (void*)(base + offsetof(GrassInstance, x)));
+    glVertexAttribDivisor(3, 1);
+    glEnableVertexAttribArray(4);
+    glVertexAttribIPointer(4, 1, GL_UNSIGNED_INT, sizeof(GrassInstance), (void*)(base + offsetof(GrassInstance, packed)));
+    glVertexAttribDivisor(4, 1);
+
+    glBindBuffer(GL_ARRAY_BUFFER, metaVBO);
+    glEnableVertexAttribArray(7);
+    glVertexAttribIPointer(7, 1, GL_UNSIGNED_INT, sizeof(uint32_t), (void*)(firstInstance * sizeof(uint32_t)));
+    glVertexAttribDivisor(7, 1);
+}
+
+// --- EXTERNE BATCHES ---
+// Rang 0 (nur die Maximal-Distanz blendet aus), Textur-Ebene aus dem Typ
+void GrassSystem::uploadBatch(GrassBatch& batch, const std::vector<GrassInstance>& instances, const std::vector<int>& typeOffsets) const {
+    // Typen ohne registrierten Gras-Typ (z.B. Tile-Datei mit mehr Typen) fallen weg, sie liegen sortiert am Ende
+    size_t knownTypes = std::min(typeOffsets.size(), grassTypes.size() + 1);
+    batch.typeOffsets.assign(typeOffsets.begin(), typeOffsets.begin() + knownTypes);
+    size_t count = knownTypes > 0 ? (size_t)std::clamp(typeOffsets[knownTypes - 1], 0, (int)instances.size()) : 0;
+    if (count < instances.size() && !warnedUnknownBatchType) {
+        std::cout << "WARNUNG: Gras-Batch mit " << instances.size() - count << " Instanzen unbekannter Typen (nur "
+                  << grassTypes.size() << " Typen registriert), werden übersprungen" << std::endl;
+        warnedUnknownBatchType = true;
+    }
+    if (count == 0) return;
+
+    batch.boundsMin = glm::vec3(1e30f);
+    batch.boundsMax = glm::vec3(-1e30f);
+    for (size_t i = 0; i < count; i++) {
+        const GrassInstance& g = instances[i];
+        glm::vec3 p(g.x, g.y, g.z);
+        float extent = instanceExtent(g);
+        batch.boundsMin = glm::min(batch.boundsMin, p - extent);
+        batch.boundsMax = glm::max(batch.boundsMax, p + extent);
+    }
+
+    std::vector<uint32_t> meta(count, 0);
+    for (size_t t = 0; t + 1 < knownTypes; t++) {
+        uint32_t layer = (uint32_t)grassTypes[t].layer << 16;
+        int end = std::min(typeOffsets[t + 1], (int)count);
+        for (int i = std::max(typeOffsets[t], 0); i < end; i++) meta[i] = layer;
+    }
+
+    bool created = batch.VAO == 0;
+    if (created) {
+        glGenVertexArrays(1, &batch.VAO);
+        glGenBuffers(1, &batch.instanceVBO);
+        glGenBuffers(1, &batch.metaVBO);
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, batch.instanceVBO);
+    if (count > batch.capacity) {
+        glBufferData(GL_ARRAY_BUFFER, count * sizeof(GrassInstance), instances.data(), GL_STATIC_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, batch.metaVBO);
+        glBufferData(GL_ARRAY_BUFFER, meta.size() * sizeof(uint32_t), meta.data(), GL_STATIC_DRAW);
+        batch.capacity = count;
+    } else {
+        glBufferSubData(GL_ARRAY_BUFFER, 0, count * sizeof(GrassInstance), instances.data());
+        glBindBuffer(GL_ARRAY_BUFFER, batch.metaVBO);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, meta.size() * sizeof(uint32_t), meta.data());
+    }
+
+    // Die Puffer-Namen bleiben gleich, die Attribute müssen nur einmal gesetzt werden
+    if (created) {
+        glBindVertexArray(batch.VAO);
+        bindInstanceAttributes(batch.instanceVBO, batch.metaVBO, 0);
+        glBindVertexArray(0);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void GrassSystem::destroyBatch(GrassBatch& batch) {
+    glDeleteVertexArrays(1, &batch.VAO);
+    glDeleteBuffers(1, &batch.instanceVBO);
+    glDeleteBuffers(1, &batch.metaVBO);
+    batch = GrassBatch();
+}
+
+void GrassSystem::applyUniforms(Shader& target, const glm::mat4& view, const glm::mat4& projection, float time,
+                                const glm::vec3& camPos, const glm::vec3& lightPos, const glm::vec3& lightColor) {
+    target.use();
+    target.setMat4("view", view);
+    target.setMat4("projection", projection);
+    target.setFloat("time", time);
+
+    target.setVec3("viewPos", camPos);
+    target.setVec3("lightPos", lightPos);
+    target.setVec3("lightColor", lightColor);
+
+    target.setInt("texture_diffuse1", 0);
+    target.setInt("cardOutlines", OUTLINE_TEXTURE_UNIT);
+    target.setFloat("lodFullDistance", lodFullDistance);
+    target.setFloat("lodMaxDistance", lodMaxDistance);
+
+    glActiveTexture(GL_TEXTURE0 + OUTLINE_TEXTURE_UNIT);
+    glBindTexture(GL_TEXTURE_2D, outlineTexture);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, textureArray);
+}
+
+// --- DISTANZ-LOD ---
+void GrassSystem::setLodDistances(float fullDensityDistance, float maxDistance) {
+    lodMaxDistance = std::max(maxDistance, 1.0f);
+    lodFullDistance = std::clamp(fullDensityDistance, 0.1f, lodMaxDistance);
+}
+
+float GrassSystem::lodDensity(float distance) const {
+    if (distance >= lodMaxDistance) return 0.0f;
+    float density = distance <= lodFullDistance ? 1.0f : (lodFullDistance * lodFullDistance) / (distance * distance);
+    float t = std::clamp((distance - 0.8f * lodMaxDistance) / (0.2f * lodMaxDistance), 0.0f, 1.0f);
+    return density * (1.0f - t * t * (3.0f - 2.0f * t));
+}
+
 void GrassSystem::draw(const glm::mat4& view, const glm::mat4& projection, float time,
                        const glm::vec3& camPos, const glm::vec3& lightPos, const glm::vec3& lightColor) {
-    shader->use();
-    shader->setMat4("view", view);
-    shader->setMat4("projection", projection);
-    shader->setFloat("time", time);
+    flushPendingInstances();
+    applyUniforms(*shader, view, projection, time, camPos, lightPos, lightColor);
+    glDisable(GL_CULL_FACE);
 
-    shader->setVec3("viewPos", camPos);
-    shader->setVec3("lightPos", lightPos);
-    shader->setVec3("lightColor", lightColor);
+    Frustum frustum(projection * view);
+    stats = GrassStats();
+    stats.chunksTotal = (int)chunks.size();
+    stats.instancesTotal = instanceCount;
+
+    drawChunks(chunks, VAO, instanceVBO, metaVBO, frustum, camPos);
+
+    if (ringRadius > 0 && !grassTypes.empty()) {
+        if (!ring) createRing();
+        ring->update(camPos);
+        const GrassRingStats& ringStats = ring->getStats();
+        stats.chunksTotal += (int)ring->getChunks().size();
+        stats.ringTilesResident = ringStats.tilesResident;
+        stats.ringTilesPending = ringStats.tilesPending;
+        stats.ringBufferMB = (float)ringStats.bufferBytes / (1024.0f * 1024.0f);
+        for (const GrassChunk& chunk : ring->getChunks()) stats.instancesTotal += chunk.count;
+        drawChunks(ring->getChunks(), ringVAO, ring->getInstanceVBO(), ring->getMetaVBO(), frustum, camPos);
+    }
 
-    shader->setInt("texture_diffuse1", 0);
+    if (!patchTypes.empty()) {
+        applyUniforms(*patchShader, view, projection, time, camPos, lightPos, lightColor);
+        drawPatches(frustum, camPos);
+    }
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 
-    glDisable(GL_CULL_FACE);
+    glEnable(GL_CULL_FACE);
+}
+
+void GrassSystem::drawChunks(const std::vector<GrassChunk>& chunkList, unsigned int vao, unsigned int instances,
+                             unsigned int meta, const Frustum& frustum, const glm::vec3& camPos) {
+    bool bound = false;
+    int runFirst = 0, runCount = 0;
+    // Zusammenhängenden Bereich zeichnen: Instanz-Attribute auf runFirst umbiegen (GL 3.3 hat kein baseInstance)
+    auto flush = [&]() {
+        if (runCount == 0) return;
+        if (!bound) {
+            glBindVertexArray(vao);
+            bound = true;
+        }
+        bindInstanceAttributes(instances, meta, (size_t)runFirst);
+        glDrawArraysInstanced(GL_TRIANGLES, 0, CARD_VERTICES, runCount);
+        stats.drawCalls++;
+        runCount = 0;
+    };
+
+    for (const GrassChunk& chunk : chunkList) {
+        // Dichte am nächsten Punkt der Box = höchste Dichte im Chunk (der Shader dünnt pro Instanz weiter aus)
+        float distance = glm::length(glm::clamp(camPos, chunk.boundsMin, chunk.boundsMax) - camPos);
+        int count = std::min(chunk.count, (int)std::ceil(lodDensity(distance) * (float)chunk.count));
+        if (count <= 0 || !frustum.isBoxVisible(chunk.boundsMin, chunk.boundsMax)) continue;
+        stats.chunksVisible++;
+        stats.instancesDrawn += count;
+        // Nur vollständig gezeichnete Chunks lassen sich mit dem nächsten zusammenfassen
+        if (runCount > 0 && chunk.first == runFirst + runCount) {
+            runCount += count;
+        } else {
+            flush();
+            runFirst = chunk.first;
+            runCount = count;
+        }
+        if (count < chunk.count) flush();
+    }
+    flush();
+}
 
-    for (const auto& grass : grassTypes) {
-        if(grass.amount == 0) continue;
+// --- GRAS-RING ---
+void GrassSystem::enableRing(int radiusTiles, int workerCount) {
+    ringRadius = std::max(radiusTiles, 1);
+    ringWorkers = std::max(workerCount, 1);
+}
 
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, grass.textureID);
+void GrassSystem::createRing() {
+    float expected = 0.0f;
+    for (const GrassType& type : grassTypes) expected += type.density * CHUNK_SIZE * CHUNK_SIZE;
+    int capacity = (int)std::ceil(expected * RING_CAPACITY_MARGIN) + 64;
 
-        glBindVertexArray(grass.VAO);
-        glDrawArraysInstanced(GL_TRIANGLES, 0, 6, grass.amount);
-        glBindVertexArray(0);
+    ring = std::make_unique<GrassRing>(CHUNK_SIZE, ringRadius, capacity,
+        [this](int tileX, int tileZ, GrassRingTile& out) { generateRingTile(tileX, tileZ, out); }, ringWorkers);
+
+    if (ringVAO == 0) glGenVertexArrays(1, &ringVAO);
+}
+
+// Ein Tile = ein Chunk: Poisson-Disk pro Typ nur im Tile (unabhängig von den Nachbarn, daher in beliebiger
+// Reihenfolge und auf beliebig vielen Threads gleich), Zufallsstrom aus (Seed, Typ, Tile)
+void GrassSystem::generateRingTile(int tileX, int tileZ, GrassRingTile& out) const {
+    glm::vec2 tileMin((float)tileX * CHUNK_SIZE, (float)tileZ * CHUNK_SIZE);
+    std::vector<GrassInstance> instances;
+    std::vector<uint8_t> layers;
+    std::vector<glm::vec2> points;
+    for (size_t t = 0; t < grassTypes.size(); t++) {
+        const GrassType& type = grassTypes[t];
+        uint32_t typeSeed = hashUint(placementSeed ^ hashUint((uint32_t)(t + 1) * 0x85EBCA6Bu));
+        HashRandom rng(typeSeed ^ hashUint((uint32_t)tileX * 0x27D4EB2Du ^ hashUint((uint32_t)tileZ * 0x165667B1u)));
+
+        PoissonGrid grid(tileMin, CHUNK_SIZE, type.radius);
+        points.clear();
+        samplePoisson(grid, glm::ivec2(0, 0), glm::ivec2(grid.res, grid.res), type.radius,
+                      tileMin + glm::vec2(CHUNK_SIZE), rng, points);
+        finishPlacement(points, type.scale, type.isLeaf, rng, instances);
+        layers.resize(instances.size(), (uint8_t)type.layer);
+    }
+
+    std::vector<GrassChunk> tileChunks;
+    buildChunks(instances, layers, tileMin, tileChunks);
+    if (tileChunks.empty()) return;
+    out.boundsMin = tileChunks[0].boundsMin;
+    out.boundsMax = tileChunks[0].boundsMax;
+    for (const GrassChunk& chunk : tileChunks) {
+        out.boundsMin = glm::min(out.boundsMin, chunk.boundsMin);
+        out.boundsMax = glm::max(out.boundsMax, chunk.boundsMax);
+    }
+
+    out.meta.resize(instances.size());
+    for (size_t i = 0; i < instances.size(); i++) {
+        uint32_t rank = (uint32_t)std::lround(((float)i + 0.5f) / (float)instances.size() * 65535.0f);
+        out.meta[i] = rank | ((uint32_t)layers[i] << 16);
+    }
+    out.instances.swap(instances);
+}
+
+// Alle Typen eines Batches liegen in einem Puffer, die Textur-Ebene kommt pro Instanz aus dem metaVBO
+void GrassSystem::drawBatches(const std::vector<const GrassBatch*>& batches, const glm::mat4& view, const glm::mat4& projection,
+                              float time, const glm::vec3& camPos, const glm::vec3& lightPos, const glm::vec3& lightColor) {
+    if (batches.empty() || grassTypes.empty()) return;
+    if (textureArrayLayers != (int)layerPaths.size()) buildTextureArray();
+    applyUniforms(*shader, view, projection, time, camPos, lightPos, lightColor);
+    glDisable(GL_CULL_FACE);
+
+    Frustum frustum(projection * view);
+    stats = GrassStats();
+    stats.chunksTotal = (int)batches.size();
+    for (const GrassBatch* batch : batches) {
+        if (batch->VAO == 0 || batch->typeOffsets.empty()) continue;
+        int count = batch->typeOffsets.back();
+        if (count <= 0) continue;
+        stats.instancesTotal += count;
+        // Alle Instanzen haben Rang 0: der Batch fällt erst ganz weg, wenn die Dichte an der Box 0 ist
+        float distance = glm::length(glm::clamp(camPos, batch->boundsMin, batch->boundsMax) - camPos);
+        if (lodDensity(distance) <= 0.0f || !frustum.isBoxVisible(batch->boundsMin, batch->boundsMax)) continue;
+        glBindVertexArray(batch->VAO);
+        glDrawArraysInstanced(GL_TRIANGLES, 0, CARD_VERTICES, count);
+        stats.chunksVisible++;
+        stats.instancesDrawn += count;
+        stats.drawCalls++;
     }
+    glBindVertexArray(0);
 
     glEnable(GL_CULL_FACE);
 }
 
-unsigned int GrassSystem::loadTexture(const char* path) {
-    unsigned int textureID;
-    glGenTextures(1, &textureID);
-
-    int width, height, nrComponents;
-    unsigned char *data = stbi_load(path, &width, &height, &nrComponents, 0);
-    if (data) {
-        GLenum format = (nrComponents == 4) ? GL_RGBA : GL_RGB;
-        glBindTexture(GL_TEXTURE_2D, textureID);
-        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        stbi_image_free(data);
-    } else {
-        std::cout << "Texture failed: " << path << std::endl;
+// --- TEXTUR-ARRAY ---
+int GrassSystem::addLayer(const std::string& texturePath) {
+    if ((int)layerPaths.size() >= MAX_LAYERS) {
+        std::cout << "WARNUNG: Gras-Textur-Array voll (" << MAX_LAYERS << " Ebenen): " << texturePath << std::endl;
+        return -1;
+    }
+    layerPaths.push_back(texturePath);
+    return (int)layerPaths.size() - 1;
+}
+
+// Bilinear auf die Ebenen-Größe skalieren (RGBA8)
+static void resampleRGBA(const unsigned char* src, int srcWidth, int srcHeight,
+                         unsigned char* dst, int dstWidth, int dstHeight) {
+    for (int y = 0; y < dstHeight; y++) {
+        float fy = std::max(((float)y + 0.5f) * (float)srcHeight / (float)dstHeight - 0.5f, 0.0f);
+        int y0 = std::min((int)fy, srcHeight - 1), y1 = std::min(y0 + 1, srcHeight - 1);
+        float ty = fy - (float)y0;
+        for (int x = 0; x < dstWidth; x++) {
+            float fx = std::max(((float)x + 0.5f) * (float)srcWidth / (float)dstWidth - 0.5f, 0.0f);
+            int x0 = std::min((int)fx, srcWidth - 1), x1 = std::min(x0 + 1, srcWidth - 1);
+            float tx = fx - (float)x0;
+            for (int c = 0; c < 4; c++) {
+                float top = src[(y0 * srcWidth + x0) * 4 + c] * (1.0f - tx) + src[(y0 * srcWidth + x1) * 4 + c] * tx;
+                float bottom = src[(y1 * srcWidth + x0) * 4 + c] * (1.0f - tx) + src[(y1 * srcWidth + x1) * 4 + c] * tx;
+                dst[(y * dstWidth + x) * 4 + c] = (unsigned char)std::lround(top * (1.0f - ty) + bottom * ty);
+            }
+        }
+    }
+}
+
+// --- KARTEN-UMRISS ---
+static float cross2(const glm::vec2& a, const glm::vec2& b) {
+    return a.x * b.y - a.y * b.x;
+}
+
+// Andrew's Monotone Chain, Ergebnis gegen den Uhrzeigersinn ohne kollineare Punkte
+static std::vector<glm::vec2> convexHull(std::vector<glm::vec2> points) {
+    std::sort(points.begin(), points.end(), [](const glm::vec2& a, const glm::vec2& b) {
+        return a.x < b.x || (a.x == b.x && a.y < b.y);
+    });
+    points.erase(std::unique(points.begin(), points.end(), [](const glm::vec2& a, const glm::vec2& b) {
+        return a.x == b.x && a.y == b.y;
+    }), points.end());
+    if (points.size() < 3) return points;
+
+    std::vector<glm::vec2> hull(2 * points.size());
+    size_t k = 0;
+    for (size_t i = 0; i < points.size(); i++) {
+        while (k >= 2 && cross2(hull[k - 1] - hull[k - 2], points[i] - hull[k - 2]) <= 0.0f) k--;
+        hull[k++] = points[i];
+    }
+    for (size_t i = points.size() - 1, lower = k + 1; i > 0; i--) {
+        while (k >= lower && cross2(hull[k - 1] - hull[k - 2], points[i - 1] - hull[k - 2]) <= 0.0f) k--;
+        hull[k++] = points[i - 1];
+    }
+    hull.resize(k - 1);
+    return hull;
+}
+
+static float polygonArea(const std::vector<glm::vec2>& polygon) {
+    float area = 0.0f;
+    for (size_t i = 0; i < polygon.size(); i++) area += cross2(polygon[i], polygon[(i + 1) % polygon.size()]);
+    return 0.5f * std::abs(area);
+}
+
+// Konvexe Hülle der deckenden Texel (aufgeweitet um padding Texel), reduziert auf höchstens
+// CARD_OUTLINE_VERTICES Ecken: wiederholt fällt die Kante weg, deren Nachbarkanten verlängert am wenigsten
+// Fläche dazunehmen. Das Ergebnis umschließt die Hülle immer, ohne gültige Reduktion bleibt das volle Quad.
+// Liefert den Flächenanteil am Quad.
+float GrassSystem::computeCardOutline(const unsigned char* rgba, int width, int height, glm::vec2* out) {
+    const glm::vec2 quad[4] = { glm::vec2(0.0f, 0.0f), glm::vec2(1.0f, 0.0f), glm::vec2(1.0f, 1.0f), glm::vec2(0.0f, 1.0f) };
+    std::vector<glm::vec2> polygon(quad, quad + 4);
+
+    // Pro Zeile reichen die äußersten deckenden Texel (die Hülle ist ohnehin konvex)
+    const int threshold = (int)(OUTLINE_ALPHA_THRESHOLD * 255.0f);
+    const float padding = (float)std::max(OUTLINE_PADDING_TEXELS, std::max(width, height) / 64);
+    glm::vec2 texel(1.0f / (float)width, 1.0f / (float)height);
+    std::vector<glm::vec2> points;
+    for (int y = 0; y < height; y++) {
+        int x0 = -1, x1 = -1;
+        for (int x = 0; x < width; x++) {
+            if (rgba[((size_t)y * width + x) * 4 + 3] < threshold) continue;
+            if (x0 < 0) x0 = x;
+            x1 = x;
+        }
+        if (x0 < 0) continue;
+        float left = std::max((float)x0 - padding, 0.0f), right = std::min((float)(x1 + 1) + padding, (float)width);
+        float top = std::max((float)y - padding, 0.0f), bottom = std::min((float)(y + 1) + padding, (float)height);
+        for (float px : { left, right })
+            for (float py : { top, bottom })
+                points.push_back(glm::vec2(px, py) * texel);
+    }
+
+    std::vector<glm::vec2> hull = convexHull(points);
+    if (hull.size() >= 3) {
+        while ((int)hull.size() > CARD_OUTLINE_VERTICES) {
+            int n = (int)hull.size();
+            int best = -1;
+            float bestArea = FLT_MAX;
+            glm::vec2 bestPoint(0.0f);
+            for (int i = 0; i < n; i++) {
+                const glm::vec2& a = hull[(i + n - 1) % n];
+                const glm::vec2& b = hull[i];
+                const glm::vec2& c = hull[(i + 1) % n];
+                const glm::vec2& d = hull[(i + 2) % n];
+                // Kante b-c entfernen: Geraden a->b und d->c schneiden
+                glm::vec2 d1 = b - a, d2 = c - d;
+                float denom = cross2(d1, d2);
+                if (std::abs(denom) < 1e-9f) continue;
+                float t = cross2(c - b, d2) / denom;
+                float s = cross2(c - b, d1) / denom;
+                if (t < 0.0f || s < 0.0f) continue;
+                glm::vec2 q = b + t * d1;
+                if (q.x < -1e-4f || q.x > 1.0f + 1e-4f || q.y < -1e-4f || q.y > 1.0f + 1e-4f) continue;
+                float added = 0.5f * std::abs(cross2(q - b, c - b));
+                if (added < bestArea) { bestArea = added; best = i; bestPoint = glm::clamp(q, glm::vec2(0.0f), glm::vec2(1.0f)); }
+            }
+            if (best < 0) break;
+            hull[best] = bestPoint;
+            hull.erase(hull.begin() + (best + 1) % n);
+        }
+        if ((int)hull.size() <= CARD_OUTLINE_VERTICES) polygon = hull;
+    }
+
+    // Auf CARD_OUTLINE_VERTICES auffüllen (entartete Dreiecke im Fächer)
+    for (int i = 0; i < CARD_OUTLINE_VERTICES; i++) out[i] = polygon[std::min(i, (int)polygon.size() - 1)];
+    return polygonArea(polygon);
+}
+
+// Alle Ebenen in der Größe des ersten Bildes (wie Terrain::loadTextureArray), abweichende Bilder werden skaliert.
+// Dazu der Karten-Umriss jeder Ebene (RG32F, CARD_OUTLINE_VERTICES x Ebenen, UV-Koordinaten).
+void GrassSystem::buildTextureArray() {
+    if (textureArray == 0) glGenTextures(1, &textureArray);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, textureArray);
+
+    int layerWidth = 0, layerHeight = 0;
+    std::vector<unsigned char> resized;
+    std::vector<glm::vec2> outlines(layerPaths.size() * CARD_OUTLINE_VERTICES);
+    float areaSum = 0.0f;
+    for (size_t layer = 0; layer < layerPaths.size(); layer++) {
+        int width, height, nrComponents;
+        unsigned char *data = stbi_load(layerPaths[layer].c_str(), &width, &height, &nrComponents, 4);
+        if (!data) {
+            std::cout << "Texture failed: " << layerPaths[layer] << std::endl;
+            // Volles Quad
+            const glm::vec2 quad[4] = { glm::vec2(0.0f, 0.0f), glm::vec2(1.0f, 0.0f), glm::vec2(1.0f, 1.0f), glm::vec2(0.0f, 1.0f) };
+            for (int i = 0; i < CARD_OUTLINE_VERTICES; i++) outlines[layer * CARD_OUTLINE_VERTICES + i] = quad[std::min(i, 3)];
+            areaSum += 1.0f;
+            continue;
+        }
+        if (layerWidth == 0) {
+            layerWidth = width; layerHeight = height;
+            glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, layerWidth, layerHeight, (GLsizei)layerPaths.size(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        }
+        const unsigned char* pixels = data;
+        if (width != layerWidth || height != layerHeight) {
+            resized.resize((size_t)layerWidth * layerHeight * 4);
+            resampleRGBA(data, width, height, resized.data(), layerWidth, layerHeight);
+            pixels = resized.data();
+        }
+        glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, (GLint)layer, layerWidth, layerHeight, 1, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+        areaSum += computeCardOutline(pixels, layerWidth, layerHeight, &outlines[layer * CARD_OUTLINE_VERTICES]);
         stbi_image_free(data);
     }
-    return textureID;
-}
\ No newline at end of file
+
+    if (layerWidth > 0) glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+    textureArrayLayers = (int)layerPaths.size();
+
+    if (outlineTexture == 0) glGenTextures(1, &outlineTexture);
+    glBindTexture(GL_TEXTURE_2D, outlineTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RG32F, CARD_OUTLINE_VERTICES, (GLsizei)std::max<size_t>(layerPaths.size(), 1), 0,
+                 GL_RG, GL_FLOAT, outlines.empty() ? nullptr : outlines.data());
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    if (!layerPaths.empty()) {
+        std::cout << "Gras-Karten: Umriss im Mittel " << areaSum / (float)layerPaths.size() * 100.0f
+                  << "% der Quad-Fläche (" << layerPaths.size() << " Ebenen)" << std::endl;
+    }
+}
@@ -4,28 +4,75 @@
 #include <glm/glm.hpp>
 #include <vector>
 #include <string>
+#include <cstdint>
+#include <memory>
 #include "Shader.h"
+#include "TerrainQuery.h"
+#include "Frustum.h"
 
+struct HashRandom;
+
+// Kompakte Gras-Instanz (16 statt 64 Byte für eine mat4), die Matrix wird im grass.vs.glsl rekonstruiert.
+// Rotation = (kürzeste Drehung Y -> up) * (Drehung um Y um yaw), Skalierung uniform.
+struct GrassInstance {
+    float x, y, z;   // Fußpunkt (Welt)
+    uint32_t packed; // Bit 0-15: up (Oktaeder, 2x unorm8), 16-23: yaw (unorm8 über 2 Pi), 24-31: Skalierung (unorm8 bis MAX_SCALE)
+};
+static_assert(sizeof(GrassInstance) == 16, "GrassInstance muss 16 Byte groß sein");
+
+// Räumlicher Block von Instanzen aller Gras-Typen (zusammenhängend im Instanz-Puffer)
+struct GrassChunk {
+    glm::vec3 boundsMin;   // Weltkoordinaten, inkl. Karten-Größe und Wind-Ausschlag
+    glm::vec3 boundsMax;
+    int first;             // erste Instanz im Puffer
+    int count;
+};
+
+// Gras-Typ = Ebene im Textur-Array des GrassSystem. Die Instanzen aller Typen liegen gemischt in einem Puffer.
 struct GrassType {
-    unsigned int textureID;
-    unsigned int VAO, VBO, instanceVBO;
-    std::vector<glm::mat4> modelMatrices;
-    int amount;
+    int layer = 0;        // Ebene im Textur-Array
+    int amount = 0;       // platzierte Instanzen (Ring-Modus: angefordert)
+    float density = 0.0f; // Ziel: Instanzen pro m²
+    float radius = 0.0f;  // Poisson-Disk-Mindestabstand
+    float scale = 1.0f;
+    bool isLeaf = false;
+};
 
-    GrassType(unsigned int texID, int count)
-        : textureID(texID), amount(count), VAO(0), VBO(0), instanceVBO(0) {}
+// Gras-Instanzen aus einer externen Quelle (z.B. ein gestreamtes Terrain-Tile), gezeichnet mit den Gras-Typen
+// des GrassSystem. Alle Typen liegen in EINEM Instanz-Puffer, nach Typ sortiert (CSR über typeOffsets);
+// die Textur-Ebene steht pro Instanz im metaVBO, ein Draw pro Batch.
+struct GrassBatch {
+    unsigned int VAO = 0, instanceVBO = 0, metaVBO = 0;
+    size_t capacity = 0;          // Instanzen, für die der Puffer angelegt ist (wird wiederverwendet)
+    std::vector<int> typeOffsets; // Instanzen von Typ t: [typeOffsets[t], typeOffsets[t + 1])
+    glm::vec3 boundsMin = glm::vec3(0.0f); // Weltkoordinaten, inkl. Karten-Größe und Wind-Ausschlag (wie GrassChunk)
+    glm::vec3 boundsMax = glm::vec3(0.0f);
 };
 
-// Beschleunigungs-Gitter Struktur
-struct AccelerationGrid {
-    float minX, maxX, minZ, maxZ;
-    float cellWidth, cellDepth;
-    int resolution = 100;
-    std::vector<std::vector<int>> cells;
+// Gras ohne Instanz-Daten: regelmäßiges Patch-Gitter um die Kamera, Karten entstehen im grass.vs.glsl
+struct GrassPatchType {
+    int layer;           // Ebene im Textur-Array
+    int cardsPerPatch;
+    float patchSpacing;  // Kantenlänge einer Patch-Zelle (Welt)
+    float radius;        // um die Kamera
+    float scale;
+    uint32_t seed;
+};
+
+class GrassRing;
+struct GrassRingTile;
 
-    std::vector<float> vertices;
-    std::vector<unsigned int> indices;
-    bool isBuilt = false;
+// Statistiken des letzten draw()-Aufrufs (für die UI)
+struct GrassStats {
+    int chunksTotal = 0;
+    int chunksVisible = 0;
+    int instancesTotal = 0;
+    int instancesDrawn = 0;
+    int patchCardsDrawn = 0;   // Karten aus prozeduralen Patches (obere Schranke, der Shader verwirft noch)
+    int drawCalls = 0;
+    int ringTilesResident = 0; // nur mit enableRing()
+    int ringTilesPending = 0;
+    float ringBufferMB = 0.0f;
 };
 
 class GrassSystem {
@@ -33,31 +80,152 @@ public:
     GrassSystem();
     ~GrassSystem();
 
-    // 1. Terrain Daten laden (baut das Grid)
-    void initTerrainData(const std::vector<float>& terrainVertices,
-                         const std::vector<unsigned int>& terrainIndices,
-                         float terrainScale);
+    // 1. Terrain-Service setzen (geteilt mit ForestSystem, muss länger leben als das GrassSystem)
+    void initTerrainData(const TerrainQuery& terrainQuery);
 
-    // 2. Gras hinzufügen (nutzt das Grid)
+    // 2. Gras hinzufügen: Poisson-Disk-Verteilung über [-spreadRadius, spreadRadius]², Tiles parallel.
+    // Gleicher Seed -> gleiches Ergebnis, unabhängig von der Thread-Anzahl.
+    void setPlacementSeed(uint32_t seed) { placementSeed = seed; }
     void addGrassType(const std::string& texturePath, int amount, float spreadRadius, float scale, bool isLeaf = false);
 
+    // 2a. Statt einmal um den Ursprung: Ring aus Tiles (CHUNK_SIZE) um die Kamera, radiusTiles in jede Richtung.
+    // Vor addGrassType aufrufen; amount / spreadRadius bestimmen dann nur noch die Dichte pro m².
+    // Die Tiles entstehen auf workerCount Threads, der Instanz-Puffer hat eine feste Größe.
+    void enableRing(int radiusTiles, int workerCount = 2);
+
+    // 2b. Gras ohne Instanz-Puffer: eine Instanz = ein Patch aus cardsPerPatch Karten, deren Position, Drehung und
+    // Größe der grass.vs.glsl aus einem Hash der Patch-Zelle erzeugt (Höhe aus den Raster-Höhen des TerrainQuery).
+    // Kostet nur die Textur, gezeichnet wird innerhalb von radius um die Kamera.
+    void addPatchGrassType(const std::string& texturePath, int cardsPerPatch, float patchSpacing, float radius, float scale);
+
+    // Editor: Instanzen im XZ-Bereich auf die aktuelle Terrain-Höhe setzen (nach einem Terrain-Edit).
+    // Liest die betroffenen Chunks per glGetBufferSubData zurück (keine CPU-Kopie der Instanzen).
+    void resnapRegion(const glm::vec2& regionMin, const glm::vec2& regionMax);
+
     // 3. Zeichnen (Update: Jetzt mit Licht-Infos!)
+    // Alle Typen in einem Puffer und einem Textur-Array: die Draws hängen nur von den sichtbaren Chunks ab.
+    // Nur Chunks im Frustum; benachbarte sichtbare Chunks werden zu einem Draw zusammengefasst.
+    // Pro Chunk wird nur das Präfix gezeichnet, das die LOD-Dichte in seiner Entfernung braucht.
     void draw(const glm::mat4& view, const glm::mat4& projection, float time,
               const glm::vec3& camPos, const glm::vec3& lightPos, const glm::vec3& lightColor);
 
+    const GrassStats& getStats() const { return stats; }
+
+    // Distanz-LOD: volle Dichte bis fullDensityDistance, danach Dichte ~ 1/d² (gleiche Dichte am Bildschirm),
+    // ab 80% von maxDistance ausgeblendet, dahinter nichts. Übergänge werden im Shader gedithert.
+    void setLodDistances(float fullDensityDistance, float maxDistance);
+
+    // Für Uniforms, die nicht vom GrassSystem kommen (z.B. TerrainLightBake)
+    Shader& getShader() { return *shader; }
+    Shader& getPatchShader() { return *patchShader; }
+
+    // Externe Instanz-Puffer: Instanzen nach Typ sortiert, typeOffsets wie in GrassBatch.
+    // Der Puffer wird nur vergrößert, nie verkleinert (Batches werden vom Streaming wiederverwendet).
+    void uploadBatch(GrassBatch& batch, const std::vector<GrassInstance>& instances, const std::vector<int>& typeOffsets) const;
+
+    // Kodiert eine Transformation aus Translation, Rotation und uniformer Skalierung (Skalierung bis MAX_SCALE)
+    static constexpr float MAX_SCALE = 1.0f;
+    static GrassInstance encodeInstance(const glm::mat4& model);
+    static float instanceExtent(const GrassInstance& g); // Radius der Karte um den Fußpunkt (inkl. Wind)
+    static void destroyBatch(GrassBatch& batch);
+
+    // Zeichnet nur die übergebenen Batches (gleiche Uniforms wie draw), ein Draw pro Batch im Frustum und
+    // innerhalb der LOD-Maximaldistanz
+    void drawBatches(const std::vector<const GrassBatch*>& batches, const glm::mat4& view, const glm::mat4& projection,
+                     float time, const glm::vec3& camPos, const glm::vec3& lightPos, const glm::vec3& lightColor);
+
 private:
     Shader* shader;
+    Shader* patchShader; // grass.vs.glsl mit GRASS_PATCHES
     std::vector<GrassType> grassTypes;
-    AccelerationGrid grid;
+    std::vector<GrassPatchType> patchTypes;
+    mutable bool warnedUnknownBatchType = false; // uploadBatch warnt nur einmal
+    const TerrainQuery* terrain = nullptr;
+
+    // Karte = Fächer aus 6 Dreiecken über den Umriss der Textur-Ebene (statt des vollen Quads), die Ecken holt
+    // der grass.vs.glsl per gl_VertexID aus outlineTexture. Spart Fläche, in der der FS nur discarded.
+    static constexpr int CARD_OUTLINE_VERTICES = 8;
+    static constexpr int CARD_VERTICES = 3 * (CARD_OUTLINE_VERTICES - 2);
+    static constexpr int OUTLINE_TEXTURE_UNIT = 8;
+    static constexpr float OUTLINE_ALPHA_THRESHOLD = 0.1f; // unter dem Alpha-Test (0.2), Filterung zieht Alpha nach außen
+    static constexpr int OUTLINE_PADDING_TEXELS = 2;       // mindestens, sonst 1/64 der Texturgröße (Mip-Stufen)
+    unsigned int outlineTexture = 0;
+    static float computeCardOutline(const unsigned char* rgba, int width, int height, glm::vec2* out);
+
+    // Instanzen aller Typen: nach Chunk, im Chunk nach LOD-Rang. instanceVBO = GrassInstance,
+    // metaVBO = uint pro Instanz (Bit 0-15 LOD-Rang als unorm16, Bit 16-23 Textur-Ebene)
+    unsigned int VAO = 0, instanceVBO = 0, metaVBO = 0;
+    int instanceCount = 0;
+    std::vector<GrassChunk> chunks; // in Morton-Reihenfolge der Chunk-Koordinaten
+    // addGrassType sammelt hier, der nächste draw()/resnapRegion() baut Puffer und Chunks neu
+    std::vector<GrassInstance> pendingInstances;
+    std::vector<uint8_t> pendingLayers;
+    void flushPendingInstances();
+    // Sichtbare Chunks mit LOD-Präfix zeichnen, zusammenhängende Bereiche in einem Draw
+    void drawChunks(const std::vector<GrassChunk>& chunkList, unsigned int vao, unsigned int instances,
+                    unsigned int meta, const Frustum& frustum, const glm::vec3& camPos);
+
+    // Gras-Ring (enableRing): wird beim ersten draw() angelegt, wenn alle Typen bekannt sind
+    static constexpr float RING_CAPACITY_MARGIN = 1.5f; // Slot-Kapazität relativ zur mittleren Dichte
+    int ringRadius = 0;
+    int ringWorkers = 2;
+    std::unique_ptr<GrassRing> ring;
+    unsigned int ringVAO = 0;
+    void createRing();
+    void generateRingTile(int tileX, int tileZ, GrassRingTile& out) const; // läuft in den Ring-Workern
+
+    // Textur-Array: eine Ebene pro Gras- und Patch-Typ, neu aufgebaut sobald Ebenen dazukommen
+    static constexpr int MAX_LAYERS = 256;
+    std::vector<std::string> layerPaths;
+    unsigned int textureArray = 0;
+    int textureArrayLayers = 0;
+    int addLayer(const std::string& texturePath); // -1 wenn das Array voll ist
+    void buildTextureArray();
+    GrassStats stats;
+    float lodFullDistance = 30.0f;
+    float lodMaxDistance = 180.0f;
+    float lodDensity(float distance) const; // wie lodDensity() im grass.vs.glsl
+
+    // Nur Höhen in diesem Band tragen Gras (isGrassSurface, Patch-Shader)
+    static constexpr float GRASS_MIN_HEIGHT = -3.0f;
+    static constexpr float GRASS_MAX_HEIGHT = 18.0f;
+
+    // Prozedurale Patches: Blöcke aus PATCH_BLOCK² Patches (ein Frustum-Test + ein Draw pro Block)
+    static constexpr int PATCH_BLOCK = 8;
+    static constexpr int HEIGHT_TEXTURE_UNIT = 15;
+    unsigned int patchVAO = 0;       // leer, die Karten kommen aus gl_VertexID
+    unsigned int heightTexture = 0;  // Raster-Höhen des TerrainQuery (R32F), erst mit dem ersten Patch-Typ
+    void createHeightTexture();
+    void updateHeightTexture(const glm::vec2& regionMin, const glm::vec2& regionMax);
+    void drawPatches(const Frustum& frustum, const glm::vec3& camPos);
 
-    float quadVertices[30];
+    // Chunk-Binning: CHUNK_SIZE Welteinheiten pro Chunk, darin 2^MORTON_CHUNK_BITS Zellen pro Achse für die Sortierung
+    static constexpr float CHUNK_SIZE = 32.0f;
+    static constexpr int MORTON_CHUNK_BITS = 8;
+    // Sortiert instances (und layers parallel dazu) um, Chunk-Gitter ab areaMin
+    void buildChunks(std::vector<GrassInstance>& instances, std::vector<uint8_t>& layers,
+                     const glm::vec2& areaMin, std::vector<GrassChunk>& chunks) const;
 
-    unsigned int loadTexture(const char* path);
-    void setupBuffers(GrassType& grass);
-    float getYFromGrid(float x, float z);
+    // Instanz (Location 3 Position, 4 gepackt) und Meta (Location 7: Rang + Ebene) ab firstInstance, VAO gebunden
+    void bindInstanceAttributes(unsigned int instanceVBO, unsigned int metaVBO, size_t firstInstance) const;
+    void applyUniforms(Shader& target, const glm::mat4& view, const glm::mat4& projection, float time,
+                       const glm::vec3& camPos, const glm::vec3& lightPos, const glm::vec3& lightColor);
 
-    // Neue Methoden für bessere Platzierung
-    glm::vec3 getNormalFromGrid(float x, float z);
-    bool isGrassSurface(float x, float z);
-    float getDetailedNoise(float x, float z);
+    // Platzierung (läuft auf Worker-Threads, daher const)
+    struct PoissonGrid;
+    static constexpr float PLACEMENT_TILE = 16.0f;   // Kantenlänge eines Platzierungs-Tiles (Welt, mindestens)
+    static constexpr int POISSON_ATTEMPTS = 16;      // Kandidaten pro aktivem Punkt (Bridson)
+    static constexpr float POISSON_PACKING = 0.6f;   // Punkte pro r² eines gesättigten Musters (gemessen, 16 Versuche)
+    static constexpr float GRASS_TILT = 0.8f;        // Anteil der Terrain-Neigung, den aufrechtes Gras übernimmt
+    static constexpr float LEAF_LIFT = 0.02f;        // Leafs liegen so weit über der Oberfläche (entlang der Normale)
+    uint32_t placementSeed = 1;
+    float estimateAcceptance(float spreadRadius, uint32_t seed) const;
+    glm::mat4 buildInstanceMatrix(const glm::vec3& position, const glm::vec3& normal, float scale,
+                                  bool isLeaf, HashRandom& rng) const;
+    void samplePoisson(PoissonGrid& grid, const glm::ivec2& cellMin, const glm::ivec2& cellMax, float radius,
+                       const glm::vec2& areaMax, HashRandom& rng, std::vector<glm::vec2>& points) const;
+    void finishPlacement(const std::vector<glm::vec2>& points, float scale, bool isLeaf,
+                         HashRandom& rng, std::vector<GrassInstance>& out) const;
+    bool isGrassSurface(float y, const glm::vec3& normal) const;
+    float getDetailedNoise(float x, float z) const;
 };
\ No newline at end of file
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstdint>
+
+// Integer-Hash (lowbias32), Grundlage für reproduzierbare Zufallsströme
+inline uint32_t hashUint(uint32_t x) {
+    x ^= x >> 16; x *= 0x7feb352du;
+    x ^= x >> 15; x *= 0x846ca68bu;
+    x ^= x >> 16;
+    return x;
+}
+
+// Kleiner Zufallsstrom ohne Plattform-Abhängigkeit (std::uniform_*_distribution ist nicht portabel festgelegt):
+// gleicher Seed -> gleiche Folge mit jeder Standardbibliothek. Für Platzierung und prozedurale Welten.
+struct HashRandom {
+    uint32_t state;
+    explicit HashRandom(uint32_t seed) : state(hashUint(seed)) {}
+    uint32_t nextUint() { state = hashUint(state + 0x9E3779B9u); return state; }
+    float next() { return (float)(nextUint() >> 8) / 16777216.0f; } // [0, 1)
+    float range(float a, float b) { return a + (b - a) * next(); }
+    int index(int count) { return (int)(((uint64_t)nextUint() * (uint32_t)count) >> 32); } // [0, count)
+};
@@ -0,0 +1,309 @@
+#include "HeightmapTerrain.h"
+#include "TerrainQuery.h"
+#include <stb_image.h>
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+
+HeightmapTerrain::HeightmapTerrain(const std::string& heightmapPath, const glm::vec2& wMin, const glm::vec2& wSize,
+                                   float heightScale, float heightOffset)
+    : worldMin(wMin), worldSize(wSize) {
+    int w, h, channels;
+    unsigned short* raw = stbi_load_16(heightmapPath.c_str(), &w, &h, &channels, 1);
+    if (!raw) {
+        std::cout << "Heightmap failed to load: " << heightmapPath << std::endl;
+        return;
+    }
+
+    std::vector<float> data((size_t)w * h);
+    for (size_t i = 0; i < data.size(); i++) {
+        data[i] = heightOffset + (raw[i] / 65535.0f) * heightScale;
+    }
+    stbi_image_free(raw);
+
+    init(data, w, h);
+}
+
+HeightmapTerrain::HeightmapTerrain(const TerrainQuery& query) {
+    worldMin = glm::vec2(query.getMinX(), query.getMinZ());
+    worldSize = glm::vec2(query.getMaxX() - query.getMinX(), query.getMaxZ() - query.getMinZ());
+
+    // Texel ohne Terrain (außerhalb des Meshes) auf die tiefste gültige Höhe setzen
+    std::vector<float> data = query.getRasterHeights();
+    float lowest = 1e30f;
+    for (float h : data) if (h > TerrainQuery::NO_HEIGHT) lowest = std::min(lowest, h);
+    if (lowest > 1e29f) lowest = 0.0f;
+    for (float& h : data) if (h <= TerrainQuery::NO_HEIGHT) h = lowest;
+    fillHeight = lowest;
+
+    int res = query.getRasterResolution();
+    init(data, res, res);
+}
+
+HeightmapTerrain::~HeightmapTerrain() {
+    glDeleteVertexArrays(1, &VAO);
+    glDeleteBuffers(1, &VBO);
+    glDeleteBuffers(1, &EBO);
+    glDeleteBuffers(1, &instanceVBO);
+    glDeleteTextures(1, &heightTexture);
+}
+
+void HeightmapTerrain::init(const std::vector<float>& data, int w, int h) {
+    heights = data;
+    width = w;
+    height = h;
+
+    // Höhen-Textur (R32F, linear gefiltert, im Vertex Shader gesampelt)
+    glGenTextures(1, &heightTexture);
+    glBindTexture(GL_TEXTURE_2D, heightTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R32F, width, height, 0, GL_RED, GL_FLOAT, heights.data());
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    // LOD-Stufen: feinste Knoten decken ca. PATCH_GRID Texel ab (1 Quad pro Texel)
+    int leafNodes = std::max(1, std::max(width, height) / PATCH_GRID);
+    lodCount = 1;
+    while ((1 << (lodCount - 1)) < leafNodes && lodCount < MAX_LODS) lodCount++;
+
+    // Reichweite pro LOD verdoppelt sich, Basis = 2.5x Größe eines Blatt-Knotens
+    float leafSize = std::max(worldSize.x, worldSize.y) / (float)(1 << (lodCount - 1));
+    lodRanges[0] = leafSize * 2.5f;
+    for (int l = 1; l < lodCount; l++) lodRanges[l] = lodRanges[l - 1] * 2.0f;
+
+    buildMinMaxTree();
+    createPatchMesh();
+
+    std::cout << "Heightmap Terrain: " << width << "x" << height << ", " << lodCount << " LOD-Stufen." << std::endl;
+}
+
+// --- MIN/MAX QUADTREE ---
+void HeightmapTerrain::buildMinMaxTree() {
+    nodeMinMax.assign(lodCount, {});
+
+    // Ebene 0: direkt aus den Texeln (inkl. Randtexel zum Nachbarn)
+    int leafNodes = 1 << (lodCount - 1);
+    nodeMinMax[0].resize((size_t)leafNodes * leafNodes);
+    for (int nz = 0; nz < leafNodes; nz++)
+        for (int nx = 0; nx < leafNodes; nx++)
+            nodeMinMax[0][(size_t)nz * leafNodes + nx] = computeLeafMinMax(nx, nz, leafNodes);
+
+    // Höhere Ebenen: 4 Kinder zusammenfassen
+    for (int l = 1; l < lodCount; l++) {
+        int nodes = 1 << (lodCount - 1 - l);
+        nodeMinMax[l].resize((size_t)nodes * nodes);
+        for (int nz = 0; nz < nodes; nz++)
+            for (int nx = 0; nx < nodes; nx++)
+                nodeMinMax[l][(size_t)nz * nodes + nx] = combineChildren(l, nx, nz);
+    }
+}
+
+void HeightmapTerrain::updateMinMaxTree(int nx0, int nz0, int nx1, int nz1) {
+    int leafNodes = 1 << (lodCount - 1);
+    for (int nz = nz0; nz <= nz1; nz++)
+        for (int nx = nx0; nx <= nx1; nx++)
+            nodeMinMax[0][(size_t)nz * leafNodes + nx] = computeLeafMinMax(nx, nz, leafNodes);
+
+    for (int l = 1; l < lodCount; l++) {
+        int nodes = 1 << (lodCount - 1 - l);
+        for (int nz = nz0 >> l; nz <= (nz1 >> l); nz++)
+            for (int nx = nx0 >> l; nx <= (nx1 >> l); nx++)
+                nodeMinMax[l][(size_t)nz * nodes + nx] = combineChildren(l, nx, nz);
+    }
+}
+
+glm::vec2 HeightmapTerrain::computeLeafMinMax(int nx, int nz, int leafNodes) const {
+    int x0 = nx * (width - 1) / leafNodes,  x1 = (nx + 1) * (width - 1) / leafNodes;
+    int z0 = nz * (height - 1) / leafNodes, z1 = (nz + 1) * (height - 1) / leafNodes;
+    glm::vec2 mm(1e30f, -1e30f);
+    for (int z = z0; z <= z1; z++) {
+        for (int x = x0; x <= x1; x++) {
+            float h = heights[(size_t)z * width + x];
+            mm.x = std::min(mm.x, h);
+            mm.y = std::max(mm.y, h);
+        }
+    }
+    return mm;
+}
+
+glm::vec2 HeightmapTerrain::combineChildren(int lod, int nx, int nz) const {
+    int childNodes = 1 << (lodCount - lod);
+    glm::vec2 mm(1e30f, -1e30f);
+    for (int c = 0; c < 4; c++) {
+        const glm::vec2& child = nodeMinMax[lod - 1][(size_t)(nz * 2 + c / 2) * childNodes + (nx * 2 + c % 2)];
+        mm.x = std::min(mm.x, child.x);
+        mm.y = std::max(mm.y, child.y);
+    }
+    return mm;
+}
+
+// --- EDITOR ---
+void HeightmapTerrain::applyEdit(const TerrainQuery& query, const TerrainEdit& edit) {
+    if (heightTexture == 0 || query.getRasterResolution() != width || query.getRasterResolution() != height) return;
+    if (edit.rasterX1 < edit.rasterX0 || edit.rasterZ1 < edit.rasterZ0) return;
+
+    const std::vector<float>& source = query.getRasterHeights();
+    for (int z = edit.rasterZ0; z <= edit.rasterZ1; z++) {
+        for (int x = edit.rasterX0; x <= edit.rasterX1; x++) {
+            size_t i = (size_t)z * width + x;
+            heights[i] = source[i] > TerrainQuery::NO_HEIGHT ? source[i] : fillHeight;
+        }
+    }
+
+    glBindTexture(GL_TEXTURE_2D, heightTexture);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, width);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, edit.rasterX0, edit.rasterZ0,
+                    edit.rasterX1 - edit.rasterX0 + 1, edit.rasterZ1 - edit.rasterZ0 + 1, GL_RED, GL_FLOAT,
+                    &heights[(size_t)edit.rasterZ0 * width + edit.rasterX0]);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    // Blatt-Knoten teilen sich Randtexel -> einen Knoten Rand mitnehmen
+    int leafNodes = 1 << (lodCount - 1);
+    int nx0 = std::clamp(edit.rasterX0 * leafNodes / (width - 1) - 1, 0, leafNodes - 1);
+    int nx1 = std::clamp(edit.rasterX1 * leafNodes / (width - 1), 0, leafNodes - 1);
+    int nz0 = std::clamp(edit.rasterZ0 * leafNodes / (height - 1) - 1, 0, leafNodes - 1);
+    int nz1 = std::clamp(edit.rasterZ1 * leafNodes / (height - 1), 0, leafNodes - 1);
+    updateMinMaxTree(nx0, nz0, nx1, nz1);
+}
+
+// --- GRID PATCH ---
+void HeightmapTerrain::createPatchMesh() {
+    std::vector<float> vertices;
+    std::vector<unsigned int> indices;
+
+    // Grid-Koordinaten in [0,1], Verschiebung passiert im Vertex Shader
+    for (int z = 0; z <= PATCH_GRID; z++) {
+        for (int x = 0; x <= PATCH_GRID; x++) {
+            vertices.push_back((float)x / PATCH_GRID);
+            vertices.push_back(0.0f);
+            vertices.push_back((float)z / PATCH_GRID);
+        }
+    }
+    // CCW von oben gesehen (Face Culling ist aktiv)
+    for (int z = 0; z < PATCH_GRID; z++) {
+        for (int x = 0; x < PATCH_GRID; x++) {
+            unsigned int a = z * (PATCH_GRID + 1) + x;
+            unsigned int b = a + 1;
+            unsigned int c = a + (PATCH_GRID + 1);
+            unsigned int d = c + 1;
+            indices.insert(indices.end(), { a, c, d, a, d, b });
+        }
+    }
+    patchIndexCount = (unsigned int)indices.size();
+
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &VBO);
+    glGenBuffers(1, &EBO);
+    glGenBuffers(1, &instanceVBO);
+
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
+
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+
+    // Pro Instanz: offset.xz, Größe, LOD (Location 4)
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    glVertexAttribPointer(4, 4, GL_FLOAT, GL_FALSE, sizeof(glm::vec4), (void*)0);
+    glEnableVertexAttribArray(4);
+    glVertexAttribDivisor(4, 1);
+
+    glBindVertexArray(0);
+}
+
+void HeightmapTerrain::getNodeBounds(int lod, int nx, int nz, glm::vec3& bMin, glm::vec3& bMax) const {
+    int nodes = 1 << (lodCount - 1 - lod);
+    glm::vec2 size = worldSize / (float)nodes;
+    const glm::vec2& mm = nodeMinMax[lod][(size_t)nz * nodes + nx];
+    bMin = glm::vec3(worldMin.x + nx * size.x, mm.x, worldMin.y + nz * size.y);
+    bMax = glm::vec3(bMin.x + size.x, mm.y, bMin.z + size.y);
+}
+
+// Schneidet die Kugel (Kamera, Reichweite) die Box?
+static bool boxInRange(const glm::vec3& bMin, const glm::vec3& bMax, const glm::vec3& p, float range) {
+    glm::vec3 closest = glm::clamp(p, bMin, bMax);
+    glm::vec3 d = closest - p;
+    return glm::dot(d, d) <= range * range;
+}
+
+// --- CDLOD AUSWAHL ---
+bool HeightmapTerrain::selectNode(int lod, int nx, int nz, const Frustum& frustum, const glm::vec3& camPos) {
+    glm::vec3 bMin, bMax;
+    getNodeBounds(lod, nx, nz, bMin, bMax);
+
+    // Unsichtbar: nichts zeichnen, aber als "erledigt" melden
+    if (!frustum.isBoxVisible(bMin, bMax)) return true;
+
+    // Außerhalb der Reichweite dieser Stufe -> der Eltern-Knoten übernimmt
+    if (!boxInRange(bMin, bMax, camPos, lodRanges[lod])) return false;
+
+    int nodes = 1 << (lodCount - 1 - lod);
+    glm::vec2 size = worldSize / (float)nodes;
+
+    // Feinste Stufe oder Kinder-Reichweite nicht erreicht -> ganzen Knoten auf dieser Stufe zeichnen
+    if (lod == 0 || !boxInRange(bMin, bMax, camPos, lodRanges[lod - 1])) {
+        selection.push_back(glm::vec4(bMin.x, bMin.z, size.x, (float)lod));
+        return true;
+    }
+
+    // Sonst in die Kinder absteigen; Kinder außerhalb ihrer Reichweite mit dieser Stufe zeichnen
+    for (int c = 0; c < 4; c++) {
+        int cx = nx * 2 + c % 2;
+        int cz = nz * 2 + c / 2;
+        if (!selectNode(lod - 1, cx, cz, frustum, camPos)) {
+            glm::vec3 cMin, cMax;
+            getNodeBounds(lod - 1, cx, cz, cMin, cMax);
+            selection.push_back(glm::vec4(cMin.x, cMin.z, size.x * 0.5f, (float)lod));
+        }
+    }
+    return true;
+}
+
+void HeightmapTerrain::draw(Shader& shader, const glm::mat4& viewProj, const glm::vec3& camPos) {
+    patchesDrawn = 0;
+    if (heightTexture == 0 || lodCount == 0) return;
+
+    // 1. Quadtree-Auswahl
+    selection.clear();
+    Frustum frustum(viewProj);
+    if (!selectNode(lodCount - 1, 0, 0, frustum, camPos)) {
+        // Kamera weit außerhalb: ganzes Terrain auf gröbster Stufe
+        selection.push_back(glm::vec4(worldMin.x, worldMin.y, worldSize.x, (float)(lodCount - 1)));
+    }
+    patchesDrawn = (int)selection.size();
+    if (selection.empty()) return;
+
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, selection.size() * sizeof(glm::vec4), selection.data(), GL_STREAM_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    // 2. Uniforms (Morph-Bereich pro LOD: Start bei ~2/3 zwischen vorheriger und eigener Reichweite)
+    shader.use();
+    shader.setBool("useHeightmap", true);
+    shader.setInt("heightMap", HEIGHT_TEXTURE_UNIT);
+    shader.setVec2("heightmapWorldMin", worldMin);
+    shader.setVec2("heightmapWorldSize", worldSize);
+    shader.setFloat("patchGrid", (float)PATCH_GRID);
+    for (int l = 0; l < lodCount; l++) {
+        float prev = (l > 0) ? lodRanges[l - 1] : 0.0f;
+        float morphStart = prev + (lodRanges[l] - prev) * 0.66f;
+        shader.setVec2("morphRanges[" + std::to_string(l) + "]", glm::vec2(morphStart, lodRanges[l]));
+    }
+
+    glActiveTexture(GL_TEXTURE0 + HEIGHT_TEXTURE_UNIT);
+    glBindTexture(GL_TEXTURE_2D, heightTexture);
+
+    // 3. Alle Patches in einem instanzierten Aufruf
+    glBindVertexArray(VAO);
+    glDrawElementsInstanced(GL_TRIANGLES, patchIndexCount, GL_UNSIGNED_INT, 0, (GLsizei)selection.size());
+    glBindVertexArray(0);
+
+    glActiveTexture(GL_TEXTURE0);
+    shader.setBool("useHeightmap", false);
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include <string>
+#include "Shader.h"
+#include "Frustum.h"
+
+class TerrainQuery;
+struct TerrainEdit;
+
+// Heightmap-Terrain mit CDLOD (Continuous Distance-Dependent Level of Detail):
+// Ein Quadtree wählt pro Frame Knoten passend zur Kamera-Distanz aus, jeder Knoten
+// wird mit DEMSELBEN Grid-Patch gezeichnet (instanziert) und im terrain.vs.glsl
+// über die Höhen-Textur verschoben. Zwischen den LOD-Stufen wird weich gemorpht.
+// Die Dreiecksanzahl hängt damit von der Distanz ab, nicht von der Auflösung der Quelle.
+class HeightmapTerrain {
+public:
+    // Aus 16-Bit Graustufen-PNG (Höhe = heightOffset + value * heightScale)
+    HeightmapTerrain(const std::string& heightmapPath, const glm::vec2& worldMin, const glm::vec2& worldSize,
+                     float heightScale, float heightOffset);
+
+    // Aus dem gebackenen Raster des TerrainQuery (gleiche Höhen wie das Mesh-Terrain)
+    explicit HeightmapTerrain(const TerrainQuery& query);
+
+    ~HeightmapTerrain();
+
+    // Übernimmt die neu gebackenen Raster-Texel eines Terrain-Edits (nur beim Bau aus dem TerrainQuery)
+    void applyEdit(const TerrainQuery& query, const TerrainEdit& edit);
+
+    // Wählt die LOD-Knoten aus und zeichnet sie mit dem Terrain-Shader
+    void draw(Shader& shader, const glm::mat4& viewProj, const glm::vec3& camPos);
+
+    int getPatchesDrawn() const { return patchesDrawn; }
+    int getTrianglesDrawn() const { return patchesDrawn * PATCH_GRID * PATCH_GRID * 2; }
+    int getLodCount() const { return lodCount; }
+
+private:
+    static constexpr int PATCH_GRID = 32;   // Quads pro Patch-Seite
+    static constexpr int MAX_LODS = 12;
+    static constexpr int HEIGHT_TEXTURE_UNIT = 9;
+
+    // Höhendaten (CPU für Quadtree-Bounds, GPU für Displacement)
+    int width = 0, height = 0;
+    std::vector<float> heights;
+    unsigned int heightTexture = 0;
+    float fillHeight = 0.0f; // Ersatz für Texel ohne Terrain (TerrainQuery::NO_HEIGHT)
+
+    glm::vec2 worldMin = glm::vec2(0.0f);
+    glm::vec2 worldSize = glm::vec2(1.0f);
+
+    // Min/Max-Höhen pro Quadtree-Knoten, eine Ebene pro LOD (Ebene 0 = feinste Knoten)
+    int lodCount = 0;
+    std::vector<std::vector<glm::vec2>> nodeMinMax;
+    float lodRanges[MAX_LODS] = {};
+
+    // Grid-Patch (wiederverwendet für alle Knoten) + Instanz-Daten (offset.xy, size, lod)
+    unsigned int VAO = 0, VBO = 0, EBO = 0, instanceVBO = 0;
+    unsigned int patchIndexCount = 0;
+    std::vector<glm::vec4> selection;
+    int patchesDrawn = 0;
+
+    void init(const std::vector<float>& data, int w, int h);
+    void buildMinMaxTree();
+    // Min/Max der Blatt-Knoten in [nx0, nx1] x [nz0, nz1] neu, dann die Eltern bis zur Wurzel
+    void updateMinMaxTree(int nx0, int nz0, int nx1, int nz1);
+    glm::vec2 computeLeafMinMax(int nx, int nz, int leafNodes) const;
+    glm::vec2 combineChildren(int lod, int nx, int nz) const;
+    void createPatchMesh();
+
+    // Rekursive CDLOD-Auswahl, false = Knoten liegt außerhalb der Reichweite dieser LOD-Stufe
+    bool selectNode(int lod, int nx, int nz, const Frustum& frustum, const glm::vec3& camPos);
+    void getNodeBounds(int lod, int nx, int nz, glm::vec3& bMin, glm::vec3& bMax) const;
+};
@@ -79,29 +79,50 @@ void InputManager::onResize(int width, int height) {
     camera.setViewportSize((float)width, (float)height);
 }
 
+glm::vec3 InputManager::getMouseRay() const {
+    double xpos, ypos;
+    glfwGetCursorPos(window, &xpos, &ypos);
+
+    int width, height;
+    glfwGetWindowSize(window, &width, &height);
+
+    // Raycast Berechnung
+    float x = (2.0f * (float)xpos) / width - 1.0f;
+    float y = 1.0f - (2.0f * (float)ypos) / height;
+    glm::vec4 ray_clip = glm::vec4(x, y, -1.0, 1.0);
+
+    glm::mat4 proj = glm::perspective(glm::radians(camera.getFov()), (float)width / (float)height, 0.1f, 1000.0f);
+    glm::vec4 ray_eye = glm::inverse(proj) * ray_clip;
+    ray_eye = glm::vec4(ray_eye.x, ray_eye.y, -1.0, 0.0);
+
+    glm::vec3 ray_wor = glm::vec3(glm::inverse(camera.getViewMatrix()) * ray_eye);
+    return glm::normalize(ray_wor);
+}
+
+bool InputManager::getTerrainCursor(glm::vec3& outPosition) const {
+    if (!terrainBVH) return false;
+    TerrainRayHit hit = terrainBVH->raycast(camera.getPosition(), getMouseRay());
+    if (hit.hit) outPosition = hit.position;
+    return hit.hit;
+}
+
 void InputManager::onMouseClick(int button, int action, int mods) {
     if (button == GLFW_MOUSE_BUTTON_LEFT && action == GLFW_PRESS) {
         // UI Blockt Raycast (für Gizmos)
         if (ui.isMouseCaptured()) return;
+        if (terrainEditing) return;
 
         if (menuMode) {
-            double xpos, ypos;
-            glfwGetCursorPos(window, &xpos, &ypos);
-
-            int width, height;
-            glfwGetWindowSize(window, &width, &height);
-
-            // Raycast Berechnung
-            float x = (2.0f * (float)xpos) / width - 1.0f;
-            float y = 1.0f - (2.0f * (float)ypos) / height;
-            glm::vec4 ray_clip = glm::vec4(x, y, -1.0, 1.0);
-
-            glm::mat4 proj = glm::perspective(glm::radians(camera.getFov()), (float)width / (float)height, 0.1f, 1000.0f);
-            glm::vec4 ray_eye = glm::inverse(proj) * ray_clip;
-            ray_eye = glm::vec4(ray_eye.x, ray_eye.y, -1.0, 0.0);
-
-            glm::vec3 ray_wor = glm::vec3(glm::inverse(camera.getViewMatrix()) * ray_eye);
-            ray_wor = glm::normalize(ray_wor);
+            glm::vec3 ray_wor = getMouseRay();
+
+            // Strg + Klick: ausgewähltes Objekt auf das Terrain setzen
+            if ((mods & GLFW_MOD_CONTROL) && terrainBVH && sceneManager.selectedObjectID >= 0) {
+                TerrainRayHit hit = terrainBVH->raycast(camera.getPosition(), ray_wor);
+                auto& objects = sceneManager.getObjects();
+                if (hit.hit && sceneManager.selectedObjectID < (int)objects.size())
+                    objects[sceneManager.selectedObjectID].position = hit.position;
+                return;
+            }
 
             // Objekt suchen
             int hitIndex = sceneManager.getClosestObjectFromRay(camera.getPosition(), ray_wor);
@@ -4,6 +4,7 @@
 #include "Camera.h"
 #include "UIManager.h"
 #include "SceneManager.h" // Wichtig
+#include "TerrainBVH.h"
 
 class InputManager {
 public:
@@ -12,11 +13,23 @@ public:
     void processInput(float deltaTime);
     bool isMenuMode() const { return menuMode; }
 
+    // Terrain-Picking: Strg + Linksklick setzt das ausgewählte Objekt auf den Terrain-Treffer
+    void setTerrainBVH(const TerrainBVH* bvh) { terrainBVH = bvh; }
+
+    // Terrain-Editor aktiv: Linksklick wählt keine Objekte mehr aus (der Pinsel läuft in main.cpp)
+    void setTerrainEditing(bool enabled) { terrainEditing = enabled; }
+
+    // Terrain-Punkt unter dem Mauszeiger (BVH-Raycast), false wenn kein Treffer
+    bool getTerrainCursor(glm::vec3& outPosition) const;
+    glm::vec3 getMouseRay() const;
+
 private:
     GLFWwindow* window;
     Camera& camera;
     UIManager& ui;
     SceneManager& sceneManager; // Referenz auf SceneManager
+    const TerrainBVH* terrainBVH = nullptr;
+    bool terrainEditing = false;
 
     bool menuMode = false;
     bool lastAltState = false;
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+// Einfache parallele Schleife über [begin, end).
+// Der Bereich wird in gleich große Blöcke aufgeteilt, ein Block pro Hardware-Thread.
+// func(i) muss für verschiedene i unabhängig sein.
+template <typename Func>
+void parallelFor(int begin, int end, Func func) {
+    int count = end - begin;
+    if (count <= 0) return;
+
+    int threadCount = (int)std::max(1u, std::thread::hardware_concurrency());
+    threadCount = std::min(threadCount, count);
+    if (threadCount == 1) {
+        for (int i = begin; i < end; i++) func(i);
+        return;
+    }
+
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount);
+    int blockSize = (count + threadCount - 1) / threadCount;
+    for (int t = 0; t < threadCount; t++) {
+        int blockBegin = begin + t * blockSize;
+        int blockEnd = std::min(end, blockBegin + blockSize);
+        if (blockBegin >= blockEnd) break;
+        threads.emplace_back([=, &func]() {
+            for (int i = blockBegin; i < blockEnd; i++) func(i);
+        });
+    }
+    for (auto& t : threads) t.join();
+}
@@ -14,7 +14,8 @@ class Shader
 public:
     unsigned int ID;
 
-    Shader(const char* vertexPath, const char* fragmentPath)
+    // defines: zusätzliche Zeilen (z.B. "#define X 1\n"), werden direkt nach #version eingefügt
+    Shader(const char* vertexPath, const char* fragmentPath, const std::string& defines = "")
     {
         // 1. Retrieve the vertex/fragment source code from filePath
         std::string vertexCode;
@@ -36,8 +37,8 @@ public:
             vShaderFile.close();
             fShaderFile.close();
 
-            vertexCode = vShaderStream.str();
-            fragmentCode = fShaderStream.str();
+            vertexCode = injectDefines(vShaderStream.str(), defines);
+            fragmentCode = injectDefines(fShaderStream.str(), defines);
         }
         catch (std::ifstream::failure& e)
         {
@@ -128,6 +129,15 @@ public:
     }
 
 private:
+    // Shader-Varianten: Defines hinter die #version-Zeile setzen (die muss die erste Zeile bleiben)
+    static std::string injectDefines(const std::string& code, const std::string& defines)
+    {
+        if (defines.empty()) return code;
+        size_t lineEnd = code.find('\n');
+        if (code.compare(0, 8, "#version") != 0 || lineEnd == std::string::npos) return defines + code;
+        return code.substr(0, lineEnd + 1) + defines + code.substr(lineEnd + 1);
+    }
+
     void checkCompileErrors(unsigned int shader, std::string type)
     {
         int success;
@@ -1,85 +1,704 @@
 #include "Terrain.h"
+#include "TerrainQuery.h"
+#include "TerrainCache.h"
+#include "Parallel.h"
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
 #include <stb_image.h>
+#include <glm/gtc/packing.hpp>
 #include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
 
-Terrain::Terrain(const std::string& modelPath) {
-    loadModel(modelPath);
+// Import-Flags sind Teil des Cache-Schlüssels (andere Flags -> andere Normalen/Tangenten)
+static const unsigned int IMPORT_FLAGS = aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_GenSmoothNormals | aiProcess_CalcTangentSpace;
+
+// Kleine Daten, die neben den Buffern im Cache liegen
+struct CachedTerrainInfo {
+    glm::vec3 tangentHint;
+    uint32_t triangleCount;
+};
+
+Terrain::Terrain(const std::string& modelPath, TerrainCache* cache) {
+    if (!cache || !loadFromCache(*cache)) loadModel(modelPath, cache);
+    loadMaterials();
+}
+
+Terrain::Terrain(std::vector<float> vertices, std::vector<unsigned int> indices) {
+    buildFromGeometry(std::move(vertices), std::move(indices), nullptr);
     loadMaterials();
 }
 
+std::string Terrain::cacheSignature() {
+    return "flags=" + std::to_string(IMPORT_FLAGS) + " chunks=" + std::to_string(CHUNK_GRID) +
+           " vertex=" + std::to_string(sizeof(TerrainVertex));
+}
+
 Terrain::~Terrain() {
     glDeleteVertexArrays(1, &VAO);
     glDeleteBuffers(1, &VBO);
     glDeleteBuffers(1, &EBO);
+    glDeleteTextures(1, &chunkBoundsTexture);
+    glDeleteTextures(1, &splatTexture);
+    glDeleteTextures(1, &albedoArray);
+    glDeleteTextures(1, &normalArray);
+    glDeleteTextures(1, &armArray);
+    for (Shader* shader : shaders) delete shader;
+}
+
+void Terrain::loadShaders(const std::string& vertexPath, const std::string& fragmentPath) {
+    // Ebenen-Maske pro Klasse: Bit 0 = pebbles, Bit 1 = ground, Bit 2 = rock
+    const int layerMasks[TERRAIN_MATERIAL_CLASS_COUNT] = { 2, 6, 3, 7 };
+    for (int c = 0; c < TERRAIN_MATERIAL_CLASS_COUNT; c++) {
+        std::string defines = "#define TERRAIN_LAYERS " + std::to_string(layerMasks[c]) + "\n";
+        shaders.push_back(new Shader(vertexPath.c_str(), fragmentPath.c_str(), defines));
+        applyStaticUniforms(*shaders.back());
+    }
+}
+
+void Terrain::applyStaticUniforms(Shader& shader) const {
+    shader.use();
+    shader.setInt("albedoArray", 0); shader.setInt("normalArray", 1); shader.setInt("armArray", 2);
+    // Alle 2D-Sampler fest auf eigene Units, sonst teilen sie sich Unit 0 mit den Arrays (GL_INVALID_OPERATION)
+    shader.setInt("heightMap", 9); // HeightmapTerrain
+    shader.setInt("chunkBounds", CHUNK_BOUNDS_UNIT);
+    shader.setInt("splatMap", SPLAT_MAP_UNIT);
+    shader.setInt("vtPageTable", 12); shader.setInt("vtPhysical", 13); // VirtualTexture
+    shader.setVec3("tangentHint", tangentHint);
+    shader.setVec2("splatWorldMin", splatWorldMin);
+    shader.setVec2("splatWorldSize", splatWorldSize);
+}
+
+void Terrain::releaseGeometry() {
+    std::vector<float>().swap(m_vertices);
+    std::vector<unsigned int>().swap(m_indices);
 }
 
 void Terrain::loadMaterials() {
     std::string root = "../assets/terrain/";
-
     std::string p1 = root + "ganges_river_pebbles_2k.gltf/textures/";
-    matPebbles.albedo = loadTexture((p1 + "ganges_river_pebbles_diff_2k.jpg").c_str());
-    matPebbles.normal = loadTexture((p1 + "ganges_river_pebbles_nor_gl_2k.jpg").c_str());
-    matPebbles.arm    = loadTexture((p1 + "ganges_river_pebbles_arm_2k.jpg").c_str());
-
     std::string p2 = root + "rocky_terrain_02_2k.gltf/textures/";
-    matGround.albedo = loadTexture((p2 + "rocky_terrain_02_diff_2k.jpg").c_str());
-    matGround.normal = loadTexture((p2 + "rocky_terrain_02_nor_gl_2k.jpg").c_str());
-    matGround.arm    = loadTexture((p2 + "rocky_terrain_02_arm_2k.jpg").c_str());
-
     std::string p3 = root + "rocky_terrain_2k.gltf/textures/";
-    matRock.albedo = loadTexture((p3 + "rocky_terrain_diff_2k.jpg").c_str());
-    matRock.normal = loadTexture((p3 + "rocky_terrain_nor_gl_2k.jpg").c_str());
-    matRock.arm    = loadTexture((p3 + "rocky_terrain_arm_2k.jpg").c_str());
+
+    // Reihenfolge = Ebene im Array (muss zu den Splat-Kanälen im terrain.fs.glsl passen)
+    materials = {
+        { p1 + "ganges_river_pebbles_diff_2k.jpg", p1 + "ganges_river_pebbles_nor_gl_2k.jpg", p1 + "ganges_river_pebbles_arm_2k.jpg" },
+        { p2 + "rocky_terrain_02_diff_2k.jpg",     p2 + "rocky_terrain_02_nor_gl_2k.jpg",     p2 + "rocky_terrain_02_arm_2k.jpg" },
+        { p3 + "rocky_terrain_diff_2k.jpg",        p3 + "rocky_terrain_nor_gl_2k.jpg",        p3 + "rocky_terrain_arm_2k.jpg" }
+    };
+
+    std::vector<std::string> albedoPaths, normalPaths, armPaths;
+    for (const auto& m : materials) {
+        albedoPaths.push_back(m.albedo);
+        normalPaths.push_back(m.normal);
+        armPaths.push_back(m.arm);
+    }
+    albedoArray = loadTextureArray(albedoPaths);
+    normalArray = loadTextureArray(normalPaths);
+    armArray    = loadTextureArray(armPaths);
 }
 
-void Terrain::draw(Shader& shader) {
-    glActiveTexture(GL_TEXTURE0); glBindTexture(GL_TEXTURE_2D, matPebbles.albedo);
-    glActiveTexture(GL_TEXTURE1); glBindTexture(GL_TEXTURE_2D, matPebbles.normal);
-    glActiveTexture(GL_TEXTURE2); glBindTexture(GL_TEXTURE_2D, matPebbles.arm);
+void Terrain::draw(const glm::mat4& mvp) {
+    // 1. Sichtbare Chunks sammeln, nach Material-Klasse getrennt
+    Frustum frustum(mvp);
+    for (int c = 0; c < TERRAIN_MATERIAL_CLASS_COUNT; c++) {
+        drawCounts[c].clear();
+        drawOffsets[c].clear();
+    }
+    stats.chunksVisible = 0;
+    stats.trianglesDrawn = 0;
 
-    glActiveTexture(GL_TEXTURE3); glBindTexture(GL_TEXTURE_2D, matGround.albedo);
-    glActiveTexture(GL_TEXTURE4); glBindTexture(GL_TEXTURE_2D, matGround.normal);
-    glActiveTexture(GL_TEXTURE5); glBindTexture(GL_TEXTURE_2D, matGround.arm);
+    for (const auto& chunk : chunks) {
+        if (!frustum.isBoxVisible(chunk.boundsMin, chunk.boundsMax)) continue;
+        int c = (int)chunk.materialClass;
+        drawCounts[c].push_back((GLsizei)chunk.indexCount);
+        drawOffsets[c].push_back((const void*)(chunk.indexOffset * sizeof(unsigned int)));
+        stats.chunksVisible++;
+        stats.trianglesDrawn += chunk.indexCount / 3;
+    }
+    if (stats.chunksVisible == 0) return;
 
-    glActiveTexture(GL_TEXTURE6); glBindTexture(GL_TEXTURE_2D, matRock.albedo);
-    glActiveTexture(GL_TEXTURE7); glBindTexture(GL_TEXTURE_2D, matRock.normal);
-    glActiveTexture(GL_TEXTURE8); glBindTexture(GL_TEXTURE_2D, matRock.arm);
+    // 2. Texturen binden
+    bindMaterials();
+    glActiveTexture(GL_TEXTURE0 + CHUNK_BOUNDS_UNIT); glBindTexture(GL_TEXTURE_2D, chunkBoundsTexture);
 
+    // 3. Ein Aufruf pro Shader-Variante
     glBindVertexArray(VAO);
-    glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, 0);
+    for (int c = 0; c < TERRAIN_MATERIAL_CLASS_COUNT; c++) {
+        if (drawCounts[c].empty()) continue;
+        shaders[c]->use();
+        glMultiDrawElements(GL_TRIANGLES, drawCounts[c].data(), GL_UNSIGNED_INT, drawOffsets[c].data(), (GLsizei)drawCounts[c].size());
+    }
     glBindVertexArray(0);
 
     glActiveTexture(GL_TEXTURE0);
 }
 
-unsigned int Terrain::loadTexture(const char* path) {
+void Terrain::drawGeometry(Shader& shader, const glm::mat4& mvp) {
+    Frustum frustum(mvp);
+    std::vector<GLsizei> counts;
+    std::vector<const void*> offsets;
+    for (const auto& chunk : chunks) {
+        if (!frustum.isBoxVisible(chunk.boundsMin, chunk.boundsMax)) continue;
+        counts.push_back((GLsizei)chunk.indexCount);
+        offsets.push_back((const void*)(chunk.indexOffset * sizeof(unsigned int)));
+    }
+    if (counts.empty()) return;
+
+    applyStaticUniforms(shader);
+    shader.setBool("useHeightmap", false);
+    glActiveTexture(GL_TEXTURE0 + CHUNK_BOUNDS_UNIT); glBindTexture(GL_TEXTURE_2D, chunkBoundsTexture);
+    glActiveTexture(GL_TEXTURE0);
+
+    glBindVertexArray(VAO);
+    glMultiDrawElements(GL_TRIANGLES, counts.data(), GL_UNSIGNED_INT, offsets.data(), (GLsizei)counts.size());
+    glBindVertexArray(0);
+}
+
+// Material-Arrays auf Unit 0-2 (auch vom Heightmap-Terrain genutzt)
+void Terrain::bindMaterials() const {
+    glActiveTexture(GL_TEXTURE0 + SPLAT_MAP_UNIT); glBindTexture(GL_TEXTURE_2D, splatTexture);
+    glActiveTexture(GL_TEXTURE0); glBindTexture(GL_TEXTURE_2D_ARRAY, albedoArray);
+    glActiveTexture(GL_TEXTURE1); glBindTexture(GL_TEXTURE_2D_ARRAY, normalArray);
+    glActiveTexture(GL_TEXTURE2); glBindTexture(GL_TEXTURE_2D_ARRAY, armArray);
+}
+
+// --- SPLAT MAP ---
+// Gleiche Gewichte wie bisher im terrain.fs.glsl, aber einmal beim Laden statt pro Fragment.
+void Terrain::bakeSplatMap(const TerrainQuery& query, TerrainCache* cache) {
+    int res = query.getRasterResolution();
+    const std::vector<float>& heights = query.getRasterHeights();
+    const std::vector<glm::vec3>& normals = query.getRasterNormals();
+
+    std::vector<unsigned char> weights;
+    if (cache && cache->isLoaded() && cache->get(TerrainCacheSection::SplatWeights, weights) &&
+        weights.size() == (size_t)res * res * 4) {
+        std::cout << "Terrain: Splat Map aus dem Cache." << std::endl;
+    } else {
+        weights.assign((size_t)res * res * 4, 0);
+        parallelFor(0, res, [&](int z) {
+            for (int x = 0; x < res; x++) {
+                size_t i = (size_t)z * res + x;
+                // Kein Terrain an diesem Texel -> Boden
+                glm::vec3 w(0.0f, 1.0f, 0.0f);
+                if (heights[i] > TerrainQuery::NO_HEIGHT) w = TerrainQuery::computeMaterialWeights(heights[i], normals[i].y);
+                weights[i * 4 + 0] = (unsigned char)(w.x * 255.0f + 0.5f);
+                weights[i * 4 + 1] = (unsigned char)(w.y * 255.0f + 0.5f);
+                weights[i * 4 + 2] = (unsigned char)(w.z * 255.0f + 0.5f);
+                weights[i * 4 + 3] = 255;
+            }
+        });
+        std::cout << "Terrain: Splat Map gebacken (" << res << "x" << res << ")." << std::endl;
+        if (cache) cache->put(TerrainCacheSection::SplatWeights, weights);
+    }
+
+    splatWorldMin = glm::vec2(query.getMinX(), query.getMinZ());
+    splatWorldSize = glm::vec2(query.getMaxX() - query.getMinX(), query.getMaxZ() - query.getMinZ());
+
+    glGenTextures(1, &splatTexture);
+    glBindTexture(GL_TEXTURE_2D, splatTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, res, res, 0, GL_RGBA, GL_UNSIGNED_BYTE, weights.data());
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    classifyChunks(weights, res, query.getScale());
+    for (Shader* shader : shaders) applyStaticUniforms(*shader);
+
+    splatWeights.swap(weights);
+    splatResolution = res;
+}
+
+// Ein Material zählt für einen Chunk, sobald irgendein Splat-Texel unter ihm über SPLAT_EPSILON liegt.
+// Bilineare Filterung kann den Wert nicht über das Maximum der Nachbar-Texel heben, daher reicht 1 Texel Rand.
+void Terrain::classifyChunks(const std::vector<unsigned char>& weights, int res, float scale) {
+    int classCount[TERRAIN_MATERIAL_CLASS_COUNT] = {};
+    for (auto& chunk : chunks) {
+        chunk.materialClass = classifyChunk(chunk, weights, res, scale);
+        classCount[(int)chunk.materialClass]++;
+    }
+
+    std::cout << "Terrain: Chunk-Klassen Ground " << classCount[0] << ", GroundRock " << classCount[1]
+              << ", Shore " << classCount[2] << ", All " << classCount[3] << "." << std::endl;
+}
+
+TerrainMaterialClass Terrain::classifyChunk(const TerrainChunk& chunk, const std::vector<unsigned char>& weights, int res, float scale) const {
+    float stepX = splatWorldSize.x / (float)(res - 1);
+    float stepZ = splatWorldSize.y / (float)(res - 1);
+    float threshold = SPLAT_EPSILON * 255.0f;
+
+    int x0 = std::clamp((int)std::floor((chunk.boundsMin.x * scale - splatWorldMin.x) / stepX) - 1, 0, res - 1);
+    int x1 = std::clamp((int)std::ceil ((chunk.boundsMax.x * scale - splatWorldMin.x) / stepX) + 1, 0, res - 1);
+    int z0 = std::clamp((int)std::floor((chunk.boundsMin.z * scale - splatWorldMin.y) / stepZ) - 1, 0, res - 1);
+    int z1 = std::clamp((int)std::ceil ((chunk.boundsMax.z * scale - splatWorldMin.y) / stepZ) + 1, 0, res - 1);
+
+    int mask = 0;
+    for (int z = z0; z <= z1; z++) {
+        for (int x = x0; x <= x1; x++) {
+            const unsigned char* w = &weights[((size_t)z * res + x) * 4];
+            if (w[0] >= threshold) mask |= 1;
+            if (w[1] >= threshold) mask |= 2;
+            if (w[2] >= threshold) mask |= 4;
+        }
+    }
+
+    if ((mask & 5) == 0) return TerrainMaterialClass::Ground;
+    if ((mask & 1) == 0) return TerrainMaterialClass::GroundRock;
+    if ((mask & 4) == 0) return TerrainMaterialClass::Shore;
+    return TerrainMaterialClass::All;
+}
+
+// --- VIRTUAL TEXTURE GENERATOR ---
+static void downsampleAlbedo(const std::vector<unsigned char>& src, int w, int h,
+                             std::vector<unsigned char>& dst, int& outW, int& outH) {
+    outW = std::max(1, w / 2);
+    outH = std::max(1, h / 2);
+    dst.assign((size_t)outW * outH * 4, 0);
+    for (int y = 0; y < outH; y++) {
+        for (int x = 0; x < outW; x++) {
+            int x0 = std::min(x * 2, w - 1), x1 = std::min(x * 2 + 1, w - 1);
+            int y0 = std::min(y * 2, h - 1), y1 = std::min(y * 2 + 1, h - 1);
+            for (int c = 0; c < 4; c++) {
+                int sum = src[((size_t)y0 * w + x0) * 4 + c] + src[((size_t)y0 * w + x1) * 4 + c]
+                        + src[((size_t)y1 * w + x0) * 4 + c] + src[((size_t)y1 * w + x1) * 4 + c];
+                dst[((size_t)y * outW + x) * 4 + c] = (unsigned char)((sum + 2) / 4);
+            }
+        }
+    }
+}
+
+void Terrain::prepareAlbedoComposer(float tiling) {
+    if (!albedoMips.empty()) return;
+    composerTiling = tiling;
+
+    albedoMips.resize(materials.size());
+    for (size_t layer = 0; layer < materials.size(); layer++) {
+        AlbedoMip base;
+        int n;
+        unsigned char* data = stbi_load(materials[layer].albedo.c_str(), &base.width, &base.height, &n, 4);
+        if (data) {
+            base.rgba.assign(data, data + (size_t)base.width * base.height * 4);
+            stbi_image_free(data);
+        } else {
+            std::cout << "Texture failed to load: " << materials[layer].albedo << std::endl;
+            base.width = base.height = 1;
+            base.rgba = { 128, 128, 128, 255 };
+        }
+
+        // Die virtuelle Auflösung liegt unter der Material-Auflösung, Stufe 0 reicht mit 1024²
+        while (base.width > 1024 || base.height > 1024) {
+            AlbedoMip half;
+            downsampleAlbedo(base.rgba, base.width, base.height, half.rgba, half.width, half.height);
+            base = std::move(half);
+        }
+
+        albedoMips[layer].push_back(std::move(base));
+        while (albedoMips[layer].back().width > 1 || albedoMips[layer].back().height > 1) {
+            const AlbedoMip& prev = albedoMips[layer].back();
+            AlbedoMip next;
+            downsampleAlbedo(prev.rgba, prev.width, prev.height, next.rgba, next.width, next.height);
+            albedoMips[layer].push_back(std::move(next));
+        }
+    }
+    std::cout << "Terrain: Albedo-Generator für Virtual Texturing bereit." << std::endl;
+}
+
+// Bilinear mit Wiederholung (wie GL_REPEAT)
+static glm::vec3 sampleRepeat(const std::vector<unsigned char>& rgba, int w, int h, glm::vec2 uv) {
+    float fx = uv.x * w - 0.5f, fy = uv.y * h - 0.5f;
+    int x0 = (int)std::floor(fx), y0 = (int)std::floor(fy);
+    float tx = fx - x0, ty = fy - y0;
+    auto texel = [&](int x, int y) {
+        x = ((x % w) + w) % w;
+        y = ((y % h) + h) % h;
+        const unsigned char* p = &rgba[((size_t)y * w + x) * 4];
+        return glm::vec3(p[0], p[1], p[2]);
+    };
+    glm::vec3 top = texel(x0, y0) * (1.0f - tx) + texel(x0 + 1, y0) * tx;
+    glm::vec3 bottom = texel(x0, y0 + 1) * (1.0f - tx) + texel(x0 + 1, y0 + 1) * tx;
+    return top * (1.0f - ty) + bottom * ty;
+}
+
+void Terrain::composeAlbedo(const glm::vec2& regionMin, const glm::vec2& regionSize, int size, unsigned char* out) const {
+    // Mip pro Ebene passend zur Texel-Größe der Page wählen
+    glm::vec2 texelWorld = regionSize / (float)size;
+    int res = splatResolution;
+    auto splatCoord = [&](float uv) { return std::clamp(uv, 0.0f, 1.0f) * (res - 1); };
+
+    // Nur den Splat-Ausschnitt unter der Page unter der Sperre kopieren, der Editor (applyEdit) wartet sonst
+    // auf die ganze Komposition
+    std::vector<unsigned char> splat;
+    int rectX0, rectZ0, rectWidth;
+    {
+        std::lock_guard<std::mutex> lock(splatMutex);
+        if (albedoMips.empty() || splatWeights.empty()) return;
+        glm::vec2 uvMin = (regionMin + 0.5f * texelWorld - splatWorldMin) / splatWorldSize;
+        glm::vec2 uvMax = (regionMin + ((float)size - 0.5f) * texelWorld - splatWorldMin) / splatWorldSize;
+        rectX0 = std::min((int)splatCoord(uvMin.x), res - 2);
+        rectZ0 = std::min((int)splatCoord(uvMin.y), res - 2);
+        int rectX1 = std::min((int)splatCoord(uvMax.x), res - 2) + 1;
+        int rectZ1 = std::min((int)splatCoord(uvMax.y), res - 2) + 1;
+        rectWidth = rectX1 - rectX0 + 1;
+        splat.resize((size_t)rectWidth * (rectZ1 - rectZ0 + 1) * 4);
+        for (int z = rectZ0; z <= rectZ1; z++) {
+            const unsigned char* row = &splatWeights[((size_t)z * res + rectX0) * 4];
+            std::copy(row, row + (size_t)rectWidth * 4, &splat[(size_t)(z - rectZ0) * rectWidth * 4]);
+        }
+    }
+
+    std::vector<int> levels(albedoMips.size());
+    for (size_t layer = 0; layer < albedoMips.size(); layer++) {
+        float materialTexel = splatWorldSize.x / composerTiling / (float)albedoMips[layer][0].width;
+        int level = (int)std::floor(std::log2(std::max(texelWorld.x / materialTexel, 1.0f)) + 0.5f);
+        levels[layer] = std::clamp(level, 0, (int)albedoMips[layer].size() - 1);
+    }
+
+    float threshold = SPLAT_EPSILON * 255.0f;
+    for (int j = 0; j < size; j++) {
+        for (int i = 0; i < size; i++) {
+            glm::vec2 p = regionMin + glm::vec2(i + 0.5f, j + 0.5f) * texelWorld;
+            glm::vec2 uvw = (p - splatWorldMin) / splatWorldSize;
+
+            // Splat bilinear (Texel liegen auf den Rändern, wie im Shader)
+            float fx = splatCoord(uvw.x), fz = splatCoord(uvw.y);
+            int x0 = std::min((int)fx, res - 2), z0 = std::min((int)fz, res - 2);
+            float tx = fx - x0, tz = fz - z0;
+            x0 -= rectX0; z0 -= rectZ0;
+
+            glm::vec3 color(0.0f);
+            float total = 0.0f;
+            float layerWeights[3];
+            for (int c = 0; c < 3; c++) {
+                auto w = [&](int x, int z) { return (float)splat[((size_t)z * rectWidth + x) * 4 + c]; };
+                float v = (w(x0, z0) * (1.0f - tx) + w(x0 + 1, z0) * tx) * (1.0f - tz)
+                        + (w(x0, z0 + 1) * (1.0f - tx) + w(x0 + 1, z0 + 1) * tx) * tz;
+                layerWeights[c] = (v >= threshold) ? v : 0.0f;
+                total += layerWeights[c];
+            }
+            for (size_t layer = 0; layer < albedoMips.size() && layer < 3; layer++) {
+                if (layerWeights[layer] <= 0.0f) continue;
+                const AlbedoMip& m = albedoMips[layer][levels[layer]];
+                color += sampleRepeat(m.rgba, m.width, m.height, uvw * composerTiling) * (layerWeights[layer] / std::max(total, 1e-4f));
+            }
+
+            unsigned char* o = &out[((size_t)j * size + i) * 4];
+            o[0] = (unsigned char)std::clamp(color.r + 0.5f, 0.0f, 255.0f);
+            o[1] = (unsigned char)std::clamp(color.g + 0.5f, 0.0f, 255.0f);
+            o[2] = (unsigned char)std::clamp(color.b + 0.5f, 0.0f, 255.0f);
+            o[3] = 255;
+        }
+    }
+}
+
+// --- EDITOR ---
+// Liest VBO + EBO einmalig zurück und baut die Zuordnung kompakter Vertex <-> Vertex im TerrainQuery.
+// Die Index-Reihenfolge ist in beiden gleich (beide kommen aus den nach Chunks sortierten Indizes).
+void Terrain::beginEditing(const TerrainQuery& query) {
+    GLint vboSize = 0;
+    glBindBuffer(GL_COPY_READ_BUFFER, VBO);
+    glGetBufferParameteriv(GL_COPY_READ_BUFFER, GL_BUFFER_SIZE, &vboSize);
+    editVertices.resize(vboSize / sizeof(TerrainVertex));
+    glGetBufferSubData(GL_COPY_READ_BUFFER, 0, editVertices.size() * sizeof(TerrainVertex), editVertices.data());
+
+    std::vector<unsigned int> compactIndices(indexCount);
+    glBindBuffer(GL_COPY_READ_BUFFER, EBO);
+    glGetBufferSubData(GL_COPY_READ_BUFFER, 0, compactIndices.size() * sizeof(unsigned int), compactIndices.data());
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+
+    const std::vector<unsigned int>& sourceIndices = query.getIndices();
+    size_t sourceCount = query.getPositions().size();
+    editSource.assign(editVertices.size(), 0);
+    for (size_t i = 0; i < compactIndices.size() && i < sourceIndices.size(); i++) editSource[compactIndices[i]] = sourceIndices[i];
+
+    // Kopien pro Quell-Vertex (CSR)
+    editCopyOffsets.assign(sourceCount + 1, 0);
+    for (unsigned int src : editSource) editCopyOffsets[src + 1]++;
+    for (size_t v = 0; v < sourceCount; v++) editCopyOffsets[v + 1] += editCopyOffsets[v];
+    editCopies.resize(editSource.size());
+    std::vector<unsigned int> cursor(editCopyOffsets.begin(), editCopyOffsets.end() - 1);
+    for (size_t c = 0; c < editSource.size(); c++) editCopies[cursor[editSource[c]]++] = (unsigned int)c;
+
+    chunkFirstVertex.assign(chunks.size(), 0);
+    chunkVertexCount.assign(chunks.size(), 0);
+    for (size_t c = editVertices.size(); c-- > 0;) {
+        int chunk = editVertices[c].pos[3];
+        chunkFirstVertex[chunk] = (unsigned int)c;
+        chunkVertexCount[chunk]++;
+    }
+    std::cout << "Terrain: Editor-Daten vorbereitet (" << editVertices.size() << " Vertices)." << std::endl;
+}
+
+void Terrain::applyEdit(const TerrainQuery& query, const TerrainEdit& edit) {
+    if (edit.empty() || VBO == 0) return;
+    if (editVertices.empty()) beginEditing(query);
+
+    const std::vector<glm::vec3>& positions = query.getPositions();
+    const std::vector<glm::vec3>& normals = query.getNormals();
+    float scale = query.getScale();
+
+    // 1. Betroffene Chunks sammeln, Y-Bounds bei Bedarf vergrößern (XZ bleibt gleich)
+    std::vector<int> chunkLo(chunks.size(), -1), chunkHi(chunks.size(), -1);
+    std::vector<char> grown(chunks.size(), 0);
+    for (unsigned int v : edit.vertices) {
+        float y = positions[v].y / scale;
+        for (unsigned int a = editCopyOffsets[v]; a < editCopyOffsets[v + 1]; a++) {
+            int c = (int)editCopies[a];
+            int chunk = editVertices[c].pos[3];
+            TerrainChunk& ch = chunks[chunk];
+            if (y < ch.boundsMin.y) { ch.boundsMin.y = y; grown[chunk] = 1; }
+            if (y > ch.boundsMax.y) { ch.boundsMax.y = y; grown[chunk] = 1; }
+            chunkLo[chunk] = (chunkLo[chunk] < 0) ? c : std::min(chunkLo[chunk], c);
+            chunkHi[chunk] = std::max(chunkHi[chunk], c);
+        }
+    }
+
+    // 2. Pro Chunk EIN zusammenhängender Bereich neu kodieren + hochladen.
+    //    Sind die Bounds gewachsen, ändert sich die Quantisierung des ganzen Chunks.
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBindTexture(GL_TEXTURE_2D, chunkBoundsTexture);
+    for (size_t chunk = 0; chunk < chunks.size(); chunk++) {
+        if (chunkLo[chunk] < 0) continue;
+        const TerrainChunk& ch = chunks[chunk];
+        unsigned int lo = (unsigned int)chunkLo[chunk], hi = (unsigned int)chunkHi[chunk];
+        if (grown[chunk]) {
+            lo = chunkFirstVertex[chunk];
+            hi = lo + chunkVertexCount[chunk] - 1;
+            glm::vec4 bounds[2] = { glm::vec4(ch.boundsMin, 0.0f),
+                                    glm::vec4(glm::max(ch.boundsMax - ch.boundsMin, glm::vec3(1e-6f)), 0.0f) };
+            glTexSubImage2D(GL_TEXTURE_2D, 0, (GLint)chunk * 2, 0, 2, 1, GL_RGBA, GL_FLOAT, bounds);
+        }
+        for (unsigned int c = lo; c <= hi; c++) {
+            unsigned int src = editSource[c];
+            encodeVertex(editVertices[c], ch, positions[src] / scale, normals[src]);
+        }
+        glBufferSubData(GL_ARRAY_BUFFER, lo * sizeof(TerrainVertex), (hi - lo + 1) * sizeof(TerrainVertex), &editVertices[lo]);
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    // 3. Splat Map im Raster-Bereich neu backen, Chunks darunter neu klassifizieren
+    int res = splatResolution;
+    if (res == 0 || edit.rasterX1 < edit.rasterX0 || edit.rasterZ1 < edit.rasterZ0) return;
+    const std::vector<float>& heights = query.getRasterHeights();
+    const std::vector<glm::vec3>& rasterNormals = query.getRasterNormals();
+
+    std::lock_guard<std::mutex> lock(splatMutex);
+    for (int z = edit.rasterZ0; z <= edit.rasterZ1; z++) {
+        for (int x = edit.rasterX0; x <= edit.rasterX1; x++) {
+            size_t i = (size_t)z * res + x;
+            glm::vec3 w(0.0f, 1.0f, 0.0f);
+            if (heights[i] > TerrainQuery::NO_HEIGHT) w = TerrainQuery::computeMaterialWeights(heights[i], rasterNormals[i].y);
+            splatWeights[i * 4 + 0] = (unsigned char)(w.x * 255.0f + 0.5f);
+            splatWeights[i * 4 + 1] = (unsigned char)(w.y * 255.0f + 0.5f);
+            splatWeights[i * 4 + 2] = (unsigned char)(w.z * 255.0f + 0.5f);
+        }
+    }
+    glBindTexture(GL_TEXTURE_2D, splatTexture);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, res);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, edit.rasterX0, edit.rasterZ0,
+                    edit.rasterX1 - edit.rasterX0 + 1, edit.rasterZ1 - edit.rasterZ0 + 1, GL_RGBA, GL_UNSIGNED_BYTE,
+                    &splatWeights[((size_t)edit.rasterZ0 * res + edit.rasterX0) * 4]);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    glm::vec2 margin = 2.0f * splatWorldSize / (float)(res - 1);
+    glm::vec2 rMin = edit.regionMin - margin, rMax = edit.regionMax + margin;
+    for (auto& chunk : chunks) {
+        if (chunk.boundsMax.x * scale < rMin.x || chunk.boundsMin.x * scale > rMax.x ||
+            chunk.boundsMax.z * scale < rMin.y || chunk.boundsMin.z * scale > rMax.y) continue;
+        chunk.materialClass = classifyChunk(chunk, splatWeights, res, scale);
+    }
+}
+
+// --- CHUNKS AUFBAUEN ---
+// Sortiert die Dreiecke nach Chunk (Schwerpunkt in XZ) um, damit jeder Chunk
+// einen zusammenhängenden Index-Bereich hat, und berechnet die Bounding Boxes.
+void Terrain::buildChunks(const std::vector<float>& vertices, std::vector<unsigned int>& indices) {
+    float minX = 1e30f, maxX = -1e30f, minZ = 1e30f, maxZ = -1e30f;
+    for (size_t i = 0; i < vertices.size(); i += 11) {
+        minX = std::min(minX, vertices[i]);   maxX = std::max(maxX, vertices[i]);
+        minZ = std::min(minZ, vertices[i+2]); maxZ = std::max(maxZ, vertices[i+2]);
+    }
+    float chunkW = std::max((maxX - minX) / CHUNK_GRID, 1e-6f);
+    float chunkD = std::max((maxZ - minZ) / CHUNK_GRID, 1e-6f);
+
+    size_t triCount = indices.size() / 3;
+    std::vector<int> triChunk(triCount);
+    std::vector<unsigned int> chunkTriCount(CHUNK_GRID * CHUNK_GRID, 0);
+
+    for (size_t t = 0; t < triCount; t++) {
+        float cx = 0.0f, cz = 0.0f;
+        for (int k = 0; k < 3; k++) {
+            cx += vertices[indices[t*3+k] * 11];
+            cz += vertices[indices[t*3+k] * 11 + 2];
+        }
+        int gx = std::clamp((int)((cx / 3.0f - minX) / chunkW), 0, CHUNK_GRID - 1);
+        int gz = std::clamp((int)((cz / 3.0f - minZ) / chunkD), 0, CHUNK_GRID - 1);
+        triChunk[t] = gz * CHUNK_GRID + gx;
+        chunkTriCount[triChunk[t]]++;
+    }
+
+    // Offsets pro Chunk (Counting Sort)
+    chunks.clear();
+    std::vector<unsigned int> cursor(CHUNK_GRID * CHUNK_GRID);
+    unsigned int offset = 0;
+    for (int c = 0; c < CHUNK_GRID * CHUNK_GRID; c++) {
+        cursor[c] = offset;
+        offset += chunkTriCount[c] * 3;
+    }
+
+    std::vector<unsigned int> sorted(indices.size());
+    std::vector<glm::vec3> bMin(CHUNK_GRID * CHUNK_GRID, glm::vec3(1e30f));
+    std::vector<glm::vec3> bMax(CHUNK_GRID * CHUNK_GRID, glm::vec3(-1e30f));
+    for (size_t t = 0; t < triCount; t++) {
+        int c = triChunk[t];
+        for (int k = 0; k < 3; k++) {
+            unsigned int idx = indices[t*3+k];
+            sorted[cursor[c]++] = idx;
+            glm::vec3 p(vertices[idx*11], vertices[idx*11+1], vertices[idx*11+2]);
+            bMin[c] = glm::min(bMin[c], p);
+            bMax[c] = glm::max(bMax[c], p);
+        }
+    }
+    indices.swap(sorted);
+
+    offset = 0;
+    for (int c = 0; c < CHUNK_GRID * CHUNK_GRID; c++) {
+        unsigned int count = chunkTriCount[c] * 3;
+        if (count > 0) chunks.push_back({bMin[c], bMax[c], offset, count});
+        offset += count;
+    }
+
+    stats.chunksTotal = (int)chunks.size();
+    stats.trianglesTotal = (int)triCount;
+    std::cout << "Terrain: " << chunks.size() << " Chunks, " << triCount << " Dreiecke." << std::endl;
+}
+
+// --- KOMPAKTES VERTEX-FORMAT ---
+// Oktaeder-Kodierung mit Y als Hauptachse (Terrain-Normalen zeigen fast immer nach oben)
+static glm::vec2 octEncode(glm::vec3 n) {
+    n /= (std::abs(n.x) + std::abs(n.y) + std::abs(n.z));
+    glm::vec2 p(n.x, n.z);
+    if (n.y < 0.0f) {
+        p = glm::vec2((1.0f - std::abs(p.y)) * (p.x >= 0.0f ? 1.0f : -1.0f),
+                      (1.0f - std::abs(p.x)) * (p.y >= 0.0f ? 1.0f : -1.0f));
+    }
+    return p;
+}
+
+static uint16_t quantizeUnorm16(float v, float minV, float extent) {
+    float t = std::clamp((v - minV) / extent, 0.0f, 1.0f);
+    return (uint16_t)std::lround(t * 65535.0f);
+}
+
+// Position (Model-Space) relativ zu den Chunk-Bounds + Normale, UV und Chunk-Index bleiben
+void Terrain::encodeVertex(TerrainVertex& vertex, const TerrainChunk& chunk, const glm::vec3& position, const glm::vec3& normal) const {
+    glm::vec3 extent = glm::max(chunk.boundsMax - chunk.boundsMin, glm::vec3(1e-6f));
+    vertex.pos[0] = quantizeUnorm16(position.x, chunk.boundsMin.x, extent.x);
+    vertex.pos[1] = quantizeUnorm16(position.y, chunk.boundsMin.y, extent.y);
+    vertex.pos[2] = quantizeUnorm16(position.z, chunk.boundsMin.z, extent.z);
+    vertex.normal = glm::packSnorm2x16(octEncode(normal));
+}
+
+void Terrain::buildCompactVertices(const std::vector<float>& vertices, const std::vector<unsigned int>& indices,
+                                   std::vector<TerrainVertex>& outVertices, std::vector<unsigned int>& outIndices) {
+    size_t vertexCount = vertices.size() / 11;
+    std::vector<int> lastChunk(vertexCount, -1);
+    std::vector<unsigned int> localIndex(vertexCount, 0);
+
+    outVertices.clear();
+    outIndices.resize(indices.size());
+
+    glm::vec3 tangentSum(0.0f);
+    for (size_t c = 0; c < chunks.size(); c++) {
+        const TerrainChunk& chunk = chunks[c];
+        for (unsigned int i = chunk.indexOffset; i < chunk.indexOffset + chunk.indexCount; i++) {
+            unsigned int v = indices[i];
+            if (lastChunk[v] != (int)c) {
+                lastChunk[v] = (int)c;
+                localIndex[v] = (unsigned int)outVertices.size();
+
+                const float* src = &vertices[v * 11];
+                TerrainVertex tv;
+                encodeVertex(tv, chunk, glm::vec3(src[0], src[1], src[2]), glm::vec3(src[3], src[4], src[5]));
+                tv.pos[3] = (uint16_t)c;
+                tv.uv = (uint32_t)glm::packHalf1x16(src[6]) | ((uint32_t)glm::packHalf1x16(src[7]) << 16);
+                outVertices.push_back(tv);
+
+                tangentSum += glm::vec3(src[8], src[9], src[10]);
+            }
+            outIndices[i] = localIndex[v];
+        }
+    }
+
+    // Eine gemeinsame Tangenten-Richtung reicht: die UVs sind über das Terrain planar
+    if (glm::length(tangentSum) > 1e-6f) tangentHint = glm::normalize(tangentSum);
+
+    std::cout << "Terrain: " << outVertices.size() << " kompakte Vertices ("
+              << (outVertices.size() * sizeof(TerrainVertex)) / 1024 << " KB statt "
+              << (vertices.size() * sizeof(float)) / 1024 << " KB)." << std::endl;
+}
+
+// Chunk-Bounds als Textur (min, extent) für texelFetch im Vertex Shader
+void Terrain::createChunkBoundsTexture() {
+    std::vector<glm::vec4> bounds;
+    bounds.reserve(chunks.size() * 2);
+    for (const auto& chunk : chunks) {
+        bounds.push_back(glm::vec4(chunk.boundsMin, 0.0f));
+        bounds.push_back(glm::vec4(glm::max(chunk.boundsMax - chunk.boundsMin, glm::vec3(1e-6f)), 0.0f));
+    }
+    glGenTextures(1, &chunkBoundsTexture);
+    glBindTexture(GL_TEXTURE_2D, chunkBoundsTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, (GLsizei)bounds.size(), 1, 0, GL_RGBA, GL_FLOAT, bounds.data());
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+// Lädt alle Bilder als Ebenen eines GL_TEXTURE_2D_ARRAY (alle Ebenen müssen gleich groß sein)
+unsigned int Terrain::loadTextureArray(const std::vector<std::string>& paths) {
     unsigned int textureID;
     glGenTextures(1, &textureID);
-    int width, height, nrComponents;
-    unsigned char *data = stbi_load(path, &width, &height, &nrComponents, 0);
-    if (data) {
-        GLenum format = (nrComponents == 1) ? GL_RED : (nrComponents == 3 ? GL_RGB : GL_RGBA);
-        glBindTexture(GL_TEXTURE_2D, textureID);
-        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        stbi_image_free(data);
-    } else {
-        std::cout << "Texture failed to load: " << path << std::endl;
+    glBindTexture(GL_TEXTURE_2D_ARRAY, textureID);
+
+    int layerWidth = 0, layerHeight = 0;
+    for (size_t layer = 0; layer < paths.size(); layer++) {
+        int width, height, nrComponents;
+        unsigned char *data = stbi_load(paths[layer].c_str(), &width, &height, &nrComponents, 4);
+        if (!data) {
+            std::cout << "Texture failed to load: " << paths[layer] << std::endl;
+            continue;
+        }
+        if (layerWidth == 0) {
+            // Speicher für alle Ebenen mit der Größe des ersten Bildes anlegen
+            layerWidth = width; layerHeight = height;
+            glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, layerWidth, layerHeight, (GLsizei)paths.size(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        }
+        if (width != layerWidth || height != layerHeight) {
+            std::cout << "Texture size mismatch in array (" << width << "x" << height << " statt "
+                      << layerWidth << "x" << layerHeight << "): " << paths[layer] << std::endl;
+        } else {
+            glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, (GLint)layer, width, height, 1, GL_RGBA, GL_UNSIGNED_BYTE, data);
+        }
         stbi_image_free(data);
     }
+
+    if (layerWidth > 0) glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
     return textureID;
 }
 
-void Terrain::loadModel(const std::string& path) {
+void Terrain::loadModel(const std::string& path, TerrainCache* cache) {
     Assimp::Importer importer;
-    const aiScene* scene = importer.ReadFile(path, aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_GenSmoothNormals | aiProcess_CalcTangentSpace);
+    const aiScene* scene = importer.ReadFile(path, IMPORT_FLAGS);
     if(!scene || !scene->mRootNode) { std::cout << "ERROR::ASSIMP::" << importer.GetErrorString() << std::endl; return; }
 
     aiMesh* mesh = scene->mMeshes[0];
@@ -113,24 +732,78 @@ void Terrain::loadModel(const std::string& path) {
         aiFace face = mesh->mFaces[i];
         for(unsigned int j = 0; j < face.mNumIndices; j++) indices.push_back(face.mIndices[j]);
     }
+    buildFromGeometry(std::move(data), std::move(indices), cache);
+}
+
+// Gemeinsamer Weg für importierte und generierte Meshes (Float-Layout: pos3, normal3, uv2, tangent3)
+void Terrain::buildFromGeometry(std::vector<float> data, std::vector<unsigned int> indices, TerrainCache* cache) {
     indexCount = indices.size();
 
-    // WICHTIG: Daten persistent speichern für GrassSystem
+    // In räumliche Chunks aufteilen (sortiert die Indizes um)
+    buildChunks(data, indices);
+
+    // Daten für den TerrainQuery aufbewahren (wird danach mit releaseGeometry() freigegeben)
     m_vertices = data;
     m_indices = indices;
 
+    // Kompaktes Vertex-Format für die GPU
+    std::vector<TerrainVertex> compact;
+    std::vector<unsigned int> compactIndices;
+    buildCompactVertices(data, indices, compact, compactIndices);
+    createChunkBoundsTexture();
+
+    if (cache) {
+        CachedTerrainInfo info = { tangentHint, (uint32_t)stats.trianglesTotal };
+        cache->put(TerrainCacheSection::TerrainInfo, &info, 1);
+        cache->put(TerrainCacheSection::TerrainVertices, compact);
+        cache->put(TerrainCacheSection::TerrainIndices, compactIndices);
+        cache->put(TerrainCacheSection::TerrainChunks, chunks);
+    }
+
+    uploadGeometry(compact.data(), compact.size(), compactIndices.data(), compactIndices.size());
+}
+
+// Übernimmt die fertigen GPU-Daten direkt aus der eingeblendeten Cache-Datei.
+// m_vertices bleibt leer, der TerrainQuery lädt seine Daten dann ebenfalls aus dem Cache.
+bool Terrain::loadFromCache(const TerrainCache& cache) {
+    if (!cache.isLoaded()) return false;
+
+    const CachedTerrainInfo* info; size_t infoCount;
+    const TerrainVertex* vertices; size_t vertexCount;
+    const unsigned int* cachedIndices; size_t cachedIndexCount;
+    const TerrainChunk* cachedChunks; size_t chunkCount;
+    if (!cache.get(TerrainCacheSection::TerrainInfo, info, infoCount) || infoCount != 1 ||
+        !cache.get(TerrainCacheSection::TerrainVertices, vertices, vertexCount) ||
+        !cache.get(TerrainCacheSection::TerrainIndices, cachedIndices, cachedIndexCount) ||
+        !cache.get(TerrainCacheSection::TerrainChunks, cachedChunks, chunkCount)) {
+        return false;
+    }
+
+    chunks.assign(cachedChunks, cachedChunks + chunkCount);
+    tangentHint = info->tangentHint;
+    indexCount = (unsigned int)cachedIndexCount;
+    stats.chunksTotal = (int)chunks.size();
+    stats.trianglesTotal = (int)info->triangleCount;
+
+    createChunkBoundsTexture();
+    uploadGeometry(vertices, vertexCount, cachedIndices, cachedIndexCount);
+    std::cout << "Terrain: " << chunks.size() << " Chunks, " << info->triangleCount << " Dreiecke (Cache)." << std::endl;
+    return true;
+}
+
+void Terrain::uploadGeometry(const TerrainVertex* vertices, size_t vertexCount, const unsigned int* indices, size_t count) {
     glGenVertexArrays(1, &VAO);
     glGenBuffers(1, &VBO);
     glGenBuffers(1, &EBO);
     glBindVertexArray(VAO);
     glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, data.size() * sizeof(float), &data[0], GL_STATIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, vertexCount * sizeof(TerrainVertex), vertices, GL_STATIC_DRAW);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), &indices[0], GL_STATIC_DRAW);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(unsigned int), indices, GL_STATIC_DRAW);
 
-    int stride = 11 * sizeof(float);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)0); glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, (void*)(3 * sizeof(float))); glEnableVertexAttribArray(1);
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, stride, (void*)(6 * sizeof(float))); glEnableVertexAttribArray(2);
-    glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, stride, (void*)(8 * sizeof(float))); glEnableVertexAttribArray(3);
+    int stride = sizeof(TerrainVertex);
+    glVertexAttribPointer(0, 4, GL_UNSIGNED_SHORT, GL_TRUE, stride, (void*)offsetof(TerrainVertex, pos)); glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 2, GL_SHORT, GL_TRUE, stride, (void*)offsetof(TerrainVertex, normal)); glEnableVertexAttribArray(1);
+    glVertexAttribPointer(2, 2, GL_HALF_FLOAT, GL_FALSE, stride, (void*)offsetof(TerrainVertex, uv)); glEnableVertexAttribArray(2);
+    glBindVertexArray(0);
 }
\ No newline at end of file
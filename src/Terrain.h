@@ -1,40 +1,188 @@
 #pragma once
 #include <glad/glad.h>
+#include <glm/glm.hpp>
 #include <vector>
 #include <string>
+#include <cstdint>
+#include <mutex>
 #include "Shader.h"
+#include "Frustum.h"
 
+class TerrainQuery;
+class TerrainCache;
+struct TerrainEdit;
+
+// Texturpfade eines Terrain-Materials (eine Ebene in jedem Textur-Array)
 struct TerrainMaterial {
-    unsigned int albedo;
-    unsigned int normal;
-    unsigned int arm;
+    std::string albedo;
+    std::string normal;
+    std::string arm;
+};
+
+// Welche Materialien ein Chunk benutzt -> welche Shader-Variante ihn zeichnet
+enum class TerrainMaterialClass {
+    Ground,      // nur Boden (kein Splat-Lookup, kein Blending)
+    GroundRock,  // Boden + Fels
+    Shore,       // Kiesel + Boden (Ufer)
+    All          // alle drei Materialien
+};
+constexpr int TERRAIN_MATERIAL_CLASS_COUNT = 4;
+
+// Räumlicher Block des Terrains mit eigenem Index-Bereich (für Frustum Culling)
+struct TerrainChunk {
+    glm::vec3 boundsMin;      // Model-Space
+    glm::vec3 boundsMax;
+    unsigned int indexOffset; // Start im EBO (in Indizes)
+    unsigned int indexCount;
+    TerrainMaterialClass materialClass = TerrainMaterialClass::All;
+};
+
+// Kompaktes GPU-Vertex-Format (16 Byte statt 44 Byte mit Floats).
+// Position relativ zu den Chunk-Bounds quantisiert, die Tangente wird im Shader rekonstruiert.
+struct TerrainVertex {
+    uint16_t pos[4];      // unorm16 in [chunkMin, chunkMin + chunkExtent], w = Chunk-Index
+    uint32_t normal;      // Oktaeder-kodiert, 2x snorm16
+    uint32_t uv;          // 2x half float
+};
+static_assert(sizeof(TerrainVertex) == 16, "TerrainVertex muss 16 Byte groß sein");
+
+// Statistiken des letzten draw()-Aufrufs (für die UI)
+struct TerrainStats {
+    int chunksTotal = 0;
+    int chunksVisible = 0;
+    int trianglesTotal = 0;
+    int trianglesDrawn = 0;
 };
 
 class Terrain {
 public:
-    Terrain(const std::string& modelPath);
+    // Mit gültigem Cache werden die fertigen GPU-Buffer übernommen (kein Assimp-Import),
+    // sonst wird importiert und das Ergebnis im Cache vorgemerkt
+    Terrain(const std::string& modelPath, TerrainCache* cache = nullptr);
+    // Fertige Geometrie im Float-Layout des Imports (pos3, normal3, uv2, tangent3), z.B. vom TerrainGenerator.
+    // Ohne Cache, die Daten entstehen bei jedem Start neu.
+    Terrain(std::vector<float> vertices, std::vector<unsigned int> indices);
     ~Terrain();
 
-    void draw(Shader& shader);
+    // Kompiliert den Terrain-Shader einmal pro Material-Klasse (Define TERRAIN_LAYERS)
+    void loadShaders(const std::string& vertexPath, const std::string& fragmentPath);
+    Shader& getShader(TerrainMaterialClass materialClass) { return *shaders[(int)materialClass]; }
+    const std::vector<Shader*>& getShaders() const { return shaders; }
+
+    // Zeichnet nur die Chunks im Frustum, gruppiert nach Shader-Variante. mvp = projection * view * model
+    void draw(const glm::mat4& mvp);
+
+    // Bindet die Material-Arrays (Unit 0-2) + Splat Map ohne zu zeichnen
+    void bindMaterials() const;
+
+    // Zeichnet alle sichtbaren Chunks mit EINEM Shader (z.B. Virtual-Texture-Feedback), ohne Materialien
+    void drawGeometry(Shader& shader, const glm::mat4& mvp);
+
+    // Uniforms, die sich nach dem Laden nicht mehr ändern (Sampler-Units, Chunk-/Splat-Daten)
+    void applyStaticUniforms(Shader& shader) const;
+
+    // Backt die Material-Gewichte (pebbles, ground, rock) aus dem Raster des TerrainQuery in eine Textur
+    // und ordnet jedem Chunk seine Material-Klasse zu
+    // (aus dem Cache übernommen, falls vorhanden)
+    void bakeSplatMap(const TerrainQuery& query, TerrainCache* cache = nullptr);
 
-    // Diese Getter braucht dein GrassSystem in der main.cpp!
+    // Übernimmt einen Pinselstrich aus dem TerrainQuery: nur die betroffenen Vertices/Chunks werden
+    // neu kodiert und per glBufferSubData hochgeladen, Splat Map + Chunk-Klassen nur im Bereich
+    void applyEdit(const TerrainQuery& query, const TerrainEdit& edit);
+
+    // Import-Parameter, die das Ergebnis beeinflussen (Teil des Cache-Schlüssels)
+    static std::string cacheSignature();
+
+    glm::vec2 getSplatWorldMin() const { return splatWorldMin; }
+    glm::vec2 getSplatWorldSize() const { return splatWorldSize; }
+
+    // --- Virtual Texture Generator ---
+    // Lädt CPU-Kopien der Albedo-Ebenen (einmalig, erst wenn Virtual Texturing eingeschaltet wird)
+    void prepareAlbedoComposer(float tiling);
+    // Mischt die Albedo-Ebenen mit den Splat-Gewichten für einen Weltbereich (size x size Texel, RGBA8).
+    // Read-only, darf aus dem Loader-Thread aufgerufen werden.
+    void composeAlbedo(const glm::vec2& regionMin, const glm::vec2& regionSize, int size, unsigned char* out) const;
+
+    const TerrainStats& getStats() const { return stats; }
+
+    // Diese Getter braucht der TerrainQuery zum Aufbau (main.cpp)
     const std::vector<float>& getVertices() const { return m_vertices; }
     const std::vector<unsigned int>& getIndices() const { return m_indices; }
 
+    // Gibt die CPU-Kopie frei, sobald der TerrainQuery gebaut ist (nur noch GPU-Daten nötig)
+    void releaseGeometry();
+
 private:
     unsigned int VAO = 0, VBO = 0, EBO = 0, indexCount = 0;
 
-    // Materialien
-    TerrainMaterial matPebbles;
-    TerrainMaterial matGround;
-    TerrainMaterial matRock;
+    // Chunk-Bounds für die Dekodierung im Shader (RGBA32F, 2 Texel pro Chunk: min, extent)
+    static constexpr int CHUNK_BOUNDS_UNIT = 10;
+    unsigned int chunkBoundsTexture = 0;
+    glm::vec3 tangentHint = glm::vec3(1.0f, 0.0f, 0.0f); // mittlere Tangente (Model-Space)
+
+    // Chunks (CHUNK_GRID x CHUNK_GRID über die XZ-Ausdehnung)
+    static constexpr int CHUNK_GRID = 16;
+    std::vector<TerrainChunk> chunks;
+    TerrainStats stats;
+
+    // Pro Frame wiederverwendete Listen für glMultiDrawElements (eine pro Material-Klasse)
+    std::vector<GLsizei> drawCounts[TERRAIN_MATERIAL_CLASS_COUNT];
+    std::vector<const void*> drawOffsets[TERRAIN_MATERIAL_CLASS_COUNT];
+
+    // Shader-Varianten, Index = TerrainMaterialClass
+    std::vector<Shader*> shaders;
+
+    // Splat Map (RGB = Gewichte pebbles/ground/rock) über den XZ-Bereich des TerrainQuery
+    static constexpr int SPLAT_MAP_UNIT = 11;
+    static constexpr float SPLAT_EPSILON = 0.02f; // wie im terrain.fs.glsl
+    unsigned int splatTexture = 0;
+    glm::vec2 splatWorldMin = glm::vec2(0.0f);
+    glm::vec2 splatWorldSize = glm::vec2(1.0f);
+    std::vector<unsigned char> splatWeights; // CPU-Kopie (RGBA8) für den Albedo-Generator
+    int splatResolution = 0;
+    mutable std::mutex splatMutex;           // Editor schreibt, Loader-Thread des Virtual Texture liest
+
+    // Editor-Daten (erst beim ersten applyEdit aus den GPU-Buffern zurückgelesen)
+    std::vector<TerrainVertex> editVertices;      // CPU-Kopie des VBO
+    std::vector<unsigned int> editSource;         // kompakter Vertex -> Vertex im TerrainQuery
+    std::vector<unsigned int> editCopyOffsets;    // Vertex im TerrainQuery -> seine Kopien (CSR, eine pro Chunk)
+    std::vector<unsigned int> editCopies;
+    std::vector<unsigned int> chunkFirstVertex;   // Vertex-Bereich pro Chunk (Chunks liegen am Stück im VBO)
+    std::vector<unsigned int> chunkVertexCount;
+
+    // CPU-Albedo pro Ebene als Mip-Kette (Stufe 0 max. 1024²), nur für Virtual Texturing
+    struct AlbedoMip {
+        int width = 1, height = 1;
+        std::vector<unsigned char> rgba;
+    };
+    std::vector<std::vector<AlbedoMip>> albedoMips;
+    float composerTiling = 60.0f;
+
+    std::vector<TerrainMaterial> materials;
+
+    // Materialien als Textur-Arrays, Ebene = Material (0 pebbles, 1 ground, 2 rock)
+    unsigned int albedoArray = 0;
+    unsigned int normalArray = 0;
+    unsigned int armArray = 0;
 
-    // CPU-Speicher der Geometrie (Wichtig für Physics/Gras)
+    // CPU-Speicher der Geometrie (nur bis der TerrainQuery gebaut ist)
     std::vector<float> m_vertices;
     std::vector<unsigned int> m_indices;
 
     // Interne Helper
-    void loadModel(const std::string& path);
+    void loadModel(const std::string& path, TerrainCache* cache);
+    void buildFromGeometry(std::vector<float> data, std::vector<unsigned int> indices, TerrainCache* cache);
+    bool loadFromCache(const TerrainCache& cache);
+    void uploadGeometry(const TerrainVertex* vertices, size_t vertexCount, const unsigned int* indices, size_t count);
+    void createChunkBoundsTexture();
+    void buildChunks(const std::vector<float>& vertices, std::vector<unsigned int>& indices);
+    // Quantisiert die Vertices pro Chunk (Vertices an Chunk-Grenzen werden dupliziert)
+    void buildCompactVertices(const std::vector<float>& vertices, const std::vector<unsigned int>& indices,
+                              std::vector<TerrainVertex>& outVertices, std::vector<unsigned int>& outIndices);
     void loadMaterials();
-    unsigned int loadTexture(const char* path);
+    void classifyChunks(const std::vector<unsigned char>& weights, int res, float scale);
+    TerrainMaterialClass classifyChunk(const TerrainChunk& chunk, const std::vector<unsigned char>& weights, int res, float scale) const;
+    void beginEditing(const TerrainQuery& query);
+    void encodeVertex(TerrainVertex& vertex, const TerrainChunk& chunk, const glm::vec3& position, const glm::vec3& normal) const;
+    unsigned int loadTextureArray(const std::vector<std::string>& paths);
 };
\ No newline at end of file
@@ -0,0 +1,417 @@
+#include "TerrainBVH.h"
+#include "TerrainQuery.h"
+#include "TerrainCache.h"
+#include <algorithm>
+#include <limits>
+#include <cmath>
+#include <iostream>
+
+static const float NO_HIT = std::numeric_limits<float>::infinity();
+
+TerrainBVH::TerrainBVH(const TerrainQuery& q, TerrainCache* cache) : query(&q) {
+    if (cache && cache->isLoaded() && cache->get(TerrainCacheSection::BvhNodes, nodes) &&
+        cache->get(TerrainCacheSection::BvhTriangles, triangles) &&
+        triangles.size() == query->getIndices().size() / 3) {
+        computeDepth();
+        std::cout << "Terrain BVH: " << nodes.size() << " Knoten aus dem Cache." << std::endl;
+        return;
+    }
+    nodes.clear();
+    triangles.clear();
+    build();
+    computeDepth();
+    if (cache) {
+        cache->put(TerrainCacheSection::BvhNodes, nodes);
+        cache->put(TerrainCacheSection::BvhTriangles, triangles);
+    }
+}
+
+// --- AUFBAU ---
+static float surfaceArea(const glm::vec3& bMin, const glm::vec3& bMax) {
+    glm::vec3 d = glm::max(bMax - bMin, glm::vec3(0.0f));
+    return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+}
+
+void TerrainBVH::build() {
+    const auto& positions = query->getPositions();
+    const auto& indices = query->getIndices();
+    int triCount = (int)(indices.size() / 3);
+    if (triCount == 0) return;
+
+    std::vector<int> triIds(triCount);
+    std::vector<glm::vec3> centroids(triCount), triMin(triCount), triMax(triCount);
+    for (int t = 0; t < triCount; t++) {
+        const glm::vec3& a = positions[indices[t * 3]];
+        const glm::vec3& b = positions[indices[t * 3 + 1]];
+        const glm::vec3& c = positions[indices[t * 3 + 2]];
+        triIds[t] = t;
+        triMin[t] = glm::min(a, glm::min(b, c));
+        triMax[t] = glm::max(a, glm::max(b, c));
+        centroids[t] = (a + b + c) / 3.0f;
+    }
+
+    nodes.reserve(triCount * 2 / MAX_LEAF_TRIANGLES + 1);
+    buildNode(triIds, centroids, triMin, triMax, 0, triCount);
+
+    // Dreiecke in Blatt-Reihenfolge ablegen
+    triangles.resize(triCount);
+    for (int i = 0; i < triCount; i++) {
+        int t = triIds[i];
+        const glm::vec3& a = positions[indices[t * 3]];
+        const glm::vec3& b = positions[indices[t * 3 + 1]];
+        const glm::vec3& c = positions[indices[t * 3 + 2]];
+        triangles[i] = { a, b - a, c - a, t * 3 };
+    }
+
+    std::cout << "Terrain BVH: " << nodes.size() << " Knoten, " << triCount << " Dreiecke." << std::endl;
+}
+
+// Eltern liegen im Depth-First-Layout vor ihren Kindern -> ein Durchgang vorwärts
+void TerrainBVH::computeDepth() {
+    std::vector<int> depth(nodes.size(), 0);
+    maxDepth = 0;
+    for (size_t n = 0; n < nodes.size(); n++) {
+        maxDepth = std::max(maxDepth, depth[n]);
+        if (nodes[n].count > 0) continue;
+        depth[n + 1] = depth[n] + 1;
+        depth[nodes[n].first] = depth[n] + 1;
+    }
+    if (maxDepth + 2 > LOCAL_STACK)
+        std::cout << "Terrain BVH: Tiefe " << maxDepth << ", Traversierung auf dem Heap." << std::endl;
+}
+
+int TerrainBVH::buildNode(std::vector<int>& triIds, std::vector<glm::vec3>& centroids,
+                          std::vector<glm::vec3>& triMin, std::vector<glm::vec3>& triMax, int begin, int end) {
+    int index = (int)nodes.size();
+    nodes.push_back({});
+
+    glm::vec3 bMin(1e30f), bMax(-1e30f), cMin(1e30f), cMax(-1e30f);
+    for (int i = begin; i < end; i++) {
+        int t = triIds[i];
+        bMin = glm::min(bMin, triMin[t]);
+        bMax = glm::max(bMax, triMax[t]);
+        cMin = glm::min(cMin, centroids[t]);
+        cMax = glm::max(cMax, centroids[t]);
+    }
+    nodes[index].boundsMin = bMin;
+    nodes[index].boundsMax = bMax;
+
+    int count = end - begin;
+    auto makeLeaf = [&]() {
+        nodes[index].first = begin;
+        nodes[index].count = count;
+        return index;
+    };
+    if (count <= MAX_LEAF_TRIANGLES) return makeLeaf();
+
+    // Binned SAH: pro Achse SAH_BINS Eimer über die Schwerpunkt-Ausdehnung
+    float bestCost = NO_HIT;
+    int bestAxis = -1, bestSplit = -1;
+    for (int axis = 0; axis < 3; axis++) {
+        float extent = cMax[axis] - cMin[axis];
+        if (extent < 1e-6f) continue;
+        float scale = SAH_BINS / extent;
+
+        int binCount[SAH_BINS] = {};
+        glm::vec3 binMin[SAH_BINS], binMax[SAH_BINS];
+        for (int b = 0; b < SAH_BINS; b++) { binMin[b] = glm::vec3(1e30f); binMax[b] = glm::vec3(-1e30f); }
+
+        for (int i = begin; i < end; i++) {
+            int t = triIds[i];
+            int b = std::min(SAH_BINS - 1, (int)((centroids[t][axis] - cMin[axis]) * scale));
+            binCount[b]++;
+            binMin[b] = glm::min(binMin[b], triMin[t]);
+            binMax[b] = glm::max(binMax[b], triMax[t]);
+        }
+
+        // Von rechts aufsummieren, dann von links durchlaufen
+        float rightArea[SAH_BINS];
+        int rightCount[SAH_BINS];
+        glm::vec3 rMin(1e30f), rMax(-1e30f);
+        int rc = 0;
+        for (int b = SAH_BINS - 1; b > 0; b--) {
+            rc += binCount[b];
+            rMin = glm::min(rMin, binMin[b]);
+            rMax = glm::max(rMax, binMax[b]);
+            rightCount[b] = rc;
+            rightArea[b] = rc > 0 ? surfaceArea(rMin, rMax) : 0.0f;
+        }
+        glm::vec3 lMin(1e30f), lMax(-1e30f);
+        int lc = 0;
+        for (int b = 0; b < SAH_BINS - 1; b++) {
+            lc += binCount[b];
+            lMin = glm::min(lMin, binMin[b]);
+            lMax = glm::max(lMax, binMax[b]);
+            if (lc == 0 || rightCount[b + 1] == 0) continue;
+            float cost = lc * surfaceArea(lMin, lMax) + rightCount[b + 1] * rightArea[b + 1];
+            if (cost < bestCost) {
+                bestCost = cost;
+                bestAxis = axis;
+                bestSplit = b;
+            }
+        }
+    }
+
+    // Teilen nur, wenn es billiger ist als ein Blatt (Kosten relativ zur Knoten-Oberfläche)
+    float leafCost = count * surfaceArea(bMin, bMax);
+    if (bestAxis < 0 || (bestCost >= leafCost && count <= 4 * MAX_LEAF_TRIANGLES)) {
+        if (bestAxis < 0 && count > 4 * MAX_LEAF_TRIANGLES) {
+            // Alle Schwerpunkte identisch: in der Mitte teilen, damit Blätter klein bleiben
+            bestAxis = 0;
+        } else {
+            return makeLeaf();
+        }
+    }
+
+    int mid;
+    if (bestSplit >= 0) {
+        float scale = SAH_BINS / (cMax[bestAxis] - cMin[bestAxis]);
+        auto it = std::partition(triIds.begin() + begin, triIds.begin() + end, [&](int t) {
+            int b = std::min(SAH_BINS - 1, (int)((centroids[t][bestAxis] - cMin[bestAxis]) * scale));
+            return b <= bestSplit;
+        });
+        mid = (int)(it - triIds.begin());
+    } else {
+        mid = begin + count / 2;
+    }
+    if (mid == begin || mid == end) mid = begin + count / 2;
+
+    nodes[index].count = 0;
+    buildNode(triIds, centroids, triMin, triMax, begin, mid);
+    int right = buildNode(triIds, centroids, triMin, triMax, mid, end);
+    nodes[index].first = right;
+    return index;
+}
+
+// --- REFIT ---
+void TerrainBVH::refit(const TerrainEdit& edit) {
+    if (nodes.empty() || edit.triangles.empty()) return;
+    if (sourceTriangle.empty()) {
+        sourceTriangle.assign(triangles.size(), -1);
+        for (size_t i = 0; i < triangles.size(); i++) sourceTriangle[triangles[i].source / 3] = (int)i;
+    }
+
+    const auto& positions = query->getPositions();
+    const auto& indices = query->getIndices();
+    for (int tri : edit.triangles) {
+        int i = sourceTriangle[tri / 3];
+        if (i < 0) continue;
+        const glm::vec3& a = positions[indices[tri]];
+        triangles[i].v0 = a;
+        triangles[i].e1 = positions[indices[tri + 1]] - a;
+        triangles[i].e2 = positions[indices[tri + 2]] - a;
+    }
+
+    // Kinder liegen im Depth-First-Layout immer hinter ihrem Elternknoten -> rückwärts reicht ein Durchgang
+    for (int n = (int)nodes.size() - 1; n >= 0; n--) {
+        Node& node = nodes[n];
+        if (node.count > 0) {
+            glm::vec3 bMin(1e30f), bMax(-1e30f);
+            for (int i = node.first; i < node.first + node.count; i++) {
+                const Triangle& t = triangles[i];
+                glm::vec3 b = t.v0 + t.e1, c = t.v0 + t.e2;
+                bMin = glm::min(bMin, glm::min(t.v0, glm::min(b, c)));
+                bMax = glm::max(bMax, glm::max(t.v0, glm::max(b, c)));
+            }
+            node.boundsMin = bMin;
+            node.boundsMax = bMax;
+        } else {
+            const Node& left = nodes[n + 1];
+            const Node& right = nodes[node.first];
+            node.boundsMin = glm::min(left.boundsMin, right.boundsMin);
+            node.boundsMax = glm::max(left.boundsMax, right.boundsMax);
+        }
+    }
+}
+
+// --- SCHNITT-TESTS ---
+float TerrainBVH::intersectBox(const Node& node, const glm::vec3& origin, const glm::vec3& invDir, float tMax) {
+    glm::vec3 t1 = (node.boundsMin - origin) * invDir;
+    glm::vec3 t2 = (node.boundsMax - origin) * invDir;
+    glm::vec3 tNear = glm::min(t1, t2), tFar = glm::max(t1, t2);
+    float enter = std::max(std::max(tNear.x, tNear.y), std::max(tNear.z, 0.0f));
+    float exit = std::min(std::min(tFar.x, tFar.y), std::min(tFar.z, tMax));
+    return (enter <= exit) ? enter : NO_HIT;
+}
+
+// Möller-Trumbore (beidseitig)
+bool TerrainBVH::intersectTriangle(const Triangle& tri, const glm::vec3& origin, const glm::vec3& dir,
+                                   float& t, float& u, float& v) {
+    glm::vec3 p = glm::cross(dir, tri.e2);
+    float det = glm::dot(tri.e1, p);
+    if (std::abs(det) < 1e-12f) return false;
+    float invDet = 1.0f / det;
+
+    glm::vec3 s = origin - tri.v0;
+    u = glm::dot(s, p) * invDet;
+    if (u < 0.0f || u > 1.0f) return false;
+
+    glm::vec3 q = glm::cross(s, tri.e1);
+    v = glm::dot(dir, q) * invDet;
+    if (v < 0.0f || u + v > 1.0f) return false;
+
+    t = glm::dot(tri.e2, q) * invDet;
+    return t >= 0.0f;
+}
+
+TerrainRayHit TerrainBVH::makeHit(const glm::vec3& origin, const glm::vec3& dir, int tri, float t, float u, float v) const {
+    const auto& normals = query->getNormals();
+    const auto& indices = query->getIndices();
+    int src = triangles[tri].source;
+
+    TerrainRayHit hit;
+    hit.hit = true;
+    hit.t = t;
+    hit.position = origin + dir * t;
+    hit.normal = glm::normalize(normals[indices[src]] * (1.0f - u - v) + normals[indices[src + 1]] * u + normals[indices[src + 2]] * v);
+    hit.triangle = src;
+    return hit;
+}
+
+// --- ABFRAGEN ---
+TerrainRayHit TerrainBVH::raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance) const {
+    if (nodes.empty() || glm::length(direction) < 1e-12f) return TerrainRayHit();
+    glm::vec3 dir = glm::normalize(direction);
+    glm::vec3 invDir = 1.0f / dir;
+
+    float best = maxDistance, bestU = 0.0f, bestV = 0.0f;
+    int bestTri = -1;
+
+    struct Entry { int node; float enter; };
+    Entry localStack[LOCAL_STACK];
+    std::vector<Entry> heapStack;
+    Entry* stack = localStack;
+    if (stackSize() > LOCAL_STACK) { heapStack.resize(stackSize()); stack = heapStack.data(); }
+    int sp = 0;
+    float rootEnter = intersectBox(nodes[0], origin, invDir, best);
+    if (rootEnter == NO_HIT) return TerrainRayHit();
+    stack[sp++] = { 0, rootEnter };
+
+    while (sp > 0) {
+        Entry e = stack[--sp];
+        if (e.enter > best) continue;
+        const Node& node = nodes[e.node];
+
+        if (node.count > 0) {
+            for (int i = node.first; i < node.first + node.count; i++) {
+                float t, u, v;
+                if (intersectTriangle(triangles[i], origin, dir, t, u, v) && t <= best) {
+                    best = t; bestU = u; bestV = v; bestTri = i;
+                }
+            }
+            continue;
+        }
+
+        // Näheres Kind zuletzt auf den Stack -> wird zuerst besucht
+        int left = e.node + 1, right = node.first;
+        float dl = intersectBox(nodes[left], origin, invDir, best);
+        float dr = intersectBox(nodes[right], origin, invDir, best);
+        if (dl > dr) { std::swap(left, right); std::swap(dl, dr); }
+        if (dr != NO_HIT) stack[sp++] = { right, dr };
+        if (dl != NO_HIT) stack[sp++] = { left, dl };
+    }
+
+    if (bestTri < 0) return TerrainRayHit();
+    return makeHit(origin, dir, bestTri, best, bestU, bestV);
+}
+
+void TerrainBVH::raycastPacket(const glm::vec3* origins, const glm::vec3* directions, size_t count,
+                               TerrainRayHit* outHits, float maxDistance) const {
+    int localStack[LOCAL_STACK];
+    std::vector<int> heapStack;
+    int* stack = localStack;
+    if (stackSize() > LOCAL_STACK) { heapStack.resize(stackSize()); stack = heapStack.data(); }
+
+    for (size_t base = 0; base < count; base += PACKET_SIZE) {
+        int n = (int)std::min((size_t)PACKET_SIZE, count - base);
+
+        glm::vec3 dir[PACKET_SIZE], invDir[PACKET_SIZE];
+        float best[PACKET_SIZE], bestU[PACKET_SIZE], bestV[PACKET_SIZE];
+        int bestTri[PACKET_SIZE];
+        for (int r = 0; r < n; r++) {
+            dir[r] = glm::normalize(directions[base + r]);
+            invDir[r] = 1.0f / dir[r];
+            best[r] = maxDistance;
+            bestTri[r] = -1;
+            bestU[r] = bestV[r] = 0.0f;
+        }
+
+        // Gemeinsame Traversierung: ein Knoten wird besucht, sobald ihn mindestens ein Strahl trifft
+        int sp = 0;
+        if (!nodes.empty()) stack[sp++] = 0;
+        while (sp > 0) {
+            int nodeIndex = stack[--sp];
+            const Node& node = nodes[nodeIndex];
+
+            unsigned int mask = 0;
+            float nearest = NO_HIT;
+            for (int r = 0; r < n; r++) {
+                float enter = intersectBox(node, origins[base + r], invDir[r], best[r]);
+                if (enter != NO_HIT) {
+                    mask |= 1u << r;
+                    nearest = std::min(nearest, enter);
+                }
+            }
+            if (mask == 0) continue;
+
+            if (node.count > 0) {
+                for (int i = node.first; i < node.first + node.count; i++) {
+                    for (int r = 0; r < n; r++) {
+                        if (!(mask & (1u << r))) continue;
+                        float t, u, v;
+                        if (intersectTriangle(triangles[i], origins[base + r], dir[r], t, u, v) && t <= best[r]) {
+                            best[r] = t; bestU[r] = u; bestV[r] = v; bestTri[r] = i;
+                        }
+                    }
+                }
+                continue;
+            }
+
+            // Reihenfolge nach dem ersten Strahl des Pakets (kohärente Strahlen haben ähnliche Richtung)
+            int left = nodeIndex + 1, right = node.first;
+            float dl = intersectBox(nodes[left], origins[base], invDir[0], best[0]);
+            float dr = intersectBox(nodes[right], origins[base], invDir[0], best[0]);
+            if (dl > dr) std::swap(left, right);
+            stack[sp++] = right;
+            stack[sp++] = left;
+        }
+
+        for (int r = 0; r < n; r++) {
+            outHits[base + r] = (bestTri[r] >= 0)
+                ? makeHit(origins[base + r], dir[r], bestTri[r], best[r], bestU[r], bestV[r])
+                : TerrainRayHit();
+        }
+    }
+}
+
+bool TerrainBVH::hasLineOfSight(const glm::vec3& a, const glm::vec3& b) const {
+    glm::vec3 delta = b - a;
+    float length = glm::length(delta);
+    if (nodes.empty() || length < 1e-6f) return true;
+    glm::vec3 dir = delta / length;
+    glm::vec3 invDir = 1.0f / dir;
+    float tMax = length * 0.999f; // Endpunkte auf der Oberfläche nicht als Verdeckung zählen
+
+    int localStack[LOCAL_STACK];
+    std::vector<int> heapStack;
+    int* stack = localStack;
+    if (stackSize() > LOCAL_STACK) { heapStack.resize(stackSize()); stack = heapStack.data(); }
+    int sp = 0;
+    stack[sp++] = 0;
+    while (sp > 0) {
+        const Node& node = nodes[stack[--sp]];
+        if (intersectBox(node, a, invDir, tMax) == NO_HIT) continue;
+
+        if (node.count > 0) {
+            for (int i = node.first; i < node.first + node.count; i++) {
+                float t, u, v;
+                if (intersectTriangle(triangles[i], a, dir, t, u, v) && t > 1e-4f && t < tMax) return false;
+            }
+            continue;
+        }
+        int nodeIndex = (int)(&node - nodes.data());
+        stack[sp++] = node.first;
+        stack[sp++] = nodeIndex + 1;
+    }
+    return true;
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <vector>
+#include <cstddef>
+
+class TerrainQuery;
+class TerrainCache;
+struct TerrainEdit;
+
+// Ergebnis eines Strahls gegen das Terrain
+struct TerrainRayHit {
+    bool hit = false;
+    float t = 0.0f;                                  // Abstand entlang der (normierten) Richtung
+    glm::vec3 position = glm::vec3(0.0f);
+    glm::vec3 normal = glm::vec3(0.0f, 1.0f, 0.0f);  // interpolierte Vertex-Normale
+    int triangle = -1;                               // Start-Index in TerrainQuery::getIndices()
+};
+
+// Bounding Volume Hierarchy über die Terrain-Dreiecke (Weltkoordinaten aus dem TerrainQuery).
+// Aufbau mit Binned SAH, Knoten liegen flach im Depth-First-Layout (linkes Kind = Index + 1).
+// Für Editor-Platzierung, Boden-Clamp der Kamera und Sichtlinien-Tests.
+class TerrainBVH {
+public:
+    // Knoten + Dreiecke kommen aus dem Cache, falls gültig (sonst Aufbau und Vormerken im Cache)
+    explicit TerrainBVH(const TerrainQuery& query, TerrainCache* cache = nullptr);
+
+    // Nächster Treffer entlang origin + t * direction, t in [0, maxDistance]
+    TerrainRayHit raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance = 1e30f) const;
+
+    // Viele Strahlen auf einmal: Pakete zu PACKET_SIZE Strahlen traversieren den Baum gemeinsam
+    // (gut bei kohärenten Strahlen, z.B. Picking-Raster oder Sichtlinien von einem Punkt aus)
+    void raycastPacket(const glm::vec3* origins, const glm::vec3* directions, size_t count,
+                       TerrainRayHit* outHits, float maxDistance = 1e30f) const;
+
+    // true, wenn kein Terrain zwischen a und b liegt (Any-Hit, bricht beim ersten Treffer ab)
+    bool hasLineOfSight(const glm::vec3& a, const glm::vec3& b) const;
+
+    // Nach einem Terrain-Edit: veränderte Dreiecke neu übernehmen und die Bounds von unten nach oben anpassen
+    // (Refit statt Neuaufbau, die Topologie bleibt gleich)
+    void refit(const TerrainEdit& edit);
+
+    int getNodeCount() const { return (int)nodes.size(); }
+
+private:
+    static constexpr int PACKET_SIZE = 8;
+    static constexpr int SAH_BINS = 16;
+    static constexpr int MAX_LEAF_TRIANGLES = 4;
+    static constexpr int LOCAL_STACK = 64; // Traversierungs-Stapel auf dem Stack, tiefere Bäume nehmen den Heap
+
+    // 32 Byte pro Knoten. count > 0: Blatt mit Dreiecken [first, first + count)
+    // count == 0: innerer Knoten, linkes Kind direkt dahinter, rechtes Kind = first
+    struct Node {
+        glm::vec3 boundsMin;
+        int first;
+        glm::vec3 boundsMax;
+        int count;
+    };
+    std::vector<Node> nodes;
+    int maxDepth = 0; // tiefster Knoten (Wurzel = 0), Binned SAH begrenzt die Tiefe nicht
+
+    // Dreiecke in BVH-Reihenfolge, für Möller-Trumbore vorberechnet (v0, Kante 1, Kante 2)
+    struct Triangle {
+        glm::vec3 v0, e1, e2;
+        int source; // Start-Index in den Indizes des TerrainQuery
+    };
+    std::vector<Triangle> triangles;
+
+    const TerrainQuery* query;
+    std::vector<int> sourceTriangle; // Dreieck im TerrainQuery -> Index in triangles (erst beim ersten Refit)
+
+    void build();
+    void computeDepth();
+    int stackSize() const { return maxDepth + 2; } // Depth-First: höchstens ein Geschwister pro Ebene + 2 Kinder
+    int buildNode(std::vector<int>& triIds, std::vector<glm::vec3>& centroids,
+                  std::vector<glm::vec3>& triMin, std::vector<glm::vec3>& triMax, int begin, int end);
+
+    // Strahl gegen Box: liefert den Eintritts-Abstand oder einen Wert > tMax bei Verfehlen
+    static float intersectBox(const Node& node, const glm::vec3& origin, const glm::vec3& invDir, float tMax);
+    static bool intersectTriangle(const Triangle& tri, const glm::vec3& origin, const glm::vec3& dir,
+                                  float& t, float& u, float& v);
+    TerrainRayHit makeHit(const glm::vec3& origin, const glm::vec3& dir, int tri, float t, float u, float v) const;
+};
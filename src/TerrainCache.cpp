@@ -0,0 +1,224 @@
+#include "TerrainCache.h"
+#include <fstream>
+#include <cstdio>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// Datei-Layout: Header | SECTION_COUNT Einträge | Abschnitte (je 16 Byte ausgerichtet)
+namespace {
+    const char CACHE_MAGIC[8] = { 'T', 'R', 'N', 'C', 'A', 'C', 'H', 'E' };
+
+    struct FileHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t sectionCount;
+        uint64_t key;
+    };
+
+    struct SectionRecord {
+        uint32_t id;
+        uint32_t elementSize;
+        uint64_t offset;
+        uint64_t size;
+    };
+
+    const uint64_t FNV_OFFSET = 14695981039346656037ull;
+    const uint64_t FNV_PRIME = 1099511628211ull;
+
+    uint64_t fnv1a(const unsigned char* data, size_t size, uint64_t hash) {
+        for (size_t i = 0; i < size; i++) {
+            hash ^= data[i];
+            hash *= FNV_PRIME;
+        }
+        return hash;
+    }
+}
+
+TerrainCache::TerrainCache(const std::string& sourcePath, const std::string& importParams)
+    : cachePath(sourcePath + ".cache") {
+    // Schlüssel: Inhalt der Quelldatei + Import-Parameter + Format-Version
+    size_t sourceSize = 0;
+    void* sourceFile = nullptr;
+    void* sourceMapping = nullptr;
+    const unsigned char* source = mapFile(sourcePath, sourceSize, sourceFile, sourceMapping);
+    if (!source) {
+        std::cout << "[TerrainCache] Quelldatei nicht lesbar: " << sourcePath << std::endl;
+        return;
+    }
+    key = fnv1a(source, sourceSize, FNV_OFFSET);
+    unmapFile(source, sourceSize, sourceFile, sourceMapping);
+
+    key = fnv1a(reinterpret_cast<const unsigned char*>(importParams.data()), importParams.size(), key);
+    uint32_t version = VERSION;
+    key = fnv1a(reinterpret_cast<const unsigned char*>(&version), sizeof(version), key);
+
+    if (open()) std::cout << "[TerrainCache] Lade abgeleitete Daten aus " << cachePath << std::endl;
+    else std::cout << "[TerrainCache] Kein gültiger Cache, baue neu." << std::endl;
+}
+
+TerrainCache::~TerrainCache() {
+    release();
+}
+
+bool TerrainCache::open() {
+    const unsigned char* data = mapFile(cachePath, mappedSize, fileHandle, mappingHandle);
+    if (!data) return false;
+
+    auto fail = [&](const char* reason) {
+        std::cout << "[TerrainCache] " << cachePath << " verworfen: " << reason << std::endl;
+        unmapFile(data, mappedSize, fileHandle, mappingHandle);
+        fileHandle = mappingHandle = nullptr;
+        mappedSize = 0;
+        return false;
+    };
+
+    size_t tableEnd = sizeof(FileHeader) + SECTION_COUNT * sizeof(SectionRecord);
+    if (mappedSize < tableEnd) return fail("zu klein");
+
+    FileHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0) return fail("keine Cache-Datei");
+    if (header.version != VERSION) return fail("alte Version");
+    if (header.key != key) return fail("Quelldatei oder Parameter geändert");
+    if (header.sectionCount != SECTION_COUNT) return fail("Abschnitte fehlen");
+
+    bool seen[SECTION_COUNT] = {};
+    for (size_t i = 0; i < SECTION_COUNT; i++) {
+        SectionRecord record;
+        std::memcpy(&record, data + sizeof(FileHeader) + i * sizeof(SectionRecord), sizeof(record));
+        if (record.id >= SECTION_COUNT || seen[record.id]) return fail("ungültige Abschnitts-Tabelle");
+        if (record.elementSize == 0 || record.offset % SECTION_ALIGNMENT != 0 ||
+            record.offset < tableEnd || record.size > mappedSize || record.offset > mappedSize - record.size) {
+            return fail("Abschnitt außerhalb der Datei");
+        }
+        seen[record.id] = true;
+        entries[record.id] = { record.elementSize, record.offset, record.size };
+    }
+
+    mapped = data;
+    return true;
+}
+
+bool TerrainCache::save() {
+    if (isLoaded()) return true;
+    if (key == 0) return false;
+
+    for (size_t i = 0; i < SECTION_COUNT; i++) {
+        if (!pending[i].present) {
+            std::cout << "[TerrainCache] Nicht gespeichert, Abschnitt " << i << " fehlt." << std::endl;
+            return false;
+        }
+    }
+
+    // Offsets vergeben
+    std::vector<SectionRecord> records(SECTION_COUNT);
+    uint64_t offset = sizeof(FileHeader) + SECTION_COUNT * sizeof(SectionRecord);
+    for (size_t i = 0; i < SECTION_COUNT; i++) {
+        offset = (offset + SECTION_ALIGNMENT - 1) / SECTION_ALIGNMENT * SECTION_ALIGNMENT;
+        records[i] = { (uint32_t)i, pending[i].elementSize, offset, (uint64_t)pending[i].bytes.size() };
+        offset += pending[i].bytes.size();
+    }
+
+    // Erst in eine temporäre Datei, dann umbenennen (kein halber Cache bei Abbruch)
+    std::string tempPath = cachePath + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            std::cout << "[TerrainCache] Kann " << tempPath << " nicht schreiben." << std::endl;
+            return false;
+        }
+        FileHeader header;
+        std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+        header.version = VERSION;
+        header.sectionCount = (uint32_t)SECTION_COUNT;
+        header.key = key;
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(SectionRecord));
+
+        const char padding[SECTION_ALIGNMENT] = {};
+        uint64_t written = sizeof(FileHeader) + SECTION_COUNT * sizeof(SectionRecord);
+        for (size_t i = 0; i < SECTION_COUNT; i++) {
+            file.write(padding, (std::streamsize)(records[i].offset - written));
+            file.write(reinterpret_cast<const char*>(pending[i].bytes.data()), (std::streamsize)pending[i].bytes.size());
+            written = records[i].offset + records[i].size;
+        }
+        if (!file) {
+            std::cout << "[TerrainCache] Schreibfehler in " << tempPath << std::endl;
+            return false;
+        }
+    }
+    std::remove(cachePath.c_str());
+    if (std::rename(tempPath.c_str(), cachePath.c_str()) != 0) {
+        std::cout << "[TerrainCache] Kann " << cachePath << " nicht anlegen." << std::endl;
+        return false;
+    }
+
+    for (Pending& p : pending) std::vector<unsigned char>().swap(p.bytes);
+    std::cout << "[TerrainCache] Gespeichert: " << cachePath << " (" << offset / (1024 * 1024) << " MB)." << std::endl;
+    return true;
+}
+
+void TerrainCache::release() {
+    if (mapped) unmapFile(mapped, mappedSize, fileHandle, mappingHandle);
+    mapped = nullptr;
+    mappedSize = 0;
+    fileHandle = mappingHandle = nullptr;
+}
+
+// --- PLATTFORM ---
+#ifdef _WIN32
+const unsigned char* TerrainCache::mapFile(const std::string& path, size_t& size, void*& fileHandle, void*& mappingHandle) {
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return nullptr;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) { CloseHandle(file); return nullptr; }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) { CloseHandle(file); return nullptr; }
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) { CloseHandle(mapping); CloseHandle(file); return nullptr; }
+
+    size = (size_t)fileSize.QuadPart;
+    fileHandle = file;
+    mappingHandle = mapping;
+    return static_cast<const unsigned char*>(view);
+}
+
+void TerrainCache::unmapFile(const unsigned char* data, size_t, void* fileHandle, void* mappingHandle) {
+    UnmapViewOfFile(data);
+    if (mappingHandle) CloseHandle((HANDLE)mappingHandle);
+    if (fileHandle) CloseHandle((HANDLE)fileHandle);
+}
+#else
+const unsigned char* TerrainCache::mapFile(const std::string& path, size_t& size, void*& fileHandle, void*& mappingHandle) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return nullptr;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) { ::close(fd); return nullptr; }
+
+    void* view = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // Mapping bleibt nach close gültig
+    if (view == MAP_FAILED) return nullptr;
+
+    size = (size_t)st.st_size;
+    fileHandle = mappingHandle = nullptr;
+    return static_cast<const unsigned char*>(view);
+}
+
+void TerrainCache::unmapFile(const unsigned char* data, size_t size, void*, void*) {
+    munmap(const_cast<unsigned char*>(data), size);
+}
+#endif
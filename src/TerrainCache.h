@@ -0,0 +1,117 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include <iostream>
+
+// Abschnitte der Cache-Datei (Reihenfolge egal, jeder Abschnitt genau einmal)
+enum class TerrainCacheSection : uint32_t {
+    // Terrain (GPU-Daten, fertig quantisiert)
+    TerrainInfo, TerrainVertices, TerrainIndices, TerrainChunks,
+    // TerrainQuery (Geometrie, CSR-Grid, Raster)
+    QueryInfo, QueryPositions, QueryNormals, QueryIndices,
+    GridOffsets, GridTriangles,
+    GridX1, GridZ1, GridX2, GridZ2, GridX3, GridZ3, GridY1, GridY2, GridY3,
+    RasterHeights, RasterNormals,
+    // Splat Map (RGBA8)
+    SplatWeights,
+    // TerrainBVH
+    BvhNodes, BvhTriangles,
+    Count
+};
+
+// Versionierter Binär-Cache für alles, was beim Start aus landscape.glb abgeleitet wird.
+// Schlüssel = FNV-1a über die Quelldatei + Import-Parameter; passt er nicht, wird neu gebaut.
+// Beim Laden wird die Datei per mmap eingeblendet, die Abschnitte zeigen direkt in den Mapping-Speicher.
+// Beim Neubau sammeln die Systeme ihre Daten per put(), main.cpp schreibt danach einmal mit save().
+class TerrainCache {
+public:
+    // Bei Änderungen an einem der gespeicherten Formate erhöhen
+    static constexpr uint32_t VERSION = 1;
+
+    TerrainCache(const std::string& sourcePath, const std::string& importParams);
+    ~TerrainCache();
+
+    TerrainCache(const TerrainCache&) = delete;
+    TerrainCache& operator=(const TerrainCache&) = delete;
+
+    // true, wenn eine gültige Cache-Datei eingeblendet ist (alle Abschnitte vorhanden)
+    bool isLoaded() const { return mapped != nullptr; }
+
+    // Lesen: Zeiger in die eingeblendete Datei (gültig bis release())
+    template<typename T>
+    bool get(TerrainCacheSection section, const T*& data, size_t& count) const {
+        static_assert(std::is_trivially_copyable<T>::value, "Cache-Daten müssen trivial kopierbar sein");
+        const Entry& e = entries[(size_t)section];
+        if (!isLoaded() || e.elementSize != sizeof(T)) {
+            std::cout << "[TerrainCache] Abschnitt " << (uint32_t)section << " fehlt oder hat falsches Format." << std::endl;
+            return false;
+        }
+        data = reinterpret_cast<const T*>(mapped + e.offset);
+        count = (size_t)(e.size / sizeof(T));
+        return true;
+    }
+
+    template<typename T>
+    bool get(TerrainCacheSection section, std::vector<T>& out) const {
+        const T* data; size_t count;
+        if (!get(section, data, count)) return false;
+        out.assign(data, data + count);
+        return true;
+    }
+
+    // Schreiben: Daten für save() vormerken (kopiert)
+    template<typename T>
+    void put(TerrainCacheSection section, const T* data, size_t count) {
+        static_assert(std::is_trivially_copyable<T>::value, "Cache-Daten müssen trivial kopierbar sein");
+        Pending& p = pending[(size_t)section];
+        p.elementSize = sizeof(T);
+        p.bytes.resize(count * sizeof(T));
+        if (count > 0) std::memcpy(p.bytes.data(), data, count * sizeof(T));
+        p.present = true;
+    }
+
+    template<typename T>
+    void put(TerrainCacheSection section, const std::vector<T>& v) { put(section, v.data(), v.size()); }
+
+    // Schreibt alle vorgemerkten Abschnitte (nur wenn vollständig) und gibt den Puffer frei
+    bool save();
+
+    // Mapping aufheben, sobald alle Systeme ihre Daten übernommen haben
+    void release();
+
+private:
+    static constexpr size_t SECTION_COUNT = (size_t)TerrainCacheSection::Count;
+    static constexpr size_t SECTION_ALIGNMENT = 16;
+
+    struct Entry {
+        uint32_t elementSize = 0;
+        uint64_t offset = 0;
+        uint64_t size = 0;
+    };
+    struct Pending {
+        bool present = false;
+        uint32_t elementSize = 0;
+        std::vector<unsigned char> bytes;
+    };
+
+    std::string cachePath;
+    uint64_t key = 0;
+
+    Entry entries[SECTION_COUNT];
+    Pending pending[SECTION_COUNT];
+
+    // Plattform-Mapping (POSIX mmap / Windows File Mapping)
+    const unsigned char* mapped = nullptr;
+    size_t mappedSize = 0;
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+
+    bool open();
+    static const unsigned char* mapFile(const std::string& path, size_t& size, void*& fileHandle, void*& mappingHandle);
+    static void unmapFile(const unsigned char* data, size_t size, void* fileHandle, void* mappingHandle);
+};
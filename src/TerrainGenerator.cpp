@@ -0,0 +1,387 @@
+#include "TerrainGenerator.h"
+#include "TerrainStreamer.h"
+#include "Parallel.h"
+#include "HashRandom.h"
+#include <glm/gtc/constants.hpp>
+#include <algorithm>
+#include <cmath>
+
+// SIMD-Pfade für den Rausch-Kern (sonst skalarer Fallback), wie im TerrainQuery
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define TERRAIN_GENERATOR_AVX2 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define TERRAIN_GENERATOR_SSE2 1
+#endif
+
+namespace {
+
+// Gitter-Koordinaten werden auf diese Periode gefaltet (hält den Hash in float genau genug)
+constexpr float LATTICE_PERIOD = 4096.0f;
+// Drehung zwischen den Oktaven (cos/sin von ~36.9°), verhindert achsenparallele Artefakte
+constexpr float OCTAVE_COS = 0.8f, OCTAVE_SIN = 0.6f;
+// Gradient Noise liegt etwa in [-0.7, 0.7]
+constexpr float NOISE_RANGE = 1.4f;
+
+// --- LANES: gleiche Operationen für 1, 4 oder 8 Samples ---
+struct ScalarLanes {
+    using V = float;
+    static constexpr int WIDTH = 1;
+    static V set(float v) { return v; }
+    static V index(int first) { return (float)first; }
+    static V add(V a, V b) { return a + b; }
+    static V sub(V a, V b) { return a - b; }
+    static V mul(V a, V b) { return a * b; }
+    static V max(V a, V b) { return std::max(a, b); }
+    static V floor(V a) { return std::floor(a); }
+    static V abs(V a) { return std::fabs(a); }
+    static void store(float* out, V v) { *out = v; }
+};
+
+#ifdef TERRAIN_GENERATOR_SSE2
+struct SSELanes {
+    using V = __m128;
+    static constexpr int WIDTH = 4;
+    static V set(float v) { return _mm_set1_ps(v); }
+    static V index(int first) { return _mm_cvtepi32_ps(_mm_add_epi32(_mm_set1_epi32(first), _mm_setr_epi32(0, 1, 2, 3))); }
+    static V add(V a, V b) { return _mm_add_ps(a, b); }
+    static V sub(V a, V b) { return _mm_sub_ps(a, b); }
+    static V mul(V a, V b) { return _mm_mul_ps(a, b); }
+    static V max(V a, V b) { return _mm_max_ps(a, b); }
+    // SSE2 hat kein floor: abschneiden und bei negativen Nachkommastellen 1 abziehen
+    static V floor(V a) {
+        V t = _mm_cvtepi32_ps(_mm_cvttps_epi32(a));
+        return _mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, a), _mm_set1_ps(1.0f)));
+    }
+    static V abs(V a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+    static void store(float* out, V v) { _mm_storeu_ps(out, v); }
+};
+#endif
+
+#ifdef TERRAIN_GENERATOR_AVX2
+struct AVX2Lanes {
+    using V = __m256;
+    static constexpr int WIDTH = 8;
+    static V set(float v) { return _mm256_set1_ps(v); }
+    static V index(int first) {
+        return _mm256_cvtepi32_ps(_mm256_add_epi32(_mm256_set1_epi32(first), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7)));
+    }
+    static V add(V a, V b) { return _mm256_add_ps(a, b); }
+    static V sub(V a, V b) { return _mm256_sub_ps(a, b); }
+    static V mul(V a, V b) { return _mm256_mul_ps(a, b); }
+    static V max(V a, V b) { return _mm256_max_ps(a, b); }
+    static V floor(V a) { return _mm256_floor_ps(a); }
+    static V abs(V a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+    static void store(float* out, V v) { _mm256_storeu_ps(out, v); }
+};
+#endif
+
+// --- RAUSCH-KERN ---
+// Was der Kern vom Generator braucht (Zeiger auf dessen Arrays)
+struct NoiseParams {
+    const TerrainGeneratorSettings& settings;
+    const glm::vec2* octaveOffsets;
+    const glm::vec2* warpOffsetsX;
+    const glm::vec2* warpOffsetsZ;
+    int warpOctaves;
+    float fbmNormalization;
+    float warpNormalization;
+};
+
+template <class L>
+typename L::V fract(typename L::V a) { return L::sub(a, L::floor(a)); }
+
+template <class L>
+typename L::V wrapLattice(typename L::V a) {
+    return L::sub(a, L::mul(L::floor(L::mul(a, L::set(1.0f / LATTICE_PERIOD))), L::set(LATTICE_PERIOD)));
+}
+
+// Hash ohne Integer-Multiplikation ("hash without sine"), läuft damit auch mit SSE2.
+// Liefert den Gradienten eines Gitterpunkts in [-1, 1]².
+template <class L>
+void latticeGradient(typename L::V ix, typename L::V iz, typename L::V& gx, typename L::V& gz) {
+    using V = typename L::V;
+    V px = fract<L>(L::mul(ix, L::set(0.1031f)));
+    V py = fract<L>(L::mul(iz, L::set(0.1030f)));
+    V pz = fract<L>(L::mul(ix, L::set(0.0973f)));
+    const V k = L::set(33.33f);
+    V d = L::add(L::add(L::mul(px, L::add(py, k)), L::mul(py, L::add(pz, k))), L::mul(pz, L::add(px, k)));
+    px = L::add(px, d); py = L::add(py, d); pz = L::add(pz, d);
+    const V two = L::set(2.0f), one = L::set(1.0f);
+    gx = L::sub(L::mul(fract<L>(L::mul(L::add(px, py), pz)), two), one);
+    gz = L::sub(L::mul(fract<L>(L::mul(L::add(px, pz), py)), two), one);
+}
+
+// 2D Gradient Noise mit Quintic-Interpolation, offset verschiebt das Gitter (pro Oktave aus dem Seed)
+template <class L>
+typename L::V gradientNoise(typename L::V x, typename L::V z, const glm::vec2& offset) {
+    using V = typename L::V;
+    V fx0 = L::floor(x), fz0 = L::floor(z);
+    V fx = L::sub(x, fx0), fz = L::sub(z, fz0);
+    const V one = L::set(1.0f);
+    V ix0 = wrapLattice<L>(L::add(fx0, L::set(offset.x)));
+    V iz0 = wrapLattice<L>(L::add(fz0, L::set(offset.y)));
+    V ix1 = wrapLattice<L>(L::add(ix0, one));
+    V iz1 = wrapLattice<L>(L::add(iz0, one));
+    V fx1 = L::sub(fx, one), fz1 = L::sub(fz, one);
+
+    V gx, gz;
+    latticeGradient<L>(ix0, iz0, gx, gz); V n00 = L::add(L::mul(gx, fx),  L::mul(gz, fz));
+    latticeGradient<L>(ix1, iz0, gx, gz); V n10 = L::add(L::mul(gx, fx1), L::mul(gz, fz));
+    latticeGradient<L>(ix0, iz1, gx, gz); V n01 = L::add(L::mul(gx, fx),  L::mul(gz, fz1));
+    latticeGradient<L>(ix1, iz1, gx, gz); V n11 = L::add(L::mul(gx, fx1), L::mul(gz, fz1));
+
+    // u = 6t^5 - 15t^4 + 10t^3
+    auto fade = [](V t) {
+        return L::mul(L::mul(L::mul(t, t), t), L::add(L::mul(t, L::sub(L::mul(t, L::set(6.0f)), L::set(15.0f))), L::set(10.0f)));
+    };
+    V ux = fade(fx), uz = fade(fz);
+    V nx0 = L::add(n00, L::mul(ux, L::sub(n10, n00)));
+    V nx1 = L::add(n01, L::mul(ux, L::sub(n11, n01)));
+    return L::add(nx0, L::mul(uz, L::sub(nx1, nx0)));
+}
+
+template <class L>
+void rotateOctave(typename L::V& x, typename L::V& z, float lacunarity) {
+    using V = typename L::V;
+    const V c = L::set(OCTAVE_COS * lacunarity), s = L::set(OCTAVE_SIN * lacunarity);
+    V rx = L::sub(L::mul(x, c), L::mul(z, s));
+    z = L::add(L::mul(x, s), L::mul(z, c));
+    x = rx;
+}
+
+// Einfaches fBm für das Domain Warping (feste Lacunarity 2, Gain 0.5)
+template <class L>
+typename L::V warpNoise(typename L::V x, typename L::V z, const glm::vec2* offsets, int octaves) {
+    using V = typename L::V;
+    V sum = L::set(0.0f);
+    float amplitude = 1.0f;
+    for (int o = 0; o < octaves; o++) {
+        sum = L::add(sum, L::mul(gradientNoise<L>(x, z, offsets[o]), L::set(amplitude)));
+        amplitude *= 0.5f;
+        rotateOctave<L>(x, z, 2.0f);
+    }
+    return sum;
+}
+
+// Höhe an (x, z) in Weltkoordinaten
+template <class L>
+typename L::V evaluateHeight(const NoiseParams& p, typename L::V x, typename L::V z) {
+    using V = typename L::V;
+    const TerrainGeneratorSettings& s = p.settings;
+
+    // 1. Domain Warping: Eingabe um ein niederfrequentes fBm verschieben
+    if (s.warpStrength > 0.0f) {
+        V wx = L::mul(x, L::set(s.warpFrequency)), wz = L::mul(z, L::set(s.warpFrequency));
+        const V warpScale = L::set(s.warpStrength * p.warpNormalization * NOISE_RANGE);
+        V dx = warpNoise<L>(wx, wz, p.warpOffsetsX, p.warpOctaves);
+        V dz = warpNoise<L>(wx, wz, p.warpOffsetsZ, p.warpOctaves);
+        x = L::add(x, L::mul(dx, warpScale));
+        z = L::add(z, L::mul(dz, warpScale));
+    }
+
+    // 2. fBm und Ridged Noise aus denselben Oktaven
+    V px = L::mul(x, L::set(s.baseFrequency)), pz = L::mul(z, L::set(s.baseFrequency));
+    V fbm = L::set(0.0f), ridged = L::set(0.0f);
+    const V zero = L::set(0.0f), one = L::set(1.0f), ridgeSharpness = L::set(NOISE_RANGE);
+    float amplitude = 1.0f;
+    for (int o = 0; o < s.octaves; o++) {
+        V n = gradientNoise<L>(px, pz, p.octaveOffsets[o]);
+        V amp = L::set(amplitude);
+        fbm = L::add(fbm, L::mul(n, amp));
+        V r = L::max(zero, L::sub(one, L::mul(L::abs(n), ridgeSharpness)));
+        ridged = L::add(ridged, L::mul(L::mul(r, r), amp));
+        amplitude *= s.gain;
+        rotateOctave<L>(px, pz, s.lacunarity);
+    }
+
+    // fBm -> [-1, 1], Grate -> [0, 1] -> [-1, 1]
+    fbm = L::mul(fbm, L::set(p.fbmNormalization * NOISE_RANGE));
+    ridged = L::sub(L::mul(ridged, L::set(2.0f * p.fbmNormalization)), one);
+    V blended = L::add(L::mul(fbm, L::set(1.0f - s.ridgedMix)), L::mul(ridged, L::set(s.ridgedMix)));
+    return L::add(L::mul(blended, L::set(s.heightScale)), L::set(s.heightOffset));
+}
+
+// Zeile ab first in WIDTH-Schritten, gibt das Ende des bearbeiteten Bereichs zurück.
+// Sample i liegt bei originX + (indexX + i) * spacing, in allen Pfaden gleich gerechnet.
+template <class L>
+int generateRow(const NoiseParams& p, float originX, int indexX, float z, float spacing, int first, int count, float* out) {
+    const typename L::V vz = L::set(z), vOrigin = L::set(originX), vSpacing = L::set(spacing);
+    int i = first;
+    for (; i + L::WIDTH <= count; i += L::WIDTH) {
+        typename L::V vx = L::add(vOrigin, L::mul(L::index(indexX + i), vSpacing));
+        L::store(out + i, evaluateHeight<L>(p, vx, vz));
+    }
+    return i;
+}
+
+} // namespace
+
+TerrainGenerator::TerrainGenerator(const TerrainGeneratorSettings& s) : settings(s) {
+    settings.octaves = std::clamp(settings.octaves, 1, MAX_OCTAVES);
+    settings.grassTypes = std::max(settings.grassTypes, 1);
+
+    // Gitter-Verschiebungen aus dem Seed
+    HashRandom rng(settings.seed);
+    auto lattice = [&]() { return (float)rng.index((int)LATTICE_PERIOD); };
+    for (auto& offset : octaveOffsets) { offset.x = lattice(); offset.y = lattice(); }
+    for (auto& axis : warpOffsets)
+        for (auto& offset : axis) { offset.x = lattice(); offset.y = lattice(); }
+
+    float sum = 0.0f, amplitude = 1.0f;
+    for (int o = 0; o < settings.octaves; o++) { sum += amplitude; amplitude *= settings.gain; }
+    fbmNormalization = 1.0f / std::max(sum, 1e-6f);
+    sum = 0.0f; amplitude = 1.0f;
+    for (int o = 0; o < WARP_OCTAVES; o++) { sum += amplitude; amplitude *= 0.5f; }
+    warpNormalization = 1.0f / sum;
+}
+
+// --- HÖHEN ---
+void TerrainGenerator::generateHeights(float originX, float originZ, float spacing, int countX, int countZ, float* out) const {
+    generateRows(originX, originZ, 0, 0, spacing, countX, countZ, out);
+}
+
+// Ganzzahliger Gitter-Index statt Ursprung: benachbarte Tiles rechnen ihre gemeinsamen Rand-Samples aus
+// demselben Index, die Ränder sind damit bitgleich
+void TerrainGenerator::generateGridHeights(int firstX, int firstZ, float spacing, int countX, int countZ, float* out) const {
+    generateRows(0.0f, 0.0f, firstX, firstZ, spacing, countX, countZ, out);
+}
+
+void TerrainGenerator::generateRows(float originX, float originZ, int firstX, int firstZ, float spacing,
+                                    int countX, int countZ, float* out) const {
+    NoiseParams params = { settings, octaveOffsets, warpOffsets[0], warpOffsets[1], WARP_OCTAVES, fbmNormalization, warpNormalization };
+    for (int row = 0; row < countZ; row++) {
+        float z = originZ + (float)(firstZ + row) * spacing;
+        float* rowOut = out + (size_t)row * countX;
+        size_t done = generateRowAVX2(originX, firstX, z, spacing, countX, rowOut);
+        done = std::max(done, generateRowSSE(originX, firstX, z, spacing, countX, rowOut));
+        // Rest skalar
+        generateRow<ScalarLanes>(params, originX, firstX, z, spacing, (int)done, countX, rowOut);
+    }
+}
+
+float TerrainGenerator::getHeight(float x, float z) const {
+    NoiseParams params = { settings, octaveOffsets, warpOffsets[0], warpOffsets[1], WARP_OCTAVES, fbmNormalization, warpNormalization };
+    return evaluateHeight<ScalarLanes>(params, x, z);
+}
+
+// 8 Samples pro Durchgang (nur wenn mit AVX2 kompiliert)
+size_t TerrainGenerator::generateRowAVX2(float originX, int indexX, float z, float spacing, int count, float* out) const {
+#ifdef TERRAIN_GENERATOR_AVX2
+    NoiseParams params = { settings, octaveOffsets, warpOffsets[0], warpOffsets[1], WARP_OCTAVES, fbmNormalization, warpNormalization };
+    return (size_t)generateRow<AVX2Lanes>(params, originX, indexX, z, spacing, 0, count, out);
+#else
+    (void)originX; (void)indexX; (void)z; (void)spacing; (void)count; (void)out;
+    return 0;
+#endif
+}
+
+// 4 Samples pro Durchgang; läuft nur, wenn der AVX2-Pfad fehlt (sonst bleiben höchstens 7 Samples übrig)
+size_t TerrainGenerator::generateRowSSE(float originX, int indexX, float z, float spacing, int count, float* out) const {
+#if defined(TERRAIN_GENERATOR_SSE2) && !defined(TERRAIN_GENERATOR_AVX2)
+    NoiseParams params = { settings, octaveOffsets, warpOffsets[0], warpOffsets[1], WARP_OCTAVES, fbmNormalization, warpNormalization };
+    return (size_t)generateRow<SSELanes>(params, originX, indexX, z, spacing, 0, count, out);
+#else
+    (void)originX; (void)indexX; (void)z; (void)spacing; (void)count; (void)out;
+    return 0;
+#endif
+}
+
+// --- TILES FÜR DEN STREAMER ---
+bool TerrainGenerator::generateTile(int tileX, int tileZ, float tileSize, int resolution, TerrainTileData& out) const {
+    if (resolution < 2) return false;
+    const int res = resolution;
+    const float spacing = tileSize / (float)(res - 1);
+    const glm::vec2 origin = glm::vec2((float)tileX, (float)tileZ) * tileSize;
+
+    out.resolution = res;
+    out.heights.resize((size_t)res * res);
+    generateGridHeights(tileX * (res - 1), tileZ * (res - 1), spacing, res, res, out.heights.data());
+
+    // Gras verstreuen: gleiche Regeln wie GrassSystem::isGrassSurface (Höhenband, max. 45° Steigung),
+    // dazu Büschel aus einem hochfrequenten Rauschen. Pro Tile deterministisch aus Seed + Tile-Koordinaten.
+    HashRandom rng(settings.seed ^ hashUint((uint32_t)tileX * 0x27D4EB2Du ^ hashUint((uint32_t)tileZ * 0x165667B1u)));
+    const float maxSlopeCos = std::cos(glm::radians(45.0f));
+    const glm::vec2 clumpOffset = octaveOffsets[0] + glm::vec2(1733.0f, 911.0f);
+
+    auto heightAt = [&](int x, int z) {
+        return out.heights[(size_t)std::clamp(z, 0, res - 1) * res + std::clamp(x, 0, res - 1)];
+    };
+
+    out.grass.clear();
+    out.grass.reserve(settings.grassPerTile);
+    for (int i = 0; i < settings.grassPerTile; i++) {
+        float u = rng.next(), v = rng.next();
+        float fx = u * (float)(res - 1), fz = v * (float)(res - 1);
+        int cx = std::min((int)fx, res - 2), cz = std::min((int)fz, res - 2);
+        float tx = fx - (float)cx, tz = fz - (float)cz;
+        float h = (heightAt(cx, cz) * (1.0f - tx) + heightAt(cx + 1, cz) * tx) * (1.0f - tz) +
+                  (heightAt(cx, cz + 1) * (1.0f - tx) + heightAt(cx + 1, cz + 1) * tx) * tz;
+        if (h < -3.0f || h > 18.0f) continue;
+
+        int sx = (int)std::lround(fx), sz = (int)std::lround(fz);
+        glm::vec3 normal = glm::normalize(glm::vec3(heightAt(sx - 1, sz) - heightAt(sx + 1, sz), 2.0f * spacing,
+                                                    heightAt(sx, sz - 1) - heightAt(sx, sz + 1)));
+        if (normal.y < maxSlopeCos) continue;
+
+        glm::vec2 world = origin + glm::vec2(u, v) * tileSize;
+        float clump = gradientNoise<ScalarLanes>(world.x / 25.0f, world.y / 25.0f, clumpOffset) * NOISE_RANGE;
+        if (rng.next() > 0.5f + clump) continue;
+
+        TerrainTileGrass g;
+        g.x = world.x;
+        g.z = world.y;
+        g.scale = 0.15f * rng.range(0.7f, 1.3f);
+        g.rotation = rng.next() * glm::two_pi<float>();
+        g.type = (uint32_t)rng.index(settings.grassTypes);
+        out.grass.push_back(g);
+    }
+    return true;
+}
+
+// --- MESH IM TERRAIN-LAYOUT ---
+void TerrainGenerator::generateMesh(const glm::vec2& worldMin, float worldSize, int resolution, float modelScale,
+                                    std::vector<float>& vertices, std::vector<unsigned int>& indices) const {
+    const int res = std::max(resolution, 2);
+    const float spacing = worldSize / (float)(res - 1);
+    const size_t FLOATS = 11;
+
+    std::vector<float> heights((size_t)res * res);
+    parallelFor(0, res, [&](int row) {
+        generateHeights(worldMin.x, worldMin.y + (float)row * spacing, spacing, res, 1, heights.data() + (size_t)row * res);
+    });
+
+    vertices.resize((size_t)res * res * FLOATS);
+    parallelFor(0, res, [&](int z) {
+        auto h = [&](int x, int zz) {
+            return heights[(size_t)std::clamp(zz, 0, res - 1) * res + std::clamp(x, 0, res - 1)];
+        };
+        for (int x = 0; x < res; x++) {
+            float hL = h(x - 1, z), hR = h(x + 1, z), hD = h(x, z - 1), hU = h(x, z + 1);
+            glm::vec3 normal = glm::normalize(glm::vec3(hL - hR, 2.0f * spacing, hD - hU));
+            glm::vec3 tangent = glm::normalize(glm::vec3(2.0f * spacing, hR - hL, 0.0f));
+
+            float* v = &vertices[((size_t)z * res + x) * FLOATS];
+            v[0] = (worldMin.x + (float)x * spacing) / modelScale;
+            v[1] = h(x, z) / modelScale;
+            v[2] = (worldMin.y + (float)z * spacing) / modelScale;
+            v[3] = normal.x; v[4] = normal.y; v[5] = normal.z;
+            v[6] = (float)x / (float)(res - 1);
+            v[7] = (float)z / (float)(res - 1);
+            v[8] = tangent.x; v[9] = tangent.y; v[10] = tangent.z;
+        }
+    });
+
+    // Zwei Dreiecke pro Quad, gegen den Uhrzeigersinn von oben gesehen
+    indices.clear();
+    indices.reserve((size_t)(res - 1) * (res - 1) * 6);
+    for (int z = 0; z < res - 1; z++) {
+        for (int x = 0; x < res - 1; x++) {
+            unsigned int a = (unsigned int)(z * res + x), b = a + 1;
+            unsigned int c = a + (unsigned int)res, d = c + 1;
+            indices.insert(indices.end(), { a, c, b, b, c, d });
+        }
+    }
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <vector>
+#include <cstdint>
+
+struct TerrainTileData;
+
+// Parameter der prozeduralen Landschaft (alle Längen in Weltkoordinaten)
+struct TerrainGeneratorSettings {
+    uint32_t seed = 1;
+    float baseFrequency = 1.0f / 350.0f; // erste Oktave
+    int octaves = 6;
+    float lacunarity = 2.0f;             // Frequenz-Faktor pro Oktave
+    float gain = 0.5f;                   // Amplituden-Faktor pro Oktave
+    float ridgedMix = 0.35f;             // 0 = nur fBm, 1 = nur Grate (ridged noise)
+    float warpStrength = 40.0f;          // Domain Warping: maximale Verschiebung
+    float warpFrequency = 1.0f / 600.0f;
+    float heightScale = 28.0f;
+    float heightOffset = 6.0f;
+    int grassPerTile = 4096;             // Kandidaten pro Tile (generateTile)
+    int grassTypes = 6;                  // Gras-Typen 0 .. grassTypes-1 im GrassSystem
+};
+
+// Prozedurale Terrain-Quelle: Multi-Oktaven-fBm + Ridged Noise mit Domain Warping.
+// - Die Höhe ist eine reine Funktion der Weltposition (Tile-Ränder passen ohne Naht zusammen)
+// - Der Rausch-Kern rechnet 8 (AVX2) bzw. 4 (SSE2) Samples auf einmal, Rest skalar
+// - Alle Methoden sind const und ohne geteilten Zustand, dürfen also aus beliebig vielen Threads laufen
+// Liefert Tiles für den TerrainStreamer (als TileGenerator) und Meshes im Vertex-Layout des Terrain.
+class TerrainGenerator {
+public:
+    explicit TerrainGenerator(const TerrainGeneratorSettings& settings = TerrainGeneratorSettings());
+
+    // countX * countZ Höhen ab origin im Abstand spacing, Zeile für Zeile in +Z
+    void generateHeights(float originX, float originZ, float spacing, int countX, int countZ, float* out) const;
+    // Wie generateHeights, aber Sample (i, j) bei ((firstX + i) * spacing, (firstZ + j) * spacing):
+    // Nachbarn auf demselben Gitter bekommen bitgleiche gemeinsame Samples
+    void generateGridHeights(int firstX, int firstZ, float spacing, int countX, int countZ, float* out) const;
+    float getHeight(float x, float z) const;
+
+    // Passt auf TerrainStreamer::TileGenerator (Höhen + verstreutes Gras, Splat leitet der Streamer ab)
+    bool generateTile(int tileX, int tileZ, float tileSize, int resolution, TerrainTileData& out) const;
+
+    // Grid-Mesh über [worldMin, worldMin + worldSize] im Float-Layout des Terrain
+    // (pos3, normal3, uv2, tangent3 = 11 Floats), Positionen durch modelScale geteilt (Model-Space).
+    // Zeilen werden parallel erzeugt.
+    void generateMesh(const glm::vec2& worldMin, float worldSize, int resolution, float modelScale,
+                      std::vector<float>& vertices, std::vector<unsigned int>& indices) const;
+
+    const TerrainGeneratorSettings& getSettings() const { return settings; }
+
+private:
+    static constexpr int MAX_OCTAVES = 12;
+    static constexpr int WARP_OCTAVES = 3;
+
+    TerrainGeneratorSettings settings;
+    // Gitter-Verschiebung pro Oktave (aus dem Seed), macht die Oktaven unabhängig voneinander
+    glm::vec2 octaveOffsets[MAX_OCTAVES];
+    glm::vec2 warpOffsets[2][WARP_OCTAVES];
+    float fbmNormalization = 1.0f;
+    float warpNormalization = 1.0f;
+
+    void generateRows(float originX, float originZ, int firstX, int firstZ, float spacing,
+                      int countX, int countZ, float* out) const;
+    size_t generateRowAVX2(float originX, int indexX, float z, float spacing, int count, float* out) const;
+    size_t generateRowSSE(float originX, int indexX, float z, float spacing, int count, float* out) const;
+};
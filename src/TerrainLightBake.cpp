@@ -0,0 +1,234 @@
+#include "TerrainLightBake.h"
+#include "TerrainQuery.h"
+#include "TerrainBVH.h"
+#include "Parallel.h"
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+TerrainLightBake::TerrainLightBake(const TerrainQuery& q, const TerrainBVH& b, const std::vector<glm::vec4>& occ,
+                                   const std::vector<glm::vec3>& lightPositions, int res)
+    : query(q), bvh(b), resolution(std::max(res, 2)), occluders(occ) {
+    lights.assign(lightPositions.begin(), lightPositions.begin() + std::min((int)lightPositions.size(), MAX_LIGHTS));
+    worldMin = glm::vec2(query.getMinX(), query.getMinZ());
+    worldSize = glm::vec2(query.getMaxX() - query.getMinX(), query.getMaxZ() - query.getMinZ());
+
+    // Hammersley-Punkte, kosinusgewichtet auf die Hemisphäre projiziert
+    for (int i = 0; i < AO_RAYS; i++) {
+        unsigned int bits = (unsigned int)i;
+        bits = (bits << 16u) | (bits >> 16u);
+        bits = ((bits & 0x55555555u) << 1u) | ((bits & 0xAAAAAAAAu) >> 1u);
+        bits = ((bits & 0x33333333u) << 2u) | ((bits & 0xCCCCCCCCu) >> 2u);
+        bits = ((bits & 0x0F0F0F0Fu) << 4u) | ((bits & 0xF0F0F0F0u) >> 4u);
+        bits = ((bits & 0x00FF00FFu) << 8u) | ((bits & 0xFF00FF00u) >> 8u);
+        float u1 = ((float)i + 0.5f) / (float)AO_RAYS;
+        float u2 = (float)bits * 2.3283064365386963e-10f;
+        float r = std::sqrt(u1);
+        float phi = 6.2831853f * u2;
+        hemisphere[i] = glm::vec3(r * std::cos(phi), r * std::sin(phi), std::sqrt(std::max(0.0f, 1.0f - u1)));
+    }
+    buildOccluderGrid();
+
+    auto start = std::chrono::high_resolution_clock::now();
+    texels.assign((size_t)resolution * resolution * 4, 0);
+    bakeRows(0, 0, resolution - 1, resolution - 1);
+    bakeMs = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, resolution, resolution, 0, GL_RGBA, GL_UNSIGNED_BYTE, texels.data());
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    std::cout << "Terrain Light Bake: " << resolution << "x" << resolution << ", " << AO_RAYS << " AO-Strahlen, "
+              << occluders.size() << " Baumkronen, " << bakeMs << " ms." << std::endl;
+}
+
+TerrainLightBake::~TerrainLightBake() {
+    glDeleteTextures(1, &texture);
+}
+
+// --- VERDECKER ---
+int TerrainLightBake::texelOf(float v, float minV, float size) const {
+    return std::clamp((int)std::lround((v - minV) / size * (float)(resolution - 1)), 0, resolution - 1);
+}
+
+void TerrainLightBake::buildOccluderGrid() {
+    occluderGridX = std::max(1, (int)std::ceil(worldSize.x / AO_DISTANCE));
+    occluderGridZ = std::max(1, (int)std::ceil(worldSize.y / AO_DISTANCE));
+    auto cellOf = [&](const glm::vec4& s) {
+        int cx = std::clamp((int)((s.x - worldMin.x) / AO_DISTANCE), 0, occluderGridX - 1);
+        int cz = std::clamp((int)((s.z - worldMin.y) / AO_DISTANCE), 0, occluderGridZ - 1);
+        return cz * occluderGridX + cx;
+    };
+
+    occluderOffsets.assign((size_t)occluderGridX * occluderGridZ + 1, 0);
+    for (const auto& s : occluders) occluderOffsets[cellOf(s) + 1]++;
+    for (size_t c = 0; c + 1 < occluderOffsets.size(); c++) occluderOffsets[c + 1] += occluderOffsets[c];
+    std::vector<int> cursor(occluderOffsets.begin(), occluderOffsets.end() - 1);
+    occluderIds.resize(occluders.size());
+    for (size_t i = 0; i < occluders.size(); i++) occluderIds[cursor[cellOf(occluders[i])]++] = (int)i;
+}
+
+void TerrainLightBake::gatherOccluders(const glm::vec3& position, std::vector<int>& out) const {
+    out.clear();
+    int cx = (int)std::floor((position.x - worldMin.x) / AO_DISTANCE);
+    int cz = (int)std::floor((position.z - worldMin.y) / AO_DISTANCE);
+    for (int z = std::max(cz - 1, 0); z <= std::min(cz + 1, occluderGridZ - 1); z++) {
+        for (int x = std::max(cx - 1, 0); x <= std::min(cx + 1, occluderGridX - 1); x++) {
+            int cell = z * occluderGridX + x;
+            for (int e = occluderOffsets[cell]; e < occluderOffsets[cell + 1]; e++) {
+                const glm::vec4& s = occluders[occluderIds[e]];
+                if (glm::distance(glm::vec3(s), position) < AO_DISTANCE + s.w) out.push_back(occluderIds[e]);
+            }
+        }
+    }
+}
+
+// --- BAKE ---
+void TerrainLightBake::bakeRows(int x0, int z0, int x1, int z1) {
+    glm::vec2 step = worldSize / (float)(resolution - 1);
+    parallelFor(z0, z1 + 1, [&](int z) {
+        int count = x1 - x0 + 1;
+        std::vector<float> xs(count), zs(count), ys(count);
+        std::vector<glm::vec3> normals(count);
+        std::vector<int> nearby;
+        for (int i = 0; i < count; i++) {
+            xs[i] = worldMin.x + (float)(x0 + i) * step.x;
+            zs[i] = worldMin.y + (float)z * step.y;
+        }
+        query.sampleBatch(xs.data(), zs.data(), count, ys.data(), normals.data(), TerrainQueryMode::Raster);
+
+        for (int i = 0; i < count; i++) {
+            unsigned char* out = &texels[((size_t)z * resolution + x0 + i) * 4];
+            if (ys[i] <= TerrainQuery::NO_HEIGHT) {
+                out[0] = 255; out[1] = out[2] = out[3] = 0;
+                continue;
+            }
+            glm::vec3 p(xs[i], ys[i], zs[i]);
+
+            // Zufällige Drehung pro Texel statt Streifen durch das feste Strahlen-Muster
+            float hash = std::sin((float)(x0 + i) * 12.9898f + (float)z * 78.233f) * 43758.5453f;
+            float rotation = (hash - std::floor(hash)) * 6.2831853f;
+            gatherOccluders(p, nearby);
+            float ao = computeAO(p, normals[i], rotation, nearby);
+            out[0] = (unsigned char)(glm::clamp(ao, 0.0f, 1.0f) * 255.0f + 0.5f);
+
+            for (int l = 0; l < MAX_LIGHTS; l++) {
+                float horizon = 0.0f;
+                if (l < (int)lights.size()) {
+                    glm::vec2 toLight = glm::vec2(lights[l].x, lights[l].z) - glm::vec2(p.x, p.z);
+                    float lightDistance = glm::length(toLight);
+                    if (lightDistance > 0.001f) horizon = computeHorizon(p, toLight / lightDistance, lightDistance);
+                }
+                out[1 + l] = (unsigned char)(horizon * 255.0f + 0.5f);
+            }
+        }
+    });
+}
+
+float TerrainLightBake::computeAO(const glm::vec3& position, const glm::vec3& normal, float rotation,
+                                  const std::vector<int>& nearby) const {
+    glm::vec3 helper = std::abs(normal.x) < 0.9f ? glm::vec3(1.0f, 0.0f, 0.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+    glm::vec3 tangent = glm::normalize(glm::cross(helper, normal));
+    glm::vec3 bitangent = glm::cross(normal, tangent);
+    float c = std::cos(rotation), s = std::sin(rotation);
+
+    glm::vec3 origin = position + normal * SURFACE_OFFSET;
+    glm::vec3 origins[AO_RAYS], dirs[AO_RAYS];
+    for (int r = 0; r < AO_RAYS; r++) {
+        const glm::vec3& h = hemisphere[r];
+        float hx = h.x * c - h.y * s, hy = h.x * s + h.y * c;
+        origins[r] = origin;
+        dirs[r] = tangent * hx + bitangent * hy + normal * h.z;
+    }
+    // Das Terrain selbst über die BVH (Pakete, alle Strahlen starten am selben Punkt)
+    TerrainRayHit hits[AO_RAYS];
+    bvh.raycastPacket(origins, dirs, AO_RAYS, hits, AO_DISTANCE);
+
+    float occlusion = 0.0f;
+    for (int r = 0; r < AO_RAYS; r++) {
+        if (hits[r].hit) {
+            occlusion += 1.0f;
+            continue;
+        }
+        // Baumkronen als Kugeln, teilweise durchlässig
+        for (int id : nearby) {
+            const glm::vec4& sphere = occluders[id];
+            glm::vec3 oc = origin - glm::vec3(sphere);
+            float b = glm::dot(oc, dirs[r]);
+            float cc = glm::dot(oc, oc) - sphere.w * sphere.w;
+            float disc = b * b - cc;
+            if (disc < 0.0f) continue;
+            float root = std::sqrt(disc);
+            if (-b + root > 0.0f && -b - root < AO_DISTANCE) {
+                occlusion += CANOPY_DENSITY;
+                break;
+            }
+        }
+    }
+    return 1.0f - occlusion / (float)AO_RAYS;
+}
+
+// Höhenfeld-Marsch im Raster: größter Elevationswinkel in Richtung der Lichtquelle (Schrittweite wächst).
+// Punktlichter: Terrain hinter der Lampe verdeckt nichts, der Marsch endet bei ihrem XZ-Abstand
+float TerrainLightBake::computeHorizon(const glm::vec3& position, const glm::vec2& direction, float lightDistance) const {
+    float step = std::max(worldSize.x, worldSize.y) / (float)resolution * 0.5f;
+    float reach = std::min(lightDistance, HORIZON_DISTANCE);
+    float maxTan = 0.0f;
+    for (float d = step; d < reach; d = d * 1.1f + step) {
+        float h = query.getHeight(position.x + direction.x * d, position.z + direction.y * d, TerrainQueryMode::Raster);
+        if (h <= TerrainQuery::NO_HEIGHT) continue;
+        maxTan = std::max(maxTan, (h - position.y) / d);
+    }
+    return maxTan / std::sqrt(1.0f + maxTan * maxTan);
+}
+
+// --- EDITOR ---
+void TerrainLightBake::invalidateRegion(const glm::vec2& regionMin, const glm::vec2& regionMax) {
+    glm::ivec2 lo(texelOf(regionMin.x - AO_DISTANCE, worldMin.x, worldSize.x), texelOf(regionMin.y - AO_DISTANCE, worldMin.y, worldSize.y));
+    glm::ivec2 hi(texelOf(regionMax.x + AO_DISTANCE, worldMin.x, worldSize.x), texelOf(regionMax.y + AO_DISTANCE, worldMin.y, worldSize.y));
+    if (dirty) {
+        lo = glm::ivec2(std::min(lo.x, dirtyMin.x), std::min(lo.y, dirtyMin.y));
+        hi = glm::ivec2(std::max(hi.x, dirtyMax.x), std::max(hi.y, dirtyMax.y));
+    }
+    dirtyMin = lo;
+    dirtyMax = hi;
+    dirty = true;
+}
+
+void TerrainLightBake::updateDirty() {
+    if (!dirty) return;
+    dirty = false;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    bakeRows(dirtyMin.x, dirtyMin.y, dirtyMax.x, dirtyMax.y);
+
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, resolution);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, dirtyMin.x, dirtyMin.y, dirtyMax.x - dirtyMin.x + 1, dirtyMax.y - dirtyMin.y + 1,
+                    GL_RGBA, GL_UNSIGNED_BYTE, &texels[((size_t)dirtyMin.y * resolution + dirtyMin.x) * 4]);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    bakeMs = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+// --- SHADER ---
+void TerrainLightBake::apply(Shader& shader, int lightIndex, bool enabled) const {
+    glActiveTexture(GL_TEXTURE0 + TEXTURE_UNIT);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glActiveTexture(GL_TEXTURE0);
+
+    shader.use();
+    shader.setBool("useBakedLighting", enabled);
+    shader.setInt("bakedLighting", TEXTURE_UNIT);
+    shader.setVec2("bakedLightingMin", worldMin);
+    shader.setVec2("bakedLightingSize", worldSize);
+    // Kanal 1-3 = Horizont zur Lichtquelle, 0 = keine Horizont-Daten
+    int channel = (lightIndex >= 0 && lightIndex < (int)lights.size()) ? lightIndex + 1 : 0;
+    shader.setInt("bakedLightChannel", channel);
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include "Shader.h"
+
+class TerrainQuery;
+class TerrainBVH;
+
+// Offline gebackene Großflächen-Beleuchtung über die XZ-Ausdehnung des Terrains (RGBA8, eine Textur):
+// R   = Himmels-AO (kosinusgewichtete Strahlen in die Hemisphäre, gegen BVH + Baumkronen)
+// GBA = Horizont-Höhe (Sinus des Elevationswinkels) in Richtung von bis zu MAX_LIGHTS Lichtquellen
+// Terrain-, Gras- und Objekt-Shader holen beides mit einem Textur-Lookup (Unit 14).
+class TerrainLightBake {
+public:
+    static constexpr int MAX_LIGHTS = 3;
+    static constexpr int TEXTURE_UNIT = 14;
+
+    // occluders: Kugeln (xyz = Mitte, w = Radius), z.B. Baumkronen aus dem ForestSystem
+    TerrainLightBake(const TerrainQuery& query, const TerrainBVH& bvh, const std::vector<glm::vec4>& occluders,
+                     const std::vector<glm::vec3>& lightPositions, int resolution = 256);
+    ~TerrainLightBake();
+
+    // Editor: Bereich vormerken (wird um die AO-Reichweite erweitert), updateDirty() backt ihn neu.
+    // Horizonte weiter entfernter Texel bleiben bis zum nächsten vollen Bake unverändert.
+    void invalidateRegion(const glm::vec2& regionMin, const glm::vec2& regionMax);
+    void updateDirty();
+
+    // Textur auf Unit 14 binden + Uniforms setzen. lightIndex = Index in lightPositions
+    void apply(Shader& shader, int lightIndex, bool enabled) const;
+
+    float getBakeMs() const { return bakeMs; }
+
+private:
+    static constexpr int AO_RAYS = 32;
+    static constexpr float AO_DISTANCE = 40.0f;      // Weltabstand, ab dem nichts mehr verdeckt
+    static constexpr float HORIZON_DISTANCE = 200.0f; // Obergrenze, weiter entfernte Lampen marschieren nur bis hier
+    static constexpr float CANOPY_DENSITY = 0.6f;    // Blätterdach lässt etwas Himmel durch
+    static constexpr float SURFACE_OFFSET = 0.2f;    // Strahl-Start über der Oberfläche
+
+    const TerrainQuery& query;
+    const TerrainBVH& bvh;
+    std::vector<glm::vec3> lights;
+
+    int resolution;
+    glm::vec2 worldMin, worldSize;
+    std::vector<unsigned char> texels; // RGBA8
+    unsigned int texture = 0;
+    float bakeMs = 0.0f;
+
+    // Kugeln in einem XZ-Gitter (CSR), Zellgröße = AO_DISTANCE
+    std::vector<glm::vec4> occluders;
+    int occluderGridX = 0, occluderGridZ = 0;
+    std::vector<int> occluderOffsets;
+    std::vector<int> occluderIds;
+
+    // Kosinusgewichtete Richtungen im Tangentenraum (z = Normale), pro Texel zufällig um z gedreht
+    glm::vec3 hemisphere[AO_RAYS];
+
+    bool dirty = false;
+    glm::ivec2 dirtyMin = glm::ivec2(0), dirtyMax = glm::ivec2(0);
+
+    void buildOccluderGrid();
+    void bakeRows(int x0, int z0, int x1, int z1);
+    float computeAO(const glm::vec3& position, const glm::vec3& normal, float rotation,
+                    const std::vector<int>& nearby) const;
+    float computeHorizon(const glm::vec3& position, const glm::vec2& direction, float lightDistance) const;
+    void gatherOccluders(const glm::vec3& position, std::vector<int>& out) const;
+    int texelOf(float v, float minV, float size) const;
+};
@@ -0,0 +1,697 @@
+#include "TerrainQuery.h"
+#include "Terrain.h"
+#include "TerrainCache.h"
+#include "Parallel.h"
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+// SIMD-Pfade für die Batch-Abfrage (sonst skalarer Fallback)
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define TERRAIN_QUERY_AVX2 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define TERRAIN_QUERY_SSE2 1
+#endif
+
+TerrainQuery::TerrainQuery(const Terrain& terrain, float terrainScale, TerrainCache* cache, int gridResolution, int rasterRes)
+    : scale(terrainScale), resolution(gridResolution), rasterResolution(rasterRes) {
+    if (cache && cache->isLoaded() && loadFromCache(*cache)) return;
+
+    const std::vector<float>& vertices = terrain.getVertices();
+    indices = terrain.getIndices();
+
+    // Nur Position + Normale übernehmen (Stride 11 im Terrain-VBO)
+    size_t vertexCount = vertices.size() / 11;
+    positions.resize(vertexCount);
+    normals.resize(vertexCount);
+
+    minX = 100000.0f; maxX = -100000.0f;
+    minZ = 100000.0f; maxZ = -100000.0f;
+
+    // Skalieren und Grenzen finden
+    for (size_t v = 0; v < vertexCount; v++) {
+        const float* src = &vertices[v * 11];
+        positions[v] = glm::vec3(src[0], src[1], src[2]) * scale;
+        normals[v]   = glm::vec3(src[3], src[4], src[5]);
+
+        const glm::vec3& p = positions[v];
+        if (p.x < minX) minX = p.x;
+        if (p.x > maxX) maxX = p.x;
+        if (p.z < minZ) minZ = p.z;
+        if (p.z > maxZ) maxZ = p.z;
+    }
+
+    minX -= 1.0f; maxX += 1.0f;
+    minZ -= 1.0f; maxZ += 1.0f;
+
+    buildGrid();
+    bakeRaster();
+    if (cache) storeInCache(*cache);
+}
+
+std::string TerrainQuery::cacheSignature(float terrainScale, int gridResolution, int rasterResolution) {
+    return "scale=" + std::to_string(terrainScale) + " grid=" + std::to_string(gridResolution) +
+           " raster=" + std::to_string(rasterResolution);
+}
+
+// --- CACHE ---
+// Skalare Felder als ein Block, die Arrays als eigene Abschnitte
+struct CachedQueryInfo {
+    float scale;
+    float minX, maxX, minZ, maxZ;
+    int32_t resolution;
+    float cellWidth, cellDepth;
+    int32_t rasterResolution;
+    float rasterStepX, rasterStepZ;
+};
+
+bool TerrainQuery::loadFromCache(const TerrainCache& cache) {
+    const CachedQueryInfo* info; size_t infoCount;
+    if (!cache.get(TerrainCacheSection::QueryInfo, info, infoCount) || infoCount != 1) return false;
+    if (info->resolution != resolution || info->rasterResolution != rasterResolution || info->scale != scale) {
+        std::cout << "[TerrainQuery] Cache passt nicht zu den Parametern." << std::endl;
+        return false;
+    }
+
+    bool ok = cache.get(TerrainCacheSection::QueryPositions, positions) &&
+              cache.get(TerrainCacheSection::QueryNormals, normals) &&
+              cache.get(TerrainCacheSection::QueryIndices, indices) &&
+              cache.get(TerrainCacheSection::GridOffsets, cellOffsets) &&
+              cache.get(TerrainCacheSection::GridTriangles, cellTriangles) &&
+              cache.get(TerrainCacheSection::GridX1, cellTris.x1) && cache.get(TerrainCacheSection::GridZ1, cellTris.z1) &&
+              cache.get(TerrainCacheSection::GridX2, cellTris.x2) && cache.get(TerrainCacheSection::GridZ2, cellTris.z2) &&
+              cache.get(TerrainCacheSection::GridX3, cellTris.x3) && cache.get(TerrainCacheSection::GridZ3, cellTris.z3) &&
+              cache.get(TerrainCacheSection::GridY1, cellTris.y1) && cache.get(TerrainCacheSection::GridY2, cellTris.y2) &&
+              cache.get(TerrainCacheSection::GridY3, cellTris.y3) &&
+              cache.get(TerrainCacheSection::RasterHeights, rasterHeights) &&
+              cache.get(TerrainCacheSection::RasterNormals, rasterNormals);
+    if (!ok || cellOffsets.size() != (size_t)resolution * resolution + 1) return false;
+
+    minX = info->minX; maxX = info->maxX;
+    minZ = info->minZ; maxZ = info->maxZ;
+    cellWidth = info->cellWidth; cellDepth = info->cellDepth;
+    rasterStepX = info->rasterStepX; rasterStepZ = info->rasterStepZ;
+
+    std::cout << "[TerrainQuery] Grid + Raster aus dem Cache (" << positions.size() << " Vertices, "
+              << indices.size() / 3 << " Dreiecke)." << std::endl;
+    return true;
+}
+
+void TerrainQuery::storeInCache(TerrainCache& cache) const {
+    CachedQueryInfo info = { scale, minX, maxX, minZ, maxZ, resolution, cellWidth, cellDepth,
+                             rasterResolution, rasterStepX, rasterStepZ };
+    cache.put(TerrainCacheSection::QueryInfo, &info, 1);
+    cache.put(TerrainCacheSection::QueryPositions, positions);
+    cache.put(TerrainCacheSection::QueryNormals, normals);
+    cache.put(TerrainCacheSection::QueryIndices, indices);
+    cache.put(TerrainCacheSection::GridOffsets, cellOffsets);
+    cache.put(TerrainCacheSection::GridTriangles, cellTriangles);
+    cache.put(TerrainCacheSection::GridX1, cellTris.x1); cache.put(TerrainCacheSection::GridZ1, cellTris.z1);
+    cache.put(TerrainCacheSection::GridX2, cellTris.x2); cache.put(TerrainCacheSection::GridZ2, cellTris.z2);
+    cache.put(TerrainCacheSection::GridX3, cellTris.x3); cache.put(TerrainCacheSection::GridZ3, cellTris.z3);
+    cache.put(TerrainCacheSection::GridY1, cellTris.y1); cache.put(TerrainCacheSection::GridY2, cellTris.y2);
+    cache.put(TerrainCacheSection::GridY3, cellTris.y3);
+    cache.put(TerrainCacheSection::RasterHeights, rasterHeights);
+    cache.put(TerrainCacheSection::RasterNormals, rasterNormals);
+}
+
+// --- GITTER AUFBAU ---
+void TerrainQuery::getTriangleCells(size_t i, int& startX, int& endX, int& startZ, int& endZ) const {
+    const glm::vec3& p1 = positions[indices[i]];
+    const glm::vec3& p2 = positions[indices[i+1]];
+    const glm::vec3& p3 = positions[indices[i+2]];
+
+    float triMinX = std::min({p1.x, p2.x, p3.x});
+    float triMaxX = std::max({p1.x, p2.x, p3.x});
+    float triMinZ = std::min({p1.z, p2.z, p3.z});
+    float triMaxZ = std::max({p1.z, p2.z, p3.z});
+
+    startX = std::max(0, std::min(resolution - 1, (int)((triMinX - minX) / cellWidth)));
+    endX   = std::max(0, std::min(resolution - 1, (int)((triMaxX - minX) / cellWidth)));
+    startZ = std::max(0, std::min(resolution - 1, (int)((triMinZ - minZ) / cellDepth)));
+    endZ   = std::max(0, std::min(resolution - 1, (int)((triMaxZ - minZ) / cellDepth)));
+}
+
+// Zwei Durchgänge (Zählen, dann Füllen), beide parallel über Dreiecks-Blöcke.
+// Jeder Block schreibt in seinen eigenen Bereich pro Zelle -> Reihenfolge wie beim seriellen Aufbau.
+void TerrainQuery::buildGrid() {
+    std::cout << "[TerrainQuery] Baue Acceleration Grid..." << std::endl;
+
+    cellWidth = (maxX - minX) / resolution;
+    cellDepth = (maxZ - minZ) / resolution;
+
+    const int cellCount = resolution * resolution;
+    const int triCount = (int)(indices.size() / 3);
+    const int blockCount = std::max(1, std::min((int)std::thread::hardware_concurrency(), triCount));
+    const int blockSize = (triCount + blockCount - 1) / std::max(1, blockCount);
+
+    // 1. Zählen: Einträge pro (Block, Zelle)
+    std::vector<std::vector<int>> blockCursor(blockCount, std::vector<int>(cellCount, 0));
+    parallelFor(0, blockCount, [&](int block) {
+        std::vector<int>& counts = blockCursor[block];
+        int triEnd = std::min(triCount, (block + 1) * blockSize);
+        for (int t = block * blockSize; t < triEnd; t++) {
+            int startX, endX, startZ, endZ;
+            getTriangleCells((size_t)t * 3, startX, endX, startZ, endZ);
+            for (int z = startZ; z <= endZ; z++)
+                for (int x = startX; x <= endX; x++)
+                    counts[z * resolution + x]++;
+        }
+    });
+
+    // 2. Prefix-Summe: Zell-Offsets und Schreib-Cursor pro Block
+    cellOffsets.assign(cellCount + 1, 0);
+    for (int c = 0; c < cellCount; c++) {
+        int total = 0;
+        for (int block = 0; block < blockCount; block++) total += blockCursor[block][c];
+        cellOffsets[c + 1] = cellOffsets[c] + total;
+    }
+    parallelFor(0, cellCount, [&](int c) {
+        int cursor = cellOffsets[c];
+        for (int block = 0; block < blockCount; block++) {
+            int count = blockCursor[block][c];
+            blockCursor[block][c] = cursor;
+            cursor += count;
+        }
+    });
+
+    // 3. Füllen: Dreiecks-Index + Positionen (SoA) direkt in die Zelle schreiben
+    size_t entryCount = (size_t)cellOffsets[cellCount];
+    cellTriangles.assign(entryCount, 0);
+    for (std::vector<float>* arr : { &cellTris.x1, &cellTris.z1, &cellTris.x2, &cellTris.z2, &cellTris.x3, &cellTris.z3,
+                                     &cellTris.y1, &cellTris.y2, &cellTris.y3 }) {
+        arr->assign(entryCount, 0.0f);
+    }
+
+    parallelFor(0, blockCount, [&](int block) {
+        std::vector<int>& cursor = blockCursor[block];
+        int triEnd = std::min(triCount, (block + 1) * blockSize);
+        for (int t = block * blockSize; t < triEnd; t++) {
+            size_t i = (size_t)t * 3;
+            const glm::vec3& p1 = positions[indices[i]];
+            const glm::vec3& p2 = positions[indices[i+1]];
+            const glm::vec3& p3 = positions[indices[i+2]];
+
+            int startX, endX, startZ, endZ;
+            getTriangleCells(i, startX, endX, startZ, endZ);
+            for (int z = startZ; z <= endZ; z++) {
+                for (int x = startX; x <= endX; x++) {
+                    int e = cursor[z * resolution + x]++;
+                    cellTriangles[e] = (int)i;
+                    cellTris.x1[e] = p1.x; cellTris.z1[e] = p1.z; cellTris.y1[e] = p1.y;
+                    cellTris.x2[e] = p2.x; cellTris.z2[e] = p2.z; cellTris.y2[e] = p2.y;
+                    cellTris.x3[e] = p3.x; cellTris.z3[e] = p3.z; cellTris.y3[e] = p3.y;
+                }
+            }
+        }
+    });
+
+    std::cout << "[TerrainQuery] Grid fertig (" << positions.size() << " Vertices, "
+              << triCount << " Dreiecke, " << entryCount << " Zell-Einträge)." << std::endl;
+}
+
+// --- DREIECK FINDEN (Grid Lookup + Baryzentrisch) ---
+bool TerrainQuery::findTriangle(float x, float z, int& entry, float& l1, float& l2, float& l3) const {
+    if (!isInside(x, z)) return false;
+
+    int gridX = (int)((x - minX) / cellWidth);
+    int gridZ = (int)((z - minZ) / cellDepth);
+    if (gridX < 0 || gridX >= resolution || gridZ < 0 || gridZ >= resolution) return false;
+
+    int cell = gridZ * resolution + gridX;
+    const CellTriangleData& t = cellTris;
+    for (int e = cellOffsets[cell]; e < cellOffsets[cell + 1]; e++) {
+        float det = (t.z2[e] - t.z3[e]) * (t.x1[e] - t.x3[e]) + (t.x3[e] - t.x2[e]) * (t.z1[e] - t.z3[e]);
+        if (std::abs(det) < 0.001f) continue;
+
+        l1 = ((t.z2[e] - t.z3[e]) * (x - t.x3[e]) + (t.x3[e] - t.x2[e]) * (z - t.z3[e])) / det;
+        l2 = ((t.z3[e] - t.z1[e]) * (x - t.x3[e]) + (t.x1[e] - t.x3[e]) * (z - t.z3[e])) / det;
+        l3 = 1.0f - l1 - l2;
+
+        if (l1 >= 0.0f && l2 >= 0.0f && l3 >= 0.0f) {
+            entry = e;
+            return true;
+        }
+    }
+    return false;
+}
+
+// --- RASTER BACKEN (einmal beim Laden, parallel über Zeilen) ---
+void TerrainQuery::bakeRaster() {
+    if (rasterResolution < 2) return;
+
+    rasterStepX = (maxX - minX) / (rasterResolution - 1);
+    rasterStepZ = (maxZ - minZ) / (rasterResolution - 1);
+    rasterHeights.assign((size_t)rasterResolution * rasterResolution, NO_HEIGHT);
+    rasterNormals.assign((size_t)rasterResolution * rasterResolution, glm::vec3(0.0f, 1.0f, 0.0f));
+
+    parallelFor(0, rasterResolution, [this](int row) {
+        float z = minZ + row * rasterStepZ;
+        for (int col = 0; col < rasterResolution; col++) {
+            TerrainSample s = sampleExact(minX + col * rasterStepX, z);
+            if (!s.valid) continue;
+            size_t idx = (size_t)row * rasterResolution + col;
+            rasterHeights[idx] = s.height;
+            rasterNormals[idx] = s.normal;
+        }
+    });
+    std::cout << "[TerrainQuery] Raster gebacken (" << rasterResolution << "x" << rasterResolution << ")." << std::endl;
+}
+
+TerrainSample TerrainQuery::sampleExact(float x, float z) const {
+    TerrainSample result;
+    int e; float l1, l2, l3;
+    if (!findTriangle(x, z, e, l1, l2, l3)) return result;
+
+    int tri = cellTriangles[e];
+    unsigned int i1 = indices[tri], i2 = indices[tri+1], i3 = indices[tri+2];
+    result.height = l1 * cellTris.y1[e] + l2 * cellTris.y2[e] + l3 * cellTris.y3[e];
+    result.normal = glm::normalize(l1 * normals[i1] + l2 * normals[i2] + l3 * normals[i3]);
+    result.valid = true;
+    return result;
+}
+
+// --- BILINEARER RASTER-LOOKUP ---
+TerrainSample TerrainQuery::sampleRaster(float x, float z) const {
+    if (rasterHeights.empty() || !isInside(x, z)) return TerrainSample();
+
+    float fx = (x - minX) / rasterStepX;
+    float fz = (z - minZ) / rasterStepZ;
+    int x0 = std::min((int)fx, rasterResolution - 2);
+    int z0 = std::min((int)fz, rasterResolution - 2);
+    float tx = fx - x0;
+    float tz = fz - z0;
+
+    size_t i00 = (size_t)z0 * rasterResolution + x0;
+    size_t i10 = i00 + 1;
+    size_t i01 = i00 + rasterResolution;
+    size_t i11 = i01 + 1;
+
+    // Am Rand des Meshes (fehlende Texel) auf den exakten Lookup zurückfallen
+    if (rasterHeights[i00] <= NO_HEIGHT || rasterHeights[i10] <= NO_HEIGHT ||
+        rasterHeights[i01] <= NO_HEIGHT || rasterHeights[i11] <= NO_HEIGHT) {
+        return sampleExact(x, z);
+    }
+
+    float w00 = (1.0f - tx) * (1.0f - tz);
+    float w10 = tx * (1.0f - tz);
+    float w01 = (1.0f - tx) * tz;
+    float w11 = tx * tz;
+
+    TerrainSample result;
+    result.height = rasterHeights[i00] * w00 + rasterHeights[i10] * w10 +
+                    rasterHeights[i01] * w01 + rasterHeights[i11] * w11;
+    result.normal = glm::normalize(rasterNormals[i00] * w00 + rasterNormals[i10] * w10 +
+                                   rasterNormals[i01] * w01 + rasterNormals[i11] * w11);
+    result.valid = true;
+    return result;
+}
+
+// --- EDITOR ---
+void TerrainQuery::buildAdjacency() {
+    int triCount = (int)(indices.size() / 3);
+    vertexTriOffsets.assign(positions.size() + 1, 0);
+    for (unsigned int v : indices) vertexTriOffsets[v + 1]++;
+    for (size_t v = 0; v < positions.size(); v++) vertexTriOffsets[v + 1] += vertexTriOffsets[v];
+
+    vertexTriangles.resize(indices.size());
+    std::vector<int> cursor(vertexTriOffsets.begin(), vertexTriOffsets.end() - 1);
+    for (int t = 0; t < triCount; t++)
+        for (int k = 0; k < 3; k++) vertexTriangles[cursor[indices[t * 3 + k]]++] = t * 3;
+
+    vertexStamp.assign(positions.size(), 0);
+    triangleStamp.assign(triCount, 0);
+    std::cout << "[TerrainQuery] Nachbarschaft für den Editor gebaut." << std::endl;
+}
+
+bool TerrainQuery::applyBrush(const glm::vec2& center, float radius, float amount, TerrainBrushMode mode, TerrainEdit& outEdit) {
+    outEdit = TerrainEdit();
+    if (radius <= 0.0f || positions.empty()) return false;
+    std::unique_lock<std::shared_mutex> lock(dataMutex);
+    if (vertexTriOffsets.empty()) buildAdjacency();
+    editStamp++;
+
+    // 1. Kandidaten über die Grid-Zellen unter dem Pinsel sammeln (kein Scan über alle Vertices)
+    int cx0 = std::clamp((int)((center.x - radius - minX) / cellWidth), 0, resolution - 1);
+    int cx1 = std::clamp((int)((center.x + radius - minX) / cellWidth), 0, resolution - 1);
+    int cz0 = std::clamp((int)((center.y - radius - minZ) / cellDepth), 0, resolution - 1);
+    int cz1 = std::clamp((int)((center.y + radius - minZ) / cellDepth), 0, resolution - 1);
+
+    std::vector<unsigned int> moved;
+    std::vector<float> newHeights;
+    float smoothStep = std::max(std::max(rasterStepX, rasterStepZ), radius * 0.2f);
+    for (int z = cz0; z <= cz1; z++) {
+        for (int x = cx0; x <= cx1; x++) {
+            int cell = z * resolution + x;
+            for (int e = cellOffsets[cell]; e < cellOffsets[cell + 1]; e++) {
+                for (int k = 0; k < 3; k++) {
+                    unsigned int v = indices[cellTriangles[e] + k];
+                    if (vertexStamp[v] == editStamp) continue;
+                    vertexStamp[v] = editStamp;
+
+                    const glm::vec3& p = positions[v];
+                    float d = glm::length(glm::vec2(p.x, p.z) - center);
+                    if (d >= radius) continue;
+                    float t = 1.0f - d / radius;
+                    float falloff = t * t * (3.0f - 2.0f * t);
+
+                    float y = p.y;
+                    if (mode == TerrainBrushMode::Raise) y += amount * falloff;
+                    else if (mode == TerrainBrushMode::Lower) y -= amount * falloff;
+                    else {
+                        // Mittelwert aus dem (noch alten) Raster -> hängt nur von (x, z) ab,
+                        // doppelte Vertices an UV-Nähten bleiben deckungsgleich
+                        float sum = 0.0f; int count = 0;
+                        for (int oz = -1; oz <= 1; oz++) {
+                            for (int ox = -1; ox <= 1; ox++) {
+                                TerrainSample s = sampleRaster(p.x + ox * smoothStep, p.z + oz * smoothStep);
+                                if (s.valid) { sum += s.height; count++; }
+                            }
+                        }
+                        if (count > 0) y = glm::mix(y, sum / count, std::clamp(amount * falloff, 0.0f, 1.0f));
+                    }
+                    moved.push_back(v);
+                    newHeights.push_back(y);
+                }
+            }
+        }
+    }
+    if (moved.empty()) return false;
+    for (size_t i = 0; i < moved.size(); i++) positions[moved[i]].y = newHeights[i];
+
+    // 2. Betroffene Dreiecke + deren Vertices (Normalen hängen an allen Nachbar-Dreiecken)
+    editStamp++;
+    glm::vec2 rMin(1e30f), rMax(-1e30f);
+    for (unsigned int v : moved) {
+        for (int a = vertexTriOffsets[v]; a < vertexTriOffsets[v + 1]; a++) {
+            int tri = vertexTriangles[a];
+            if (triangleStamp[tri / 3] == editStamp) continue;
+            triangleStamp[tri / 3] = editStamp;
+            outEdit.triangles.push_back(tri);
+            for (int k = 0; k < 3; k++) {
+                unsigned int n = indices[tri + k];
+                if (vertexStamp[n] == editStamp) continue;
+                vertexStamp[n] = editStamp;
+                outEdit.vertices.push_back(n);
+                rMin = glm::min(rMin, glm::vec2(positions[n].x, positions[n].z));
+                rMax = glm::max(rMax, glm::vec2(positions[n].x, positions[n].z));
+            }
+        }
+    }
+    outEdit.regionMin = rMin;
+    outEdit.regionMax = rMax;
+
+    // 3. Normalen neu: flächengewichtete Summe der Dreiecks-Normalen, Orientierung wie bisher
+    for (unsigned int v : outEdit.vertices) {
+        glm::vec3 sum(0.0f);
+        for (int a = vertexTriOffsets[v]; a < vertexTriOffsets[v + 1]; a++) {
+            int tri = vertexTriangles[a];
+            const glm::vec3& p1 = positions[indices[tri]];
+            sum += glm::cross(positions[indices[tri + 1]] - p1, positions[indices[tri + 2]] - p1);
+        }
+        if (glm::dot(sum, normals[v]) < 0.0f) sum = -sum;
+        if (glm::length(sum) > 1e-12f) normals[v] = glm::normalize(sum);
+    }
+
+    // 4. Grid: die XZ-Lage ändert sich nicht, also bleiben die Zellen gleich -> nur Höhen der Einträge auffrischen
+    int gx0 = std::clamp((int)((rMin.x - minX) / cellWidth), 0, resolution - 1);
+    int gx1 = std::clamp((int)((rMax.x - minX) / cellWidth), 0, resolution - 1);
+    int gz0 = std::clamp((int)((rMin.y - minZ) / cellDepth), 0, resolution - 1);
+    int gz1 = std::clamp((int)((rMax.y - minZ) / cellDepth), 0, resolution - 1);
+    for (int z = gz0; z <= gz1; z++) {
+        for (int x = gx0; x <= gx1; x++) {
+            int cell = z * resolution + x;
+            for (int e = cellOffsets[cell]; e < cellOffsets[cell + 1]; e++) {
+                int tri = cellTriangles[e];
+                if (triangleStamp[tri / 3] != editStamp) continue;
+                cellTris.y1[e] = positions[indices[tri]].y;
+                cellTris.y2[e] = positions[indices[tri + 1]].y;
+                cellTris.y3[e] = positions[indices[tri + 2]].y;
+            }
+        }
+    }
+
+    // 5. Raster im Bereich neu backen
+    if (rasterResolution >= 2) {
+        outEdit.rasterX0 = std::clamp((int)std::floor((rMin.x - minX) / rasterStepX), 0, rasterResolution - 1);
+        outEdit.rasterX1 = std::clamp((int)std::ceil ((rMax.x - minX) / rasterStepX), 0, rasterResolution - 1);
+        outEdit.rasterZ0 = std::clamp((int)std::floor((rMin.y - minZ) / rasterStepZ), 0, rasterResolution - 1);
+        outEdit.rasterZ1 = std::clamp((int)std::ceil ((rMax.y - minZ) / rasterStepZ), 0, rasterResolution - 1);
+        parallelFor(outEdit.rasterZ0, outEdit.rasterZ1 + 1, [&](int row) {
+            float z = minZ + row * rasterStepZ;
+            for (int col = outEdit.rasterX0; col <= outEdit.rasterX1; col++) {
+                TerrainSample s = sampleExact(minX + col * rasterStepX, z);
+                size_t idx = (size_t)row * rasterResolution + col;
+                rasterHeights[idx] = s.valid ? s.height : NO_HEIGHT;
+                rasterNormals[idx] = s.valid ? s.normal : glm::vec3(0.0f, 1.0f, 0.0f);
+            }
+        });
+    }
+    return true;
+}
+
+TerrainSample TerrainQuery::sample(float x, float z, TerrainQueryMode mode) const {
+    return mode == TerrainQueryMode::Raster ? sampleRaster(x, z) : sampleExact(x, z);
+}
+
+float TerrainQuery::getHeight(float x, float z, TerrainQueryMode mode) const {
+    if (mode == TerrainQueryMode::Raster) return sampleRaster(x, z).height;
+
+    int e; float l1, l2, l3;
+    if (!findTriangle(x, z, e, l1, l2, l3)) return NO_HEIGHT;
+    return l1 * cellTris.y1[e] + l2 * cellTris.y2[e] + l3 * cellTris.y3[e];
+}
+
+glm::vec3 TerrainQuery::getNormal(float x, float z, TerrainQueryMode mode) const {
+    return sample(x, z, mode).normal;
+}
+
+// --- BATCH-ABFRAGE ---
+void TerrainQuery::sampleBatch(const float* xs, const float* zs, size_t count,
+                               float* outHeights, glm::vec3* outNormals, TerrainQueryMode mode) const {
+    std::shared_lock<std::shared_mutex> lock(dataMutex);
+    size_t done = 0;
+    if (mode == TerrainQueryMode::Raster && !rasterHeights.empty()) {
+        done = sampleRasterAVX2(xs, zs, count, outHeights, outNormals);
+        done += sampleRasterSSE(xs + done, zs + done, count - done,
+                                outHeights + done, outNormals ? outNormals + done : nullptr);
+    }
+
+    // Rest (bzw. alles im Exact-Modus) skalar
+    for (size_t i = done; i < count; i++) {
+        TerrainSample s = sample(xs[i], zs[i], mode);
+        outHeights[i] = s.height;
+        if (outNormals) outNormals[i] = s.normal;
+    }
+}
+
+// 4 Punkte pro Durchgang. Die Texel-Gathers sind skalar (SSE2 hat kein Gather),
+// Zellberechnung, Gewichte und Blending laufen vektorisiert.
+size_t TerrainQuery::sampleRasterSSE(const float* xs, const float* zs, size_t count,
+                                     float* outHeights, glm::vec3* outNormals) const {
+#ifdef TERRAIN_QUERY_SSE2
+    const float* heights = rasterHeights.data();
+    const float* nrm = &rasterNormals[0].x;
+    const int res = rasterResolution;
+
+    const __m128 vMinX = _mm_set1_ps(minX), vMaxX = _mm_set1_ps(maxX);
+    const __m128 vMinZ = _mm_set1_ps(minZ), vMaxZ = _mm_set1_ps(maxZ);
+    const __m128 vInvStepX = _mm_set1_ps(1.0f / rasterStepX);
+    const __m128 vInvStepZ = _mm_set1_ps(1.0f / rasterStepZ);
+    const __m128 vZero = _mm_setzero_ps(), vOne = _mm_set1_ps(1.0f);
+    const __m128 vMaxCell = _mm_set1_ps((float)(res - 2));
+    const __m128 vMaxCoord = _mm_set1_ps((float)(res - 1));
+    const __m128 vRes = _mm_set1_ps((float)res);
+    const __m128 vMissing = _mm_set1_ps(NO_HEIGHT); // h <= NO_HEIGHT wie sampleRaster
+
+    alignas(16) int idx[4];
+    alignas(16) float nx[4], ny[4], nz[4];
+
+    auto gather = [&](const float* base, int offset, int stride) {
+        return _mm_set_ps(base[(idx[3] + offset) * stride], base[(idx[2] + offset) * stride],
+                          base[(idx[1] + offset) * stride], base[(idx[0] + offset) * stride]);
+    };
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 x = _mm_loadu_ps(xs + i);
+        __m128 z = _mm_loadu_ps(zs + i);
+        __m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(x, vMinX), _mm_cmple_ps(x, vMaxX)),
+                                   _mm_and_ps(_mm_cmpge_ps(z, vMinZ), _mm_cmple_ps(z, vMaxZ)));
+
+        // Rasterkoordinaten (geklemmt, damit auch Punkte außerhalb gültige Indizes liefern)
+        __m128 fx = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_sub_ps(x, vMinX), vInvStepX), vZero), vMaxCoord);
+        __m128 fz = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_sub_ps(z, vMinZ), vInvStepZ), vZero), vMaxCoord);
+        __m128 cx = _mm_min_ps(_mm_cvtepi32_ps(_mm_cvttps_epi32(fx)), vMaxCell);
+        __m128 cz = _mm_min_ps(_mm_cvtepi32_ps(_mm_cvttps_epi32(fz)), vMaxCell);
+        __m128 tx = _mm_sub_ps(fx, cx);
+        __m128 tz = _mm_sub_ps(fz, cz);
+        _mm_store_si128((__m128i*)idx, _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(cz, vRes), cx)));
+
+        __m128 w00 = _mm_mul_ps(_mm_sub_ps(vOne, tx), _mm_sub_ps(vOne, tz));
+        __m128 w10 = _mm_mul_ps(tx, _mm_sub_ps(vOne, tz));
+        __m128 w01 = _mm_mul_ps(_mm_sub_ps(vOne, tx), tz);
+        __m128 w11 = _mm_mul_ps(tx, tz);
+
+        __m128 h00 = gather(heights, 0, 1), h10 = gather(heights, 1, 1);
+        __m128 h01 = gather(heights, res, 1), h11 = gather(heights, res + 1, 1);
+        __m128 missing = _mm_or_ps(_mm_or_ps(_mm_cmple_ps(h00, vMissing), _mm_cmple_ps(h10, vMissing)),
+                                   _mm_or_ps(_mm_cmple_ps(h01, vMissing), _mm_cmple_ps(h11, vMissing)));
+
+        __m128 h = _mm_add_ps(_mm_add_ps(_mm_mul_ps(h00, w00), _mm_mul_ps(h10, w10)),
+                              _mm_add_ps(_mm_mul_ps(h01, w01), _mm_mul_ps(h11, w11)));
+        _mm_storeu_ps(outHeights + i, h);
+
+        if (outNormals) {
+            __m128 n[3];
+            for (int k = 0; k < 3; k++) {
+                const float* base = nrm + k;
+                n[k] = _mm_add_ps(_mm_add_ps(_mm_mul_ps(gather(base, 0, 3), w00), _mm_mul_ps(gather(base, 1, 3), w10)),
+                                  _mm_add_ps(_mm_mul_ps(gather(base, res, 3), w01), _mm_mul_ps(gather(base, res + 1, 3), w11)));
+            }
+            __m128 lenSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(n[0], n[0]), _mm_mul_ps(n[1], n[1])), _mm_mul_ps(n[2], n[2]));
+            __m128 invLen = _mm_div_ps(vOne, _mm_sqrt_ps(_mm_max_ps(lenSq, _mm_set1_ps(1e-12f))));
+            _mm_store_ps(nx, _mm_mul_ps(n[0], invLen));
+            _mm_store_ps(ny, _mm_mul_ps(n[1], invLen));
+            _mm_store_ps(nz, _mm_mul_ps(n[2], invLen));
+            for (int lane = 0; lane < 4; lane++) outNormals[i + lane] = glm::vec3(nx[lane], ny[lane], nz[lane]);
+        }
+
+        // Außerhalb oder am Mesh-Rand: skalar nachrechnen
+        int fallback = (~_mm_movemask_ps(inside) & 0xF) | _mm_movemask_ps(missing);
+        if (fallback) {
+            for (int lane = 0; lane < 4; lane++) {
+                if (!(fallback & (1 << lane))) continue;
+                TerrainSample s = sampleRaster(xs[i + lane], zs[i + lane]);
+                outHeights[i + lane] = s.height;
+                if (outNormals) outNormals[i + lane] = s.normal;
+            }
+        }
+    }
+    return i;
+#else
+    return 0;
+#endif
+}
+
+// 8 Punkte pro Durchgang mit Hardware-Gather (nur wenn mit AVX2 kompiliert)
+size_t TerrainQuery::sampleRasterAVX2(const float* xs, const float* zs, size_t count,
+                                      float* outHeights, glm::vec3* outNormals) const {
+#ifdef TERRAIN_QUERY_AVX2
+    const float* heights = rasterHeights.data();
+    const float* nrm = &rasterNormals[0].x;
+    const int res = rasterResolution;
+
+    const __m256 vMinX = _mm256_set1_ps(minX), vMaxX = _mm256_set1_ps(maxX);
+    const __m256 vMinZ = _mm256_set1_ps(minZ), vMaxZ = _mm256_set1_ps(maxZ);
+    const __m256 vInvStepX = _mm256_set1_ps(1.0f / rasterStepX);
+    const __m256 vInvStepZ = _mm256_set1_ps(1.0f / rasterStepZ);
+    const __m256 vZero = _mm256_setzero_ps(), vOne = _mm256_set1_ps(1.0f);
+    const __m256 vMaxCell = _mm256_set1_ps((float)(res - 2));
+    const __m256 vMaxCoord = _mm256_set1_ps((float)(res - 1));
+    const __m256 vRes = _mm256_set1_ps((float)res);
+    const __m256 vMissing = _mm256_set1_ps(NO_HEIGHT); // h <= NO_HEIGHT wie sampleRaster
+    const __m256i vOffset10 = _mm256_set1_epi32(1);
+    const __m256i vOffset01 = _mm256_set1_epi32(res);
+    const __m256i vOffset11 = _mm256_set1_epi32(res + 1);
+    const __m256i vThree = _mm256_set1_epi32(3);
+
+    alignas(32) float nx[8], ny[8], nz[8];
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 x = _mm256_loadu_ps(xs + i);
+        __m256 z = _mm256_loadu_ps(zs + i);
+        __m256 inside = _mm256_and_ps(_mm256_and_ps(_mm256_cmp_ps(x, vMinX, _CMP_GE_OQ), _mm256_cmp_ps(x, vMaxX, _CMP_LE_OQ)),
+                                      _mm256_and_ps(_mm256_cmp_ps(z, vMinZ, _CMP_GE_OQ), _mm256_cmp_ps(z, vMaxZ, _CMP_LE_OQ)));
+
+        __m256 fx = _mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(_mm256_sub_ps(x, vMinX), vInvStepX), vZero), vMaxCoord);
+        __m256 fz = _mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(_mm256_sub_ps(z, vMinZ), vInvStepZ), vZero), vMaxCoord);
+        __m256 cx = _mm256_min_ps(_mm256_floor_ps(fx), vMaxCell);
+        __m256 cz = _mm256_min_ps(_mm256_floor_ps(fz), vMaxCell);
+        __m256 tx = _mm256_sub_ps(fx, cx);
+        __m256 tz = _mm256_sub_ps(fz, cz);
+        __m256i i00 = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(cz, vRes), cx));
+        __m256i i10 = _mm256_add_epi32(i00, vOffset10);
+        __m256i i01 = _mm256_add_epi32(i00, vOffset01);
+        __m256i i11 = _mm256_add_epi32(i00, vOffset11);
+
+        __m256 w00 = _mm256_mul_ps(_mm256_sub_ps(vOne, tx), _mm256_sub_ps(vOne, tz));
+        __m256 w10 = _mm256_mul_ps(tx, _mm256_sub_ps(vOne, tz));
+        __m256 w01 = _mm256_mul_ps(_mm256_sub_ps(vOne, tx), tz);
+        __m256 w11 = _mm256_mul_ps(tx, tz);
+
+        __m256 h00 = _mm256_i32gather_ps(heights, i00, 4), h10 = _mm256_i32gather_ps(heights, i10, 4);
+        __m256 h01 = _mm256_i32gather_ps(heights, i01, 4), h11 = _mm256_i32gather_ps(heights, i11, 4);
+        __m256 missing = _mm256_or_ps(_mm256_or_ps(_mm256_cmp_ps(h00, vMissing, _CMP_LE_OQ), _mm256_cmp_ps(h10, vMissing, _CMP_LE_OQ)),
+                                      _mm256_or_ps(_mm256_cmp_ps(h01, vMissing, _CMP_LE_OQ), _mm256_cmp_ps(h11, vMissing, _CMP_LE_OQ)));
+
+        __m256 h = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(h00, w00), _mm256_mul_ps(h10, w10)),
+                                 _mm256_add_ps(_mm256_mul_ps(h01, w01), _mm256_mul_ps(h11, w11)));
+        _mm256_storeu_ps(outHeights + i, h);
+
+        if (outNormals) {
+            // Normalen liegen interleaved (vec3) -> Index * 3 + Komponente
+            __m256i n00 = _mm256_mullo_epi32(i00, vThree), n10 = _mm256_mullo_epi32(i10, vThree);
+            __m256i n01 = _mm256_mullo_epi32(i01, vThree), n11 = _mm256_mullo_epi32(i11, vThree);
+            __m256 n[3];
+            for (int k = 0; k < 3; k++) {
+                const float* base = nrm + k;
+                n[k] = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_i32gather_ps(base, n00, 4), w00),
+                                                   _mm256_mul_ps(_mm256_i32gather_ps(base, n10, 4), w10)),
+                                     _mm256_add_ps(_mm256_mul_ps(_mm256_i32gather_ps(base, n01, 4), w01),
+                                                   _mm256_mul_ps(_mm256_i32gather_ps(base, n11, 4), w11)));
+            }
+            __m256 lenSq = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(n[0], n[0]), _mm256_mul_ps(n[1], n[1])), _mm256_mul_ps(n[2], n[2]));
+            __m256 invLen = _mm256_div_ps(vOne, _mm256_sqrt_ps(_mm256_max_ps(lenSq, _mm256_set1_ps(1e-12f))));
+            _mm256_store_ps(nx, _mm256_mul_ps(n[0], invLen));
+            _mm256_store_ps(ny, _mm256_mul_ps(n[1], invLen));
+            _mm256_store_ps(nz, _mm256_mul_ps(n[2], invLen));
+            for (int lane = 0; lane < 8; lane++) outNormals[i + lane] = glm::vec3(nx[lane], ny[lane], nz[lane]);
+        }
+
+        int fallback = (~_mm256_movemask_ps(inside) & 0xFF) | _mm256_movemask_ps(missing);
+        if (fallback) {
+            for (int lane = 0; lane < 8; lane++) {
+                if (!(fallback & (1 << lane))) continue;
+                TerrainSample s = sampleRaster(xs[i + lane], zs[i + lane]);
+                outHeights[i + lane] = s.height;
+                if (outNormals) outNormals[i + lane] = s.normal;
+            }
+        }
+    }
+    return i;
+#else
+    (void)xs; (void)zs; (void)count; (void)outHeights; (void)outNormals;
+    return 0;
+#endif
+}
+
+// --- MATERIAL-KLASSE (gleiche Gewichte wie terrain.fs.glsl) ---
+TerrainSurface TerrainQuery::getSurface(float x, float z, TerrainQueryMode mode) const {
+    TerrainSample s = sample(x, z, mode);
+    if (!s.valid) return TerrainSurface::None;
+
+    glm::vec3 w = computeMaterialWeights(s.height, s.normal.y);
+    if (w.x >= w.z && w.x >= w.y) return TerrainSurface::Pebbles;
+    if (w.z >= w.y) return TerrainSurface::Rock;
+    return TerrainSurface::Ground;
+}
+
+glm::vec3 TerrainQuery::computeMaterialWeights(float height, float normalY) {
+    auto smoothstep = [](float e0, float e1, float v) {
+        float t = std::clamp((v - e0) / (e1 - e0), 0.0f, 1.0f);
+        return t * t * (3.0f - 2.0f * t);
+    };
+
+    float pebblesWeight = 1.0f - smoothstep(-2.5f, -2.0f, height);
+    float rockWeight    = 1.0f - smoothstep(0.5f, 0.8f, normalY);
+    float groundWeight  = 1.0f - std::max(pebblesWeight, rockWeight);
+
+    float total = pebblesWeight + groundWeight + rockWeight;
+    return glm::vec3(pebblesWeight, groundWeight, rockWeight) / total;
+}
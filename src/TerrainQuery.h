@@ -0,0 +1,164 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <vector>
+#include <cstddef>
+#include <string>
+#include <cstdint>
+#include <shared_mutex>
+
+class Terrain;
+class TerrainCache;
+
+// Oberflächen-Klassen (entsprechen den Materialien im terrain.fs.glsl)
+enum class TerrainSurface {
+    None,     // Außerhalb des Terrains
+    Pebbles,  // Ufer / Kiesel (tiefe Bereiche)
+    Ground,   // Normaler Boden
+    Rock      // Steile Hänge
+};
+
+// Abfrage-Modus:
+// Exact  = Dreiecks-Lookup im Grid (genau, aber lineare Suche pro Zelle)
+// Raster = gebackenes Höhen-/Normalen-Raster mit bilinearer Interpolation (O(1))
+enum class TerrainQueryMode { Exact, Raster };
+
+// Pinsel-Modi für das Terrain-Sculpting
+enum class TerrainBrushMode { Raise, Lower, Smooth };
+
+// Was ein Pinselstrich verändert hat (Eingabe für die abhängigen Systeme)
+struct TerrainEdit {
+    std::vector<unsigned int> vertices;          // Vertices mit neuer Position oder Normale
+    std::vector<int> triangles;                  // Start-Indizes veränderter Dreiecke in getIndices()
+    glm::vec2 regionMin = glm::vec2(0.0f);       // betroffener XZ-Bereich (Welt)
+    glm::vec2 regionMax = glm::vec2(0.0f);
+    int rasterX0 = 0, rasterZ0 = 0, rasterX1 = -1, rasterZ1 = -1; // neu gebackene Raster-Texel (inklusive)
+    bool empty() const { return vertices.empty(); }
+};
+
+// Ergebnis einer Terrain-Abfrage (Höhe + Normale aus EINEM Dreiecks-Lookup)
+struct TerrainSample {
+    float height = -1000.0f;
+    glm::vec3 normal = glm::vec3(0.0f, 1.0f, 0.0f);
+    bool valid = false;
+};
+
+// Zentraler Terrain-Service:
+// Hält EINE skalierte Kopie der Terrain-Geometrie plus das Acceleration Grid.
+// Wird einmal aus dem Terrain gebaut und dann von GrassSystem, ForestSystem (und Picking) geteilt.
+// Nur der Editor (applyBrush) verändert die Daten, alle anderen Systeme lesen.
+// Andere Threads als der Haupt-Thread (z.B. GrassRing-Worker) lesen nur über sampleBatch, das gegen applyBrush sperrt.
+class TerrainQuery {
+public:
+    // Rückgabewert für Punkte außerhalb des Terrains (wie bisher in den Systemen)
+    static constexpr float NO_HEIGHT = -1000.0f;
+
+    // Mit gültigem Cache werden Geometrie, Grid und Raster übernommen statt aus dem Terrain gebaut
+    TerrainQuery(const Terrain& terrain, float terrainScale, TerrainCache* cache = nullptr,
+                 int gridResolution = 200, int rasterResolution = 1024);
+
+    // Parameter, die das Ergebnis beeinflussen (Teil des Cache-Schlüssels, gleiche Defaults wie oben)
+    static std::string cacheSignature(float terrainScale, int gridResolution = 200, int rasterResolution = 1024);
+
+    // Höhe an (x, z) in Weltkoordinaten, NO_HEIGHT wenn kein Dreieck getroffen wird
+    float getHeight(float x, float z, TerrainQueryMode mode = TerrainQueryMode::Exact) const;
+
+    // Interpolierte Vertex-Normale an (x, z), (0,1,0) außerhalb
+    glm::vec3 getNormal(float x, float z, TerrainQueryMode mode = TerrainQueryMode::Exact) const;
+
+    // Höhe und Normale in einem Durchgang
+    TerrainSample sample(float x, float z, TerrainQueryMode mode = TerrainQueryMode::Exact) const;
+
+    // Batch-Abfrage für viele Punkte auf einmal (Platzierung, Culling, Wasser-Schnitt).
+    // Raster-Modus ist mit SSE/AVX vektorisiert, Exact-Modus läuft skalar.
+    // outHeights[i] = NO_HEIGHT für Punkte ohne Terrain; outNormals darf nullptr sein.
+    // Threadsicher gegenüber applyBrush (geteilte Sperre).
+    void sampleBatch(const float* xs, const float* zs, size_t count,
+                     float* outHeights, glm::vec3* outNormals,
+                     TerrainQueryMode mode = TerrainQueryMode::Raster) const;
+
+    // Pinselstrich in Weltkoordinaten: verschiebt die Vertices im Radius vertikal (weicher Rand).
+    // Normalen, Grid-Einträge und Raster werden nur im betroffenen Bereich neu berechnet.
+    // amount = Höhenänderung in Welt-Einheiten (Raise/Lower) bzw. Mischfaktor zum Mittelwert (Smooth)
+    bool applyBrush(const glm::vec2& center, float radius, float amount, TerrainBrushMode mode, TerrainEdit& outEdit);
+
+    // Material-Klasse an (x, z), gleiche Regeln wie im Terrain-Shader
+    TerrainSurface getSurface(float x, float z, TerrainQueryMode mode = TerrainQueryMode::Exact) const;
+
+    // Normierte Material-Gewichte (pebbles, ground, rock) aus Höhe und Normale.y (Basis für die Splat Map)
+    static glm::vec3 computeMaterialWeights(float height, float normalY);
+
+    // Gebackenes Raster (Texel-Mittelpunkte liegen auf minX + i * rasterStepX)
+    int getRasterResolution() const { return rasterResolution; }
+    const std::vector<float>& getRasterHeights() const { return rasterHeights; }
+    const std::vector<glm::vec3>& getRasterNormals() const { return rasterNormals; }
+
+    // Grenzen (inkl. 1.0 Rand wie beim alten Grid)
+    float getMinX() const { return minX; }
+    float getMaxX() const { return maxX; }
+    float getMinZ() const { return minZ; }
+    float getMaxZ() const { return maxZ; }
+    float getScale() const { return scale; }
+    bool isInside(float x, float z) const { return x >= minX && x <= maxX && z >= minZ && z <= maxZ; }
+
+    // Read-only Zugriff auf die geteilte Geometrie (Weltkoordinaten)
+    const std::vector<glm::vec3>& getPositions() const { return positions; }
+    const std::vector<glm::vec3>& getNormals() const { return normals; }
+    const std::vector<unsigned int>& getIndices() const { return indices; }
+
+private:
+    // Skalierte Geometrie (nur Position + Normale, keine UVs/Tangenten)
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec3> normals;
+    std::vector<unsigned int> indices;
+
+    // applyBrush exklusiv, sampleBatch geteilt (Haupt-Thread-Leser brauchen keine Sperre)
+    mutable std::shared_mutex dataMutex;
+
+    float scale = 1.0f;
+    float minX = 0.0f, maxX = 0.0f, minZ = 0.0f, maxZ = 0.0f;
+
+    // Beschleunigungs-Gitter im CSR-Layout:
+    // Zelle c belegt die Einträge [cellOffsets[c], cellOffsets[c+1]) in den flachen Arrays.
+    // Pro Eintrag liegen die Dreiecks-Positionen als SoA direkt daneben (kein Umweg über indices).
+    int resolution = 200;
+    float cellWidth = 1.0f, cellDepth = 1.0f;
+    std::vector<int> cellOffsets;     // resolution * resolution + 1
+    std::vector<int> cellTriangles;   // Start-Index des Dreiecks in "indices"
+    struct CellTriangleData {
+        std::vector<float> x1, z1, x2, z2, x3, z3;
+        std::vector<float> y1, y2, y3;
+    } cellTris;
+
+    // Zellbereich eines Dreiecks (inklusive)
+    void getTriangleCells(size_t triStart, int& startX, int& endX, int& startZ, int& endZ) const;
+
+    // Gebackenes Höhen-/Normalen-Raster (rasterResolution x rasterResolution)
+    int rasterResolution = 1024;
+    float rasterStepX = 1.0f, rasterStepZ = 1.0f;
+    std::vector<float> rasterHeights;     // NO_HEIGHT = kein Terrain an diesem Texel
+    std::vector<glm::vec3> rasterNormals;
+
+    void buildGrid();
+    void bakeRaster();
+    bool loadFromCache(const TerrainCache& cache);
+
+    // Nachbarschaft für den Editor (CSR, wird beim ersten Pinselstrich gebaut):
+    // Vertex v gehört zu den Dreiecken vertexTriangles[vertexTriOffsets[v] .. vertexTriOffsets[v+1])
+    std::vector<int> vertexTriOffsets;
+    std::vector<int> vertexTriangles;
+    std::vector<uint32_t> vertexStamp, triangleStamp; // Deduplizierung pro Pinselstrich
+    uint32_t editStamp = 0;
+    void buildAdjacency();
+    void storeInCache(TerrainCache& cache) const;
+
+    TerrainSample sampleExact(float x, float z) const;
+    TerrainSample sampleRaster(float x, float z) const;
+
+    // Vektorisierte Raster-Lookups, liefern die Anzahl verarbeiteter Punkte (Rest skalar)
+    size_t sampleRasterSSE(const float* xs, const float* zs, size_t count, float* outHeights, glm::vec3* outNormals) const;
+    size_t sampleRasterAVX2(const float* xs, const float* zs, size_t count, float* outHeights, glm::vec3* outNormals) const;
+
+    // Sucht das Dreieck unter (x, z): liefert den Zell-Eintrag und die baryzentrischen Koordinaten
+    bool findTriangle(float x, float z, int& entry, float& l1, float& l2, float& l3) const;
+};
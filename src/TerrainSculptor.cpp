@@ -0,0 +1,29 @@
+#include "TerrainSculptor.h"
+#include "Terrain.h"
+#include "HeightmapTerrain.h"
+#include "TerrainBVH.h"
+#include "GrassSystem.h"
+#include "ForestSystem.h"
+#include "VirtualTexture.h"
+#include "TerrainLightBake.h"
+#include <chrono>
+
+TerrainSculptor::TerrainSculptor(TerrainQuery& q, Terrain& t, HeightmapTerrain& h, TerrainBVH& b, GrassSystem& g, ForestSystem& f)
+    : query(q), terrain(t), heightmapTerrain(h), bvh(b), grass(g), forest(f) {}
+
+bool TerrainSculptor::apply(const glm::vec3& center, float radius, float amount, TerrainBrushMode mode) {
+    auto start = std::chrono::high_resolution_clock::now();
+
+    if (!query.applyBrush(glm::vec2(center.x, center.z), radius, amount, mode, edit)) return false;
+
+    terrain.applyEdit(query, edit);
+    heightmapTerrain.applyEdit(query, edit);
+    bvh.refit(edit);
+    grass.resnapRegion(edit.regionMin, edit.regionMax);
+    forest.resnapRegion(edit.regionMin, edit.regionMax);
+    if (virtualTexture) virtualTexture->invalidateRegion(edit.regionMin, edit.regionMax);
+    if (lightBake) lightBake->invalidateRegion(edit.regionMin, edit.regionMax);
+
+    lastEditMs = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    return true;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include "TerrainQuery.h"
+
+class Terrain;
+class HeightmapTerrain;
+class TerrainBVH;
+class GrassSystem;
+class ForestSystem;
+class VirtualTexture;
+class TerrainLightBake;
+
+// Editor-Pinsel für das Terrain. Ein Strich ändert zuerst den TerrainQuery (Höhen, Normalen,
+// Grid, Raster) und reicht das Ergebnis (TerrainEdit) an alle abgeleiteten Daten weiter:
+// GPU-Vertices + Splat Map, CDLOD-Höhen, BVH, Vegetation und Virtual-Texture-Pages.
+// Alles arbeitet nur auf dem betroffenen Bereich, damit ein Strich pro Frame möglich ist.
+class TerrainSculptor {
+public:
+    TerrainSculptor(TerrainQuery& query, Terrain& terrain, HeightmapTerrain& heightmapTerrain,
+                    TerrainBVH& bvh, GrassSystem& grass, ForestSystem& forest);
+
+    // Virtual Texturing wird erst bei Bedarf angelegt (main.cpp), nullptr = aus
+    void setVirtualTexture(VirtualTexture* vt) { virtualTexture = vt; }
+
+    // Gebackene Beleuchtung: veränderte Bereiche werden vorgemerkt, main.cpp backt sie nach dem Strich neu
+    void setLightBake(TerrainLightBake* bake) { lightBake = bake; }
+
+    // Ein Strich an center (Welt), amount wie bei TerrainQuery::applyBrush. false = nichts verändert
+    bool apply(const glm::vec3& center, float radius, float amount, TerrainBrushMode mode);
+
+    float getLastEditMs() const { return lastEditMs; }
+
+private:
+    TerrainQuery& query;
+    Terrain& terrain;
+    HeightmapTerrain& heightmapTerrain;
+    TerrainBVH& bvh;
+    GrassSystem& grass;
+    ForestSystem& forest;
+    VirtualTexture* virtualTexture = nullptr;
+    TerrainLightBake* lightBake = nullptr;
+
+    TerrainEdit edit; // wiederverwendet (Vektoren behalten ihre Kapazität)
+    float lastEditMs = 0.0f;
+};
@@ -0,0 +1,556 @@
+#define GLM_ENABLE_EXPERIMENTAL
+#include "TerrainStreamer.h"
+#include "TerrainQuery.h"
+#include "Frustum.h"
+#include <glm/gtc/matrix_transform.hpp>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <algorithm>
+#include <iterator>
+#include <cmath>
+#include <cstring>
+
+// Datei-Layout eines Tiles: Header | uint16 Höhen | RGBA8 Splat (optional) | TerrainTileGrass
+namespace {
+    const char TILE_MAGIC[4] = { 'T', 'T', 'I', 'L' };
+    const uint32_t TILE_VERSION = 1;
+    const uint32_t MAX_TILE_RESOLUTION = 4097;
+    const uint32_t MAX_TILE_GRASS = 1u << 22;
+    const uint32_t MAX_GRASS_TYPES = 256;
+
+    struct TileFileHeader {
+        char magic[4];
+        uint32_t version;
+        uint32_t resolution;
+        uint32_t splatResolution;
+        uint32_t grassCount;
+        float heightMin;
+        float heightScale; // Höhe = heightMin + value * heightScale
+    };
+
+    // Bilinear in den Tile-Höhen, u/v in [0, 1] über das ganze Tile
+    float sampleTileHeight(const float* heights, int res, float u, float v) {
+        float fx = glm::clamp(u, 0.0f, 1.0f) * (float)(res - 1);
+        float fz = glm::clamp(v, 0.0f, 1.0f) * (float)(res - 1);
+        int x0 = std::min((int)fx, res - 2), z0 = std::min((int)fz, res - 2);
+        float tx = fx - (float)x0, tz = fz - (float)z0;
+        const float* row0 = heights + (size_t)z0 * res;
+        const float* row1 = row0 + res;
+        float h0 = row0[x0] + (row0[x0 + 1] - row0[x0]) * tx;
+        float h1 = row1[x0] + (row1[x0 + 1] - row1[x0]) * tx;
+        return h0 + (h1 - h0) * tz;
+    }
+
+    // Normale per Central Differences am Sample (x, z), spacing = Weltabstand der Samples
+    glm::vec3 sampleTileNormal(const std::vector<float>& heights, int res, int x, int z, float spacing) {
+        auto h = [&](int sx, int sz) {
+            return heights[(size_t)std::clamp(sz, 0, res - 1) * res + std::clamp(sx, 0, res - 1)];
+        };
+        float dx = (h(x + 1, z) - h(x - 1, z)) / (2.0f * spacing);
+        float dz = (h(x, z + 1) - h(x, z - 1)) / (2.0f * spacing);
+        return glm::normalize(glm::vec3(-dx, 1.0f, -dz));
+    }
+}
+
+TerrainStreamer::TerrainStreamer(const std::string& dir, TileGenerator gen, int workerCount)
+    : worldDirectory(dir), generator(std::move(gen)) {
+    stats.budgetBytes = (size_t)256 * 1024 * 1024;
+    loadWorldDescription();
+    createPatchMesh();
+
+    workerCount = std::max(1, workerCount);
+    for (int i = 0; i < workerCount; i++) workers.emplace_back(&TerrainStreamer::workerLoop, this);
+
+    std::cout << "Terrain Streaming: Tiles " << tileSize << "m, " << resolution << "^2 Samples, "
+              << workerCount << " Loader-Threads." << std::endl;
+}
+
+TerrainStreamer::~TerrainStreamer() {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopWorkers = true;
+    }
+    queueCondition.notify_all();
+    for (auto& worker : workers) {
+        if (worker.joinable()) worker.join();
+    }
+
+    for (auto& entry : tiles) deleteGpu(entry.second.gpu);
+    for (auto& gpu : gpuPool) deleteGpu(gpu);
+    glDeleteVertexArrays(1, &VAO);
+    glDeleteBuffers(1, &VBO);
+    glDeleteBuffers(1, &EBO);
+}
+
+// --- WELT-BESCHREIBUNG ---
+// world.txt, eine Angabe pro Zeile:
+//   tileSize 128
+//   resolution 129
+//   tiles <minX> <minZ> <maxX> <maxZ>   (optional, sonst unbegrenzt)
+void TerrainStreamer::loadWorldDescription() {
+    std::ifstream file(worldDirectory + "/world.txt");
+    if (!file) {
+        std::cout << "Terrain Streaming: Keine world.txt in " << worldDirectory << ", nutze Standardwerte." << std::endl;
+        return;
+    }
+
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream in(line);
+        std::string name;
+        if (!(in >> name) || name[0] == '#') continue;
+        if (name == "tileSize") in >> tileSize;
+        else if (name == "resolution") in >> resolution;
+        else if (name == "tiles") in >> tileMin.x >> tileMin.y >> tileMax.x >> tileMax.y;
+        else std::cout << "Terrain Streaming: Unbekannter Eintrag in world.txt: " << name << std::endl;
+    }
+    tileSize = std::max(tileSize, 1.0f);
+    resolution = std::clamp(resolution, 2, (int)MAX_TILE_RESOLUTION);
+}
+
+void TerrainStreamer::createPatchMesh() {
+    // Gleiches Vertex-Format wie der CDLOD-Patch: Grid-Position in [0, 1] auf xz
+    int grid = resolution - 1;
+    std::vector<float> vertices;
+    vertices.reserve((size_t)(grid + 1) * (grid + 1) * 3);
+    for (int z = 0; z <= grid; z++) {
+        for (int x = 0; x <= grid; x++) {
+            vertices.insert(vertices.end(), { (float)x / (float)grid, 0.0f, (float)z / (float)grid });
+        }
+    }
+    std::vector<unsigned int> indices;
+    indices.reserve((size_t)grid * grid * 6);
+    for (int z = 0; z < grid; z++) {
+        for (int x = 0; x < grid; x++) {
+            unsigned int a = z * (grid + 1) + x;
+            unsigned int b = a + 1;
+            unsigned int c = a + (grid + 1);
+            unsigned int d = c + 1;
+            indices.insert(indices.end(), { a, c, d, a, d, b });
+        }
+    }
+    patchIndexCount = (unsigned int)indices.size();
+
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &VBO);
+    glGenBuffers(1, &EBO);
+
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
+
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    // Location 4 (offset.xz, Größe, LOD) bleibt als Array aus und wird pro Tile per glVertexAttrib4f gesetzt
+    glBindVertexArray(0);
+}
+
+// --- ANFORDERUNG ---
+size_t TerrainStreamer::estimateTileBytes() const {
+    if (averageTileBytes > 0) return averageTileBytes;
+    // Höhen CPU + GPU, Splat-Textur
+    return (size_t)resolution * resolution * (sizeof(float) * 2 + 4);
+}
+
+void TerrainStreamer::requestTiles(const glm::vec3& camPos) {
+    // Kandidaten: Ring um die Kamera, dazu ein Ring um die vorhergesagte Position (etwas niedrigere Priorität)
+    std::unordered_map<uint64_t, float> priority;
+    auto addRing = [&](const glm::vec2& center, float penalty) {
+        int cx = (int)std::floor(center.x / tileSize);
+        int cz = (int)std::floor(center.y / tileSize);
+        float maxDistance = ((float)loadRadius + 0.5f) * tileSize;
+        for (int z = cz - loadRadius; z <= cz + loadRadius; z++) {
+            for (int x = cx - loadRadius; x <= cx + loadRadius; x++) {
+                if (x < tileMin.x || x > tileMax.x || z < tileMin.y || z > tileMax.y) continue;
+                glm::vec2 tileCenter = (glm::vec2((float)x, (float)z) + 0.5f) * tileSize;
+                float d = glm::distance(center, tileCenter);
+                if (d > maxDistance) continue;
+                uint64_t key = makeKey(x, z);
+                auto it = priority.find(key);
+                if (it == priority.end()) priority[key] = d + penalty;
+                else it->second = std::min(it->second, d + penalty);
+            }
+        }
+    };
+    glm::vec2 current(camPos.x, camPos.z);
+    glm::vec2 predicted = current + glm::vec2(velocity.x, velocity.z) * PREFETCH_SECONDS;
+    addRing(current, 0.0f);
+    if (glm::distance(current, predicted) > tileSize * 0.5f) addRing(predicted, tileSize * 0.5f);
+
+    std::vector<std::pair<float, uint64_t>> ordered;
+    ordered.reserve(priority.size());
+    for (const auto& p : priority) ordered.push_back({ p.second, p.first });
+    std::sort(ordered.begin(), ordered.end());
+
+    // Nur so viele Tiles, wie ins Budget passen (sonst würde ständig geladen und wieder verdrängt)
+    wantedTiles.clear();
+    size_t estimate = estimateTileBytes();
+    size_t total = 0;
+    for (const auto& p : ordered) {
+        if (!wantedTiles.empty() && total + estimate > stats.budgetBytes) break;
+        total += estimate;
+        wantedTiles.insert(p.second);
+    }
+
+    // Queue komplett ersetzen: Anforderungen außerhalb des Rings verfallen, bevor sie geladen werden
+    std::lock_guard<std::mutex> lock(queueMutex);
+    for (uint64_t key : loadQueue) requestedTiles.erase(key);
+    loadQueue.clear();
+    for (const auto& p : ordered) {
+        uint64_t key = p.second;
+        if (!wantedTiles.count(key)) continue;
+        auto it = tiles.find(key);
+        if (it != tiles.end()) {
+            it->second.lastUsed = frame;
+            continue;
+        }
+        if (requestedTiles.insert(key).second) loadQueue.push_back(key);
+    }
+    queueCondition.notify_all();
+}
+
+// --- UPDATE ---
+void TerrainStreamer::update(const glm::vec3& camPos, float deltaTime, const GrassSystem& grass) {
+    frame++;
+
+    // Geschwindigkeit geglättet über ~1/4 Sekunde, Sprünge (Teleport) setzen sie zurück
+    if (hasLastCamPos && deltaTime > 0.0f) {
+        glm::vec3 moved = camPos - lastCamPos;
+        if (glm::length(moved) > tileSize * 2.0f) velocity = glm::vec3(0.0f);
+        else velocity = glm::mix(velocity, moved / deltaTime, std::min(1.0f, deltaTime * 4.0f));
+    }
+    lastCamPos = camPos;
+    hasLastCamPos = true;
+
+    requestTiles(camPos);
+
+    // Fertige Tiles übernehmen (begrenzt pro Frame, damit ein Tile-Wechsel keinen Hänger auslöst)
+    std::vector<LoadedTile> ready;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        size_t take = std::min(loadedTiles.size(), (size_t)MAX_UPLOADS_PER_FRAME);
+        ready.assign(std::make_move_iterator(loadedTiles.begin()), std::make_move_iterator(loadedTiles.begin() + take));
+        loadedTiles.erase(loadedTiles.begin(), loadedTiles.begin() + take);
+        for (const auto& tile : ready) requestedTiles.erase(tile.key);
+    }
+    if (!ready.empty()) queueCondition.notify_all(); // Loader warten, solange MAX_READY_TILES fertig herumliegen
+
+    for (auto& loaded : ready) {
+        if (!wantedTiles.count(loaded.key)) continue; // Kamera ist inzwischen woanders
+        uploadTile(loaded, grass);
+    }
+
+    // Über dem Budget (z.B. nach Verkleinern in den Settings): alles Ungenutzte verdrängen
+    while (stats.residentBytes > stats.budgetBytes && evictLeastRecentlyUsed()) {}
+
+    stats.tilesResident = (int)tiles.size();
+    std::lock_guard<std::mutex> lock(queueMutex);
+    stats.tilesPending = (int)requestedTiles.size();
+}
+
+// --- RESIDENZ ---
+void TerrainStreamer::uploadTile(LoadedTile& loaded, const GrassSystem& grass) {
+    Tile tile;
+    tile.lastUsed = frame;
+    tile.hasTerrain = loaded.hasTerrain;
+    tile.bytes = sizeof(Tile);
+
+    if (loaded.hasTerrain) {
+        TerrainTileData& data = loaded.data;
+        size_t heightBytes = data.heights.size() * sizeof(float);
+        tile.bytes += heightBytes * 2 + data.splat.size() + loaded.grassInstances.size() * sizeof(GrassInstance);
+    }
+
+    // Platz schaffen. Gelingt das nicht (alles in diesem Frame benutzt), war die Schätzung zu klein:
+    // das Tile kommt trotzdem, averageTileBytes wird korrigiert und der nächste Frame fordert weniger an.
+    while (stats.residentBytes + tile.bytes > stats.budgetBytes && evictLeastRecentlyUsed()) {}
+
+    if (loaded.hasTerrain) {
+        TerrainTileData& data = loaded.data;
+        if (!gpuPool.empty()) {
+            tile.gpu = std::move(gpuPool.back());
+            gpuPool.pop_back();
+        }
+        TileGpu& gpu = tile.gpu;
+
+        auto uploadTexture = [](unsigned int& texture, int& currentSize, int size, GLenum internalFormat,
+                                GLenum format, GLenum type, const void* pixels) {
+            if (texture == 0) glGenTextures(1, &texture);
+            glBindTexture(GL_TEXTURE_2D, texture);
+            if (currentSize == size) {
+                glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, size, size, format, type, pixels);
+                return;
+            }
+            currentSize = size;
+            glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, size, size, 0, format, type, pixels);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        };
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        uploadTexture(gpu.heightTexture, gpu.heightResolution, data.resolution, GL_R32F, GL_RED, GL_FLOAT, data.heights.data());
+        uploadTexture(gpu.splatTexture, gpu.splatResolution, data.splatResolution, GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE, data.splat.data());
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        grass.uploadBatch(gpu.grass, loaded.grassInstances, loaded.grassOffsets);
+
+        tile.heightRange = loaded.heightRange;
+        tile.resolution = data.resolution;
+        tile.heights = std::move(data.heights);
+    }
+
+    stats.residentBytes += tile.bytes;
+    averageTileBytes = averageTileBytes ? (averageTileBytes * 7 + tile.bytes) / 8 : tile.bytes;
+    tiles[loaded.key] = std::move(tile);
+}
+
+bool TerrainStreamer::evictLeastRecentlyUsed() {
+    auto victim = tiles.end();
+    for (auto it = tiles.begin(); it != tiles.end(); ++it) {
+        if (it->second.lastUsed >= frame) continue; // in diesem Frame benutzt
+        if (victim == tiles.end() || it->second.lastUsed < victim->second.lastUsed) victim = it;
+    }
+    if (victim == tiles.end()) return false;
+
+    releaseGpu(victim->second.gpu);
+    stats.residentBytes -= std::min(stats.residentBytes, victim->second.bytes);
+    tiles.erase(victim);
+    return true;
+}
+
+void TerrainStreamer::releaseGpu(TileGpu& gpu) {
+    if (gpu.heightTexture == 0) return;
+    if ((int)gpuPool.size() < POOL_SIZE) {
+        gpuPool.push_back(std::move(gpu));
+        gpu = TileGpu();
+    } else {
+        deleteGpu(gpu);
+    }
+}
+
+void TerrainStreamer::deleteGpu(TileGpu& gpu) {
+    glDeleteTextures(1, &gpu.heightTexture);
+    glDeleteTextures(1, &gpu.splatTexture);
+    GrassSystem::destroyBatch(gpu.grass);
+    gpu = TileGpu();
+}
+
+// --- ZEICHNEN ---
+void TerrainStreamer::draw(Shader& shader, const glm::mat4& viewProj, const glm::vec3& camPos) {
+    visibleGrass.clear();
+    stats.tilesDrawn = 0;
+    if (tiles.empty()) return;
+
+    Frustum frustum(viewProj);
+    shader.use();
+    shader.setBool("useHeightmap", true);
+    shader.setInt("heightMap", HEIGHT_TEXTURE_UNIT);
+    shader.setInt("splatMap", SPLAT_MAP_UNIT);
+    shader.setFloat("patchGrid", (float)(resolution - 1));
+    // Kein Morph: jedes Tile wird in voller Auflösung gezeichnet, Nachbarn teilen sich die Rand-Samples
+    shader.setVec2("morphRanges[0]", glm::vec2(1e30f));
+
+    glBindVertexArray(VAO);
+    for (auto& entry : tiles) {
+        const Tile& tile = entry.second;
+        if (!tile.hasTerrain) continue;
+
+        glm::vec2 origin = glm::vec2((float)keyX(entry.first), (float)keyZ(entry.first)) * tileSize;
+        glm::vec3 bMin(origin.x, tile.heightRange.x, origin.y);
+        glm::vec3 bMax(origin.x + tileSize, tile.heightRange.y, origin.y + tileSize);
+        if (!frustum.isBoxVisible(bMin, bMax)) continue;
+
+        shader.setVec2("heightmapWorldMin", origin);
+        shader.setVec2("heightmapWorldSize", glm::vec2(tileSize));
+        shader.setVec2("splatWorldMin", origin);
+        shader.setVec2("splatWorldSize", glm::vec2(tileSize));
+        glVertexAttrib4f(4, origin.x, origin.y, tileSize, 0.0f);
+
+        glActiveTexture(GL_TEXTURE0 + HEIGHT_TEXTURE_UNIT); glBindTexture(GL_TEXTURE_2D, tile.gpu.heightTexture);
+        glActiveTexture(GL_TEXTURE0 + SPLAT_MAP_UNIT); glBindTexture(GL_TEXTURE_2D, tile.gpu.splatTexture);
+        glDrawElements(GL_TRIANGLES, patchIndexCount, GL_UNSIGNED_INT, 0);
+        stats.tilesDrawn++;
+
+        glm::vec2 center = origin + 0.5f * tileSize;
+        if (tile.gpu.grass.VAO != 0 && glm::distance(center, glm::vec2(camPos.x, camPos.z)) < GRASS_DISTANCE * tileSize)
+            visibleGrass.push_back(&tile.gpu.grass);
+    }
+    glBindVertexArray(0);
+
+    glActiveTexture(GL_TEXTURE0);
+    shader.setBool("useHeightmap", false);
+}
+
+bool TerrainStreamer::getHeight(float x, float z, float& outHeight) const {
+    int tx = (int)std::floor(x / tileSize);
+    int tz = (int)std::floor(z / tileSize);
+    auto it = tiles.find(makeKey(tx, tz));
+    if (it == tiles.end() || !it->second.hasTerrain) return false;
+    const Tile& tile = it->second;
+    outHeight = sampleTileHeight(tile.heights.data(), tile.resolution,
+                                 x / tileSize - (float)tx, z / tileSize - (float)tz);
+    return true;
+}
+
+// --- LOADER-THREADS ---
+void TerrainStreamer::workerLoop() {
+    while (true) {
+        LoadedTile tile;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueCondition.wait(lock, [this] {
+                return stopWorkers || (!loadQueue.empty() && (int)loadedTiles.size() < MAX_READY_TILES);
+            });
+            if (stopWorkers) return;
+            tile.key = loadQueue.front();
+            loadQueue.pop_front();
+        }
+
+        decodeTile(tile);
+
+        std::lock_guard<std::mutex> lock(queueMutex);
+        loadedTiles.push_back(std::move(tile));
+    }
+}
+
+void TerrainStreamer::decodeTile(LoadedTile& tile) const {
+    int tx = keyX(tile.key), tz = keyZ(tile.key);
+    TerrainTileData& data = tile.data;
+
+    // 1. Von der Platte, sonst aus dem Generator
+    std::string path = worldDirectory + "/tiles/" + std::to_string(tx) + "_" + std::to_string(tz) + ".tile";
+    tile.hasTerrain = loadTile(path, data);
+    if (!tile.hasTerrain && generator) {
+        data = TerrainTileData();
+        tile.hasTerrain = generator(tx, tz, tileSize, resolution, data) &&
+                          data.resolution >= 2 && data.heights.size() == (size_t)data.resolution * data.resolution;
+    }
+    if (!tile.hasTerrain) {
+        data = TerrainTileData();
+        return;
+    }
+
+    int res = data.resolution;
+    auto range = std::minmax_element(data.heights.begin(), data.heights.end());
+    tile.heightRange = glm::vec2(*range.first, *range.second);
+    float spacing = tileSize / (float)(res - 1);
+
+    // 2. Material-Gewichte aus Höhe + Steigung ableiten, wenn das Tile keine mitbringt
+    if (data.splatResolution <= 0 || data.splat.size() != (size_t)data.splatResolution * data.splatResolution * 4) {
+        data.splatResolution = res;
+        data.splat.assign((size_t)res * res * 4, 255);
+        for (int z = 0; z < res; z++) {
+            for (int x = 0; x < res; x++) {
+                size_t i = (size_t)z * res + x;
+                glm::vec3 n = sampleTileNormal(data.heights, res, x, z, spacing);
+                glm::vec3 w = TerrainQuery::computeMaterialWeights(data.heights[i], n.y);
+                data.splat[i * 4 + 0] = (unsigned char)(w.x * 255.0f + 0.5f);
+                data.splat[i * 4 + 1] = (unsigned char)(w.y * 255.0f + 0.5f);
+                data.splat[i * 4 + 2] = (unsigned char)(w.z * 255.0f + 0.5f);
+            }
+        }
+    }
+
+    // 3. Gras-Instanzen nach Typ sortiert (Counting Sort), aufgebaut wie in GrassSystem::addGrassType
+    glm::vec2 origin = glm::vec2((float)tx, (float)tz) * tileSize;
+    data.grass.erase(std::remove_if(data.grass.begin(), data.grass.end(),
+                                    [](const TerrainTileGrass& g) { return g.type >= MAX_GRASS_TYPES; }), data.grass.end());
+    uint32_t typeCount = 0;
+    for (const auto& g : data.grass) typeCount = std::max(typeCount, g.type + 1);
+    tile.grassOffsets.assign(typeCount + 1, 0);
+    for (const auto& g : data.grass) tile.grassOffsets[g.type + 1]++;
+    for (uint32_t t = 0; t < typeCount; t++) tile.grassOffsets[t + 1] += tile.grassOffsets[t];
+
+    std::vector<int> cursor(tile.grassOffsets.begin(), tile.grassOffsets.end() - 1);
+    tile.grassInstances.resize(data.grass.size());
+    const glm::vec3 up(0.0f, 1.0f, 0.0f);
+    for (const auto& g : data.grass) {
+        float u = (g.x - origin.x) / tileSize, v = (g.z - origin.y) / tileSize;
+        float y = sampleTileHeight(data.heights.data(), res, u, v);
+        int sx = std::clamp((int)std::lround(u * (float)(res - 1)), 0, res - 1);
+        int sz = std::clamp((int)std::lround(v * (float)(res - 1)), 0, res - 1);
+        glm::vec3 normal = sampleTileNormal(data.heights, res, sx, sz, spacing);
+
+        glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(g.x, y, g.z));
+        model = glm::rotate(model, g.rotation, up);
+        glm::vec3 rotAxis = glm::cross(up, normal);
+        if (glm::length(rotAxis) > 0.001f) {
+            float angle = std::acos(glm::clamp(glm::dot(up, normal), -1.0f, 1.0f));
+            model = glm::rotate(model, angle * 0.8f, glm::normalize(rotAxis));
+        }
+        model = glm::scale(model, glm::vec3(g.scale));
+        tile.grassInstances[cursor[g.type]++] = GrassSystem::encodeInstance(model);
+    }
+    std::vector<TerrainTileGrass>().swap(data.grass);
+}
+
+// --- TILE-DATEIEN ---
+bool TerrainStreamer::saveTile(const std::string& path, const TerrainTileData& data) {
+    int res = data.resolution;
+    if (res < 2 || data.heights.size() != (size_t)res * res) return false;
+    bool hasSplat = data.splatResolution > 0 && data.splat.size() == (size_t)data.splatResolution * data.splatResolution * 4;
+
+    auto range = std::minmax_element(data.heights.begin(), data.heights.end());
+    TileFileHeader header;
+    std::memcpy(header.magic, TILE_MAGIC, sizeof(TILE_MAGIC));
+    header.version = TILE_VERSION;
+    header.resolution = (uint32_t)res;
+    header.splatResolution = hasSplat ? (uint32_t)data.splatResolution : 0;
+    header.grassCount = (uint32_t)data.grass.size();
+    header.heightMin = *range.first;
+    header.heightScale = std::max(*range.second - *range.first, 1e-6f) / 65535.0f;
+
+    std::vector<uint16_t> quantized(data.heights.size());
+    for (size_t i = 0; i < quantized.size(); i++) {
+        float q = (data.heights[i] - header.heightMin) / header.heightScale;
+        quantized[i] = (uint16_t)std::clamp((int)std::lround(q), 0, 65535);
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        std::cout << "Terrain Streaming: Kann " << path << " nicht schreiben." << std::endl;
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(quantized.data()), quantized.size() * sizeof(uint16_t));
+    if (hasSplat) file.write(reinterpret_cast<const char*>(data.splat.data()), data.splat.size());
+    file.write(reinterpret_cast<const char*>(data.grass.data()), data.grass.size() * sizeof(TerrainTileGrass));
+    return (bool)file;
+}
+
+bool TerrainStreamer::loadTile(const std::string& path, TerrainTileData& out) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return false;
+
+    TileFileHeader header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, TILE_MAGIC, sizeof(TILE_MAGIC)) != 0 || header.version != TILE_VERSION ||
+        header.resolution < 2 || header.resolution > MAX_TILE_RESOLUTION ||
+        header.splatResolution > MAX_TILE_RESOLUTION || header.grassCount > MAX_TILE_GRASS) {
+        std::cout << "Terrain Streaming: Ungültiges Tile " << path << std::endl;
+        return false;
+    }
+
+    size_t samples = (size_t)header.resolution * header.resolution;
+    std::vector<uint16_t> quantized(samples);
+    out.resolution = (int)header.resolution;
+    out.splatResolution = (int)header.splatResolution;
+    out.splat.resize((size_t)header.splatResolution * header.splatResolution * 4);
+    out.grass.resize(header.grassCount);
+    file.read(reinterpret_cast<char*>(quantized.data()), samples * sizeof(uint16_t));
+    file.read(reinterpret_cast<char*>(out.splat.data()), out.splat.size());
+    file.read(reinterpret_cast<char*>(out.grass.data()), out.grass.size() * sizeof(TerrainTileGrass));
+    if (!file) {
+        std::cout << "Terrain Streaming: Tile abgeschnitten " << path << std::endl;
+        return false;
+    }
+
+    out.heights.resize(samples);
+    for (size_t i = 0; i < samples; i++) out.heights[i] = header.heightMin + (float)quantized[i] * header.heightScale;
+    return true;
+}
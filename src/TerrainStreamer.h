@@ -0,0 +1,172 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include <string>
+#include <deque>
+#include <unordered_map>
+#include <unordered_set>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+#include "Shader.h"
+#include "GrassSystem.h"
+
+// Ein Gras-Halm in einem Tile (die Höhe kommt beim Laden aus den Tile-Höhen)
+struct TerrainTileGrass {
+    float x, z;        // Weltkoordinaten
+    float scale;
+    float rotation;    // um Y, Radiant
+    uint32_t type;     // Gras-Typ im GrassSystem (Reihenfolge von addGrassType)
+};
+static_assert(sizeof(TerrainTileGrass) == 20, "TerrainTileGrass muss 20 Byte groß sein");
+
+// Inhalt eines Tiles, so wie er von der Platte oder aus dem Generator kommt
+struct TerrainTileData {
+    int resolution = 0;                 // Höhen-Samples pro Seite, die Rand-Samples teilen sich Nachbar-Tiles
+    std::vector<float> heights;         // resolution², Zeile für Zeile in +Z
+    int splatResolution = 0;            // 0 = Material-Gewichte beim Laden aus den Höhen ableiten
+    std::vector<unsigned char> splat;   // RGBA8 (pebbles, ground, rock), wie die Splat Map des Terrain
+    std::vector<TerrainTileGrass> grass;
+};
+
+// Statistiken für die UI
+struct TerrainStreamStats {
+    int tilesResident = 0;
+    int tilesPending = 0;   // angefordert, im Loader oder fertig aber noch nicht hochgeladen
+    int tilesDrawn = 0;
+    size_t residentBytes = 0;
+    size_t budgetBytes = 0;
+};
+
+// Gekachelte Welt, die um die Kamera herum nachgeladen wird.
+// - Format: <worldDirectory>/world.txt (Tile-Größe, Auflösung, Tile-Bereich) + <worldDirectory>/tiles/<x>_<z>.tile,
+//   fehlende Tiles erzeugt der TileGenerator (falls gesetzt)
+// - Loader-Threads dekodieren Tiles (Höhen, Material-Gewichte, Gras-Instanzen), der Haupt-Thread lädt höchstens
+//   MAX_UPLOADS_PER_FRAME Tiles pro Frame hoch (GPU-Objekte kommen aus einem Pool, keine Neuallokation)
+// - Speicher: LRU über alle residenten Tiles gegen ein Byte-Budget; angefordert wird nur, was ins Budget passt
+// - Prefetch: Ring um die Kamera + Ring um die per Geschwindigkeit vorhergesagte Position
+// Gezeichnet wird mit dem Heightmap-Pfad des Terrain-Shaders (ein Grid-Patch pro Tile).
+class TerrainStreamer {
+public:
+    // Füllt ein Tile, das nicht auf der Platte liegt. false = dort gibt es kein Terrain.
+    // Läuft in den Loader-Threads, darf also nur read-only auf geteilte Daten zugreifen.
+    using TileGenerator = std::function<bool(int tileX, int tileZ, float tileSize, int resolution, TerrainTileData& out)>;
+
+    TerrainStreamer(const std::string& worldDirectory, TileGenerator generator = nullptr, int workerCount = 2);
+    ~TerrainStreamer();
+
+    TerrainStreamer(const TerrainStreamer&) = delete;
+    TerrainStreamer& operator=(const TerrainStreamer&) = delete;
+
+    // 1x pro Frame: Geschwindigkeit schätzen, Anforderungen erneuern, fertige Tiles hochladen, LRU verdrängen
+    void update(const glm::vec3& camPos, float deltaTime, const GrassSystem& grass);
+
+    // Zeichnet alle residenten Tiles im Frustum mit dem Terrain-Shader (Heightmap-Modus)
+    // und sammelt die Gras-Batches der nahen Tiles für drawBatches()
+    void draw(Shader& shader, const glm::mat4& viewProj, const glm::vec3& camPos);
+    const std::vector<const GrassBatch*>& getVisibleGrass() const { return visibleGrass; }
+
+    // Höhe aus den residenten Tiles (false, wenn das Tile nicht geladen ist)
+    bool getHeight(float x, float z, float& outHeight) const;
+
+    void setMemoryBudget(size_t bytes) { stats.budgetBytes = bytes; }
+    void setLoadRadius(int tiles) { loadRadius = tiles; }
+
+    const TerrainStreamStats& getStats() const { return stats; }
+
+    // Schreibt ein Tile im Streaming-Format (Höhen werden auf 16 Bit pro Tile quantisiert)
+    static bool saveTile(const std::string& path, const TerrainTileData& data);
+    static bool loadTile(const std::string& path, TerrainTileData& out);
+
+private:
+    static constexpr int MAX_UPLOADS_PER_FRAME = 2;
+    static constexpr int MAX_READY_TILES = 8;       // fertig dekodiert, aber noch nicht hochgeladen
+    static constexpr int POOL_SIZE = 4;             // freie GPU-Slots, die für neue Tiles bereitliegen
+    static constexpr float PREFETCH_SECONDS = 3.0f; // so weit wird die Bewegung vorausgesagt
+    static constexpr float GRASS_DISTANCE = 1.5f;   // in Tiles, Gras weiter weg wird nicht gezeichnet
+    static constexpr int HEIGHT_TEXTURE_UNIT = 9;   // wie HeightmapTerrain
+    static constexpr int SPLAT_MAP_UNIT = 11;       // wie Terrain
+
+    // Tile-Schlüssel: x | z (je 32 Bit mit Vorzeichen)
+    static uint64_t makeKey(int x, int z) { return ((uint64_t)(uint32_t)x << 32) | (uint32_t)z; }
+    static int keyX(uint64_t key) { return (int)(int32_t)(uint32_t)(key >> 32); }
+    static int keyZ(uint64_t key) { return (int)(int32_t)(uint32_t)(key & 0xFFFFFFFFu); }
+
+    // world.txt
+    std::string worldDirectory;
+    float tileSize = 128.0f;
+    int resolution = 129;
+    glm::ivec2 tileMin = glm::ivec2(-(1 << 20));
+    glm::ivec2 tileMax = glm::ivec2(1 << 20);
+    int loadRadius = 4;
+
+    // GPU-Objekte eines Tiles (werden über den Pool wiederverwendet)
+    struct TileGpu {
+        unsigned int heightTexture = 0;
+        unsigned int splatTexture = 0;
+        int heightResolution = 0;
+        int splatResolution = 0;
+        GrassBatch grass;
+    };
+
+    struct Tile {
+        uint64_t lastUsed = 0;
+        size_t bytes = 0;
+        bool hasTerrain = false;
+        glm::vec2 heightRange = glm::vec2(0.0f); // min, max für Frustum Culling
+        int resolution = 0;
+        std::vector<float> heights;              // CPU-Kopie für getHeight()
+        TileGpu gpu;
+    };
+    std::unordered_map<uint64_t, Tile> tiles;
+    std::vector<TileGpu> gpuPool;
+    uint64_t frame = 0;
+    size_t averageTileBytes = 0;
+
+    // Bewegungsschätzung für den Prefetch
+    glm::vec3 lastCamPos = glm::vec3(0.0f);
+    glm::vec3 velocity = glm::vec3(0.0f);
+    bool hasLastCamPos = false;
+
+    // Grid-Patch (res - 1 Quads pro Seite), gemeinsam für alle Tiles
+    unsigned int VAO = 0, VBO = 0, EBO = 0;
+    unsigned int patchIndexCount = 0;
+
+    TerrainStreamStats stats;
+    std::vector<const GrassBatch*> visibleGrass;
+
+    // Loader-Threads
+    struct LoadedTile {
+        uint64_t key;
+        bool hasTerrain = false;
+        TerrainTileData data;
+        glm::vec2 heightRange = glm::vec2(0.0f);
+        std::vector<GrassInstance> grassInstances; // nach Typ sortiert
+        std::vector<int> grassOffsets;
+    };
+    TileGenerator generator;
+    std::vector<std::thread> workers;
+    std::mutex queueMutex;
+    std::condition_variable queueCondition;
+    bool stopWorkers = false;
+    std::deque<uint64_t> loadQueue;
+    std::unordered_set<uint64_t> requestedTiles; // in der Queue, im Loader oder fertig aber noch nicht hochgeladen
+    std::vector<LoadedTile> loadedTiles;
+    std::unordered_set<uint64_t> wantedTiles;    // Ergebnis von requestTiles() in diesem Frame
+
+    void loadWorldDescription();
+    void createPatchMesh();
+    void requestTiles(const glm::vec3& camPos);
+    void uploadTile(LoadedTile& loaded, const GrassSystem& grass);
+    bool evictLeastRecentlyUsed();
+    void releaseGpu(TileGpu& gpu);
+    static void deleteGpu(TileGpu& gpu);
+    size_t estimateTileBytes() const;
+
+    void workerLoop();
+    void decodeTile(LoadedTile& tile) const;
+};
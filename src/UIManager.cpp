@@ -4,6 +4,7 @@
 
 #include <glm/gtc/type_ptr.hpp>
 #include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
 
 UIManager::UIManager(GLFWwindow* window)
     : m_window(window), m_isFullscreen(false), m_vsyncEnabled(true)
@@ -35,7 +36,8 @@ void UIManager::renderUI(Camera& camera, SceneManager& sceneManager,
                          const glm::mat4& view, const glm::mat4& projection,
                          bool& useNormalMap, bool& useARMMap,
                          bool& limitFps, int& fpsLimit,
-                         bool& enableFog, float& fogDensity, bool& isDay)
+                         bool& enableFog, float& fogDensity, bool& isDay,
+                         TerrainSettings& terrainSettings, const RenderStats& stats)
 {
     ImGuizmo::SetOrthographic(false);
     ImGuizmo::AllowAxisFlip(false);
@@ -172,6 +174,26 @@ void UIManager::renderUI(Camera& camera, SceneManager& sceneManager,
                 // Logik passiert automatisch in main loop, da isDay referenziert ist
             }
 
+            ImGui::Separator();
+            ImGui::Text("Terrain");
+            ImGui::Checkbox("Heightmap Terrain (CDLOD)", &terrainSettings.useHeightmapTerrain);
+            ImGui::Checkbox("Virtual Texturing", &terrainSettings.useVirtualTexture);
+            ImGui::Checkbox("Clamp Camera to Ground", &terrainSettings.clampCameraToGround);
+            ImGui::Checkbox("Baked AO / Horizon Shadows", &terrainSettings.useBakedLighting);
+            ImGui::Combo("Sculpt Brush", &terrainSettings.sculptMode, "Off\0Raise\0Lower\0Smooth\0");
+            if (terrainSettings.sculptMode > 0) {
+                ImGui::SliderFloat("Brush Radius", &terrainSettings.sculptRadius, 1.0f, 50.0f);
+                ImGui::SliderFloat("Brush Strength", &terrainSettings.sculptStrength, 0.1f, 20.0f);
+            }
+            ImGui::SliderFloat("Grass Full Density", &terrainSettings.grassFullDensityDistance, 5.0f, 100.0f);
+            ImGui::SliderFloat("Grass Max Distance", &terrainSettings.grassMaxDistance, 20.0f, 400.0f);
+            ImGui::Checkbox("Terrain Streaming", &terrainSettings.useTerrainStreaming);
+            if (terrainSettings.useTerrainStreaming) {
+                ImGui::SliderInt("Streaming Budget (MB)", &terrainSettings.streamingBudgetMB, 32, 2048);
+                ImGui::SliderInt("Streaming Radius (Tiles)", &terrainSettings.streamingRadius, 1, 12);
+                ImGui::InputInt("World Seed", &terrainSettings.worldSeed);
+            }
+
             ImGui::Separator();
             if(ImGui::TreeNode("Water Settings")) {
                 ImGui::SliderFloat("Water Height", &sceneManager.env.waterHeight, -10.0f, 5.0f);
@@ -183,6 +205,48 @@ void UIManager::renderUI(Camera& camera, SceneManager& sceneManager,
             ImGui::EndTabItem();
         }
 
+        if (ImGui::BeginTabItem("Stats")) {
+            ImGui::Text("FPS: %.1f", io.Framerate);
+            ImGui::Separator();
+            ImGui::Text("Terrain");
+            if (stats.terrainPatches > 0) {
+                ImGui::Text("CDLOD Patches: %d (%d LOD-Stufen)", stats.terrainPatches, stats.terrainLodCount);
+            } else {
+                ImGui::Text("Chunks: %d / %d", stats.terrainChunksVisible, stats.terrainChunksTotal);
+            }
+            ImGui::Text("Dreiecke: %d / %d", stats.terrainTrianglesDrawn, stats.terrainTrianglesTotal);
+            if (stats.terrainTrianglesTotal > 0) {
+                ImGui::ProgressBar((float)stats.terrainTrianglesDrawn / (float)stats.terrainTrianglesTotal);
+            }
+            if (stats.vtResidentPages > 0 || stats.vtPendingPages > 0) {
+                ImGui::Text("VT Pages: %d geladen, %d ausstehend", stats.vtResidentPages, stats.vtPendingPages);
+            }
+            if (stats.streamTilesResident > 0 || stats.streamTilesPending > 0) {
+                ImGui::Text("Tiles: %d geladen, %d ausstehend, %d gezeichnet",
+                            stats.streamTilesResident, stats.streamTilesPending, stats.streamTilesDrawn);
+                ImGui::Text("Tile-Speicher: %.1f MB", stats.streamMemoryMB);
+            }
+            if (stats.grassChunksTotal > 0 || stats.grassPatchCardsDrawn > 0) {
+                ImGui::Separator();
+                ImGui::Text("Gras");
+                ImGui::Text("Chunks: %d / %d (%d Draws)", stats.grassChunksVisible, stats.grassChunksTotal, stats.grassDrawCalls);
+                ImGui::Text("Instanzen: %d / %d", stats.grassInstancesDrawn, stats.grassInstancesTotal);
+                ImGui::ProgressBar((float)stats.grassInstancesDrawn / (float)std::max(stats.grassInstancesTotal, 1));
+                if (stats.grassPatchCardsDrawn > 0) ImGui::Text("Patch-Karten: %d", stats.grassPatchCardsDrawn);
+                if (stats.grassRingBufferMB > 0.0f) {
+                    ImGui::Text("Ring: %d Tiles, %d ausstehend (%.1f MB fest)",
+                                stats.grassRingTilesResident, stats.grassRingTilesPending, stats.grassRingBufferMB);
+                }
+            }
+            if (stats.lightBakeMs > 0.0f) {
+                ImGui::Text("Licht-Bake: %.1f ms", stats.lightBakeMs);
+            }
+            if (stats.sculptMs > 0.0f) {
+                ImGui::Text("Letzter Pinselstrich: %.2f ms", stats.sculptMs);
+            }
+            ImGui::EndTabItem();
+        }
+
         ImGui::EndTabBar();
     }
 
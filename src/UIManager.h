@@ -9,6 +9,50 @@
 #include "imgui.h"
 #include "ImGuizmo.h" // Stelle sicher, dass ImGuizmo.h im src Ordner liegt
 
+// Render-Statistiken für den "Stats"-Tab (werden in main.cpp pro Frame gefüllt)
+struct RenderStats {
+    int terrainChunksVisible = 0;
+    int terrainChunksTotal = 0;
+    int terrainTrianglesDrawn = 0;
+    int terrainTrianglesTotal = 0;
+    int terrainPatches = 0;     // nur im CDLOD-Modus
+    int terrainLodCount = 0;
+    int vtResidentPages = 0;    // nur mit Virtual Texturing
+    int vtPendingPages = 0;
+    float sculptMs = 0.0f;      // Dauer des letzten Pinselstrichs
+    float lightBakeMs = 0.0f;   // Dauer des letzten Licht-Bakes (voll oder Editor-Bereich)
+    int streamTilesResident = 0; // nur mit Terrain Streaming
+    int streamTilesPending = 0;
+    int streamTilesDrawn = 0;
+    float streamMemoryMB = 0.0f;
+    int grassChunksVisible = 0;  // nur ohne Terrain Streaming
+    int grassChunksTotal = 0;
+    int grassInstancesDrawn = 0;
+    int grassInstancesTotal = 0;
+    int grassDrawCalls = 0;
+    int grassPatchCardsDrawn = 0; // prozedurale Patches (--grass-patches)
+    int grassRingTilesResident = 0; // Gras-Ring (--grass-ring)
+    int grassRingTilesPending = 0;
+    float grassRingBufferMB = 0.0f;
+};
+
+// Terrain-Optionen, die im "Settings"-Tab umgeschaltet werden
+struct TerrainSettings {
+    bool useHeightmapTerrain = false; // CDLOD Heightmap statt Mesh-Chunks
+    bool useVirtualTexture = false;   // Albedo aus dem Virtual Texture statt gekachelter Materialien
+    bool clampCameraToGround = false; // Freie Kamera per BVH-Raycast über dem Terrain halten
+    bool useBakedLighting = true;     // Gebackenes AO + Horizont-Schatten in Terrain-, Gras- und Objekt-Shadern
+    int sculptMode = 0;               // 0 = aus, 1 = anheben, 2 = absenken, 3 = glätten (Linksklick im Menü-Modus)
+    float sculptRadius = 10.0f;
+    float sculptStrength = 4.0f;      // Höhe pro Sekunde (Glätten: Mischfaktor pro Sekunde)
+    bool useTerrainStreaming = false; // Gekachelte Welt aus assets/world statt der Landschaft
+    int streamingBudgetMB = 256;      // Speicher für residente Tiles (LRU)
+    int streamingRadius = 4;          // Lade-Radius in Tiles
+    int worldSeed = 1;                // Seed des TerrainGenerator für Tiles, die nicht auf der Platte liegen
+    float grassFullDensityDistance = 30.0f; // Gras-LOD: volle Dichte bis hier, danach ausgedünnt
+    float grassMaxDistance = 180.0f;        // dahinter kein Gras
+};
+
 class UIManager {
 public:
     UIManager(GLFWwindow* window);
@@ -20,7 +64,8 @@ public:
     // RenderUI braucht jetzt View & Projection Matrix für das 3D-Gizmo
     void renderUI(Camera& camera, SceneManager& sm, const glm::mat4& view, const glm::mat4& proj,
               bool& useNormal, bool& useARM, bool& limitFps, int& fpsLimit,
-              bool& enableFog, float& fogDensity, bool& isDay); // <--- Hier
+              bool& enableFog, float& fogDensity, bool& isDay,
+              TerrainSettings& terrainSettings, const RenderStats& stats);
 
     void toggleFullscreen();
     void setVSync(bool enabled);
@@ -0,0 +1,392 @@
+#include "VirtualTexture.h"
+#include <stb_image.h>
+#include <iostream>
+#include <algorithm>
+#include <iterator>
+#include <cmath>
+
+VirtualTexture::VirtualTexture(const std::string& dir, const glm::vec2& wMin, const glm::vec2& wSize,
+                               PageGenerator gen, int pages, int physicalPages)
+    : tileDirectory(dir), worldMin(wMin), worldSize(wSize),
+      pagesPerSide(pages), physicalPagesPerSide(physicalPages), generator(std::move(gen)) {
+    mipCount = 1;
+    while ((pagesPerSide >> (mipCount - 1)) > 1) mipCount++;
+
+    // Page Table: Mip-Kette, eine Stufe pro Virtual-Mip (Nearest, wird per texelFetch gelesen)
+    pageTable.resize(mipCount);
+    pageSlot.resize(mipCount);
+    pageGeneration.resize(mipCount);
+    glGenTextures(1, &pageTableTexture);
+    glBindTexture(GL_TEXTURE_2D, pageTableTexture);
+    for (int mip = 0; mip < mipCount; mip++) {
+        int n = pagesPerSide >> mip;
+        pageTable[mip].assign((size_t)n * n, 0);
+        pageSlot[mip].assign((size_t)n * n, -1);
+        pageGeneration[mip].assign((size_t)n * n, 0);
+        glTexImage2D(GL_TEXTURE_2D, mip, GL_RGBA8, n, n, 0, GL_RGBA, GL_UNSIGNED_BYTE, pageTable[mip].data());
+    }
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, mipCount - 1);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+    // Physischer Atlas (fester Speicher, keine Mipmaps: die Mip-Auswahl passiert über die Pages)
+    int atlasSize = physicalPagesPerSide * PAGE_SIZE;
+    glGenTextures(1, &physicalTexture);
+    glBindTexture(GL_TEXTURE_2D, physicalTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, atlasSize, atlasSize, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    slots.resize((size_t)physicalPagesPerSide * physicalPagesPerSide);
+
+    feedbackShader = new Shader("../shaders/terrain.vs.glsl", "../shaders/vt_feedback.fs.glsl");
+    glGenBuffers(2, feedbackPBO);
+
+    loaderThread = std::thread(&VirtualTexture::loaderLoop, this);
+
+    // Gröbste Page sofort anfordern: sie bleibt immer resident und ist der Fallback für alles
+    uint32_t root = makeKey(mipCount - 1, 0, 0);
+    requestedPages.insert(root);
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        loadQueue.push_back({ root, 0 });
+    }
+    queueCondition.notify_one();
+
+    std::cout << "Virtual Texture: " << pagesPerSide * PAGE_CONTENT << "^2 Texel virtuell, "
+              << atlasSize << "^2 Atlas, " << mipCount << " Mip-Stufen." << std::endl;
+}
+
+VirtualTexture::~VirtualTexture() {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopLoader = true;
+    }
+    queueCondition.notify_all();
+    if (loaderThread.joinable()) loaderThread.join();
+
+    delete feedbackShader;
+    glDeleteTextures(1, &pageTableTexture);
+    glDeleteTextures(1, &physicalTexture);
+    glDeleteFramebuffers(1, &feedbackFBO);
+    glDeleteTextures(1, &feedbackColor);
+    glDeleteRenderbuffers(1, &feedbackDepth);
+    glDeleteBuffers(2, feedbackPBO);
+}
+
+// --- FEEDBACK ---
+void VirtualTexture::createFeedbackTargets(int width, int height) {
+    glDeleteFramebuffers(1, &feedbackFBO);
+    glDeleteTextures(1, &feedbackColor);
+    glDeleteRenderbuffers(1, &feedbackDepth);
+
+    feedbackWidth = width;
+    feedbackHeight = height;
+
+    glGenFramebuffers(1, &feedbackFBO);
+    glBindFramebuffer(GL_FRAMEBUFFER, feedbackFBO);
+
+    // (pageX, pageZ, mip, gültig) als Integer-Textur
+    glGenTextures(1, &feedbackColor);
+    glBindTexture(GL_TEXTURE_2D, feedbackColor);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16UI, width, height, 0, GL_RGBA_INTEGER, GL_UNSIGNED_SHORT, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, feedbackColor, 0);
+
+    glGenRenderbuffers(1, &feedbackDepth);
+    glBindRenderbuffer(GL_RENDERBUFFER, feedbackDepth);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, feedbackDepth);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        std::cout << "ERROR::FRAMEBUFFER:: Virtual Texture Feedback FBO is not complete!" << std::endl;
+
+    // Zwei PBOs: Frame N liest asynchron, Frame N+1 wertet aus (kein Stall auf die GPU)
+    size_t bytes = (size_t)width * height * 4 * sizeof(uint16_t);
+    for (int i = 0; i < 2; i++) {
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, feedbackPBO[i]);
+        glBufferData(GL_PIXEL_PACK_BUFFER, bytes, nullptr, GL_STREAM_READ);
+        feedbackPending[i] = false;
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void VirtualTexture::beginFeedback(int screenWidth, int screenHeight) {
+    frame++;
+    int w = std::max(1, screenWidth / FEEDBACK_SCALE);
+    int h = std::max(1, screenHeight / FEEDBACK_SCALE);
+    if (w != feedbackWidth || h != feedbackHeight) createFeedbackTargets(w, h);
+
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &savedFramebuffer);
+    glGetIntegerv(GL_VIEWPORT, savedViewport);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, feedbackFBO);
+    glViewport(0, 0, feedbackWidth, feedbackHeight);
+    const GLuint clearColor[4] = { 0, 0, 0, 0 };
+    glClearBufferuiv(GL_COLOR, 0, clearColor);
+    glClear(GL_DEPTH_BUFFER_BIT);
+
+    feedbackShader->use();
+    feedbackShader->setVec2("vtWorldMin", worldMin);
+    feedbackShader->setVec2("vtWorldSize", worldSize);
+    feedbackShader->setFloat("vtPagesPerSide", (float)pagesPerSide);
+    feedbackShader->setFloat("vtMaxMip", (float)(mipCount - 1));
+    feedbackShader->setFloat("vtFeedbackScale", (float)FEEDBACK_SCALE);
+}
+
+void VirtualTexture::endFeedback() {
+    // 1. Aktuelles Feedback asynchron ins PBO kopieren
+    glReadBuffer(GL_COLOR_ATTACHMENT0);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, feedbackPBO[feedbackIndex]);
+    glReadPixels(0, 0, feedbackWidth, feedbackHeight, GL_RGBA_INTEGER, GL_UNSIGNED_SHORT, nullptr);
+    feedbackPending[feedbackIndex] = true;
+
+    // 2. Feedback vom letzten Frame auswerten
+    int previous = feedbackIndex ^ 1;
+    if (feedbackPending[previous]) {
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, feedbackPBO[previous]);
+        const uint16_t* pixels = (const uint16_t*)glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
+        if (pixels) {
+            processFeedback(pixels, feedbackWidth * feedbackHeight);
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        }
+        feedbackPending[previous] = false;
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    feedbackIndex = previous;
+
+    glBindFramebuffer(GL_FRAMEBUFFER, savedFramebuffer);
+    glViewport(savedViewport[0], savedViewport[1], savedViewport[2], savedViewport[3]);
+}
+
+void VirtualTexture::processFeedback(const uint16_t* pixels, int count) {
+    // Eindeutige Pages aus dem Feedback sammeln
+    std::unordered_set<uint32_t> visible;
+    for (int i = 0; i < count; i++) {
+        const uint16_t* p = &pixels[i * 4];
+        if (p[3] == 0) continue;
+        int mip = std::min((int)p[2], mipCount - 1);
+        int n = pagesPerSide >> mip;
+        if (p[0] >= n || p[1] >= n) continue;
+        visible.insert(makeKey(mip, p[0], p[1]));
+    }
+
+    // Sichtbare Pages + alle Vorfahren als benutzt markieren, fehlende anfordern
+    std::vector<uint32_t> missing;
+    std::unordered_set<uint32_t> handled;
+    for (uint32_t key : visible) {
+        int mip = keyMip(key), x = keyX(key), z = keyZ(key);
+        for (; mip < mipCount; mip++, x >>= 1, z >>= 1) {
+            uint32_t k = makeKey(mip, x, z);
+            if (!handled.insert(k).second) break; // Vorfahren wurden schon behandelt
+            int slot = pageSlot[mip][(size_t)z * (pagesPerSide >> mip) + x];
+            if (slot >= 0) slots[slot].lastUsed = std::max(slots[slot].lastUsed, frame);
+            else missing.push_back(k);
+        }
+    }
+
+    // Grobe Pages zuerst: sie sind schneller da und decken die feinen als Fallback ab
+    std::sort(missing.begin(), missing.end(), [](uint32_t a, uint32_t b) { return keyMip(a) > keyMip(b); });
+
+    // Queue komplett ersetzen: nicht mehr sichtbare Anforderungen verfallen
+    std::lock_guard<std::mutex> lock(queueMutex);
+    for (const PageRequest& request : loadQueue) requestedPages.erase(request.key);
+    loadQueue.clear();
+    for (uint32_t key : missing) {
+        if (requestedPages.insert(key).second) loadQueue.push_back({ key, generationOf(key) });
+    }
+    queueCondition.notify_one();
+}
+
+// --- RESIDENZ ---
+int VirtualTexture::acquireSlot() {
+    int best = -1;
+    for (int i = 0; i < (int)slots.size(); i++) {
+        if (slots[i].key == INVALID_PAGE) return i;
+        // In diesem Frame benutzte Pages bleiben, die gröbste Page ist fest (lastUsed = max)
+        if (slots[i].lastUsed >= frame) continue;
+        if (best < 0 || slots[i].lastUsed < slots[best].lastUsed) best = i;
+    }
+    return best;
+}
+
+void VirtualTexture::update() {
+    std::vector<LoadedPage> ready;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        size_t take = std::min(loadedPages.size(), (size_t)MAX_UPLOADS_PER_FRAME);
+        ready.assign(std::make_move_iterator(loadedPages.begin()), std::make_move_iterator(loadedPages.begin() + take));
+        loadedPages.erase(loadedPages.begin(), loadedPages.begin() + take);
+    }
+    if (ready.empty() && dirtyPages.empty()) return;
+
+    glBindTexture(GL_TEXTURE_2D, physicalTexture);
+    for (auto& page : ready) {
+        requestedPages.erase(page.key);
+        // Während des Ladens invalidiert: Inhalt ist veraltet, das Feedback fordert die Page neu an
+        if (page.generation != generationOf(page.key)) continue;
+        int slot = acquireSlot();
+        if (slot < 0) continue; // Atlas voll mit sichtbaren Pages, wird später neu angefordert
+
+        // Alte Page verdrängen
+        Slot& s = slots[slot];
+        if (s.key != INVALID_PAGE) {
+            pageSlot[keyMip(s.key)][(size_t)keyZ(s.key) * (pagesPerSide >> keyMip(s.key)) + keyX(s.key)] = -1;
+            residentCount--;
+            dirtyPages.push_back(s.key);
+        }
+
+        int mip = keyMip(page.key);
+        s.key = page.key;
+        s.lastUsed = (mip == mipCount - 1) ? UINT64_MAX : frame;
+        pageSlot[mip][(size_t)keyZ(page.key) * (pagesPerSide >> mip) + keyX(page.key)] = slot;
+        residentCount++;
+
+        int sx = slot % physicalPagesPerSide, sy = slot / physicalPagesPerSide;
+        glTexSubImage2D(GL_TEXTURE_2D, 0, sx * PAGE_SIZE, sy * PAGE_SIZE, PAGE_SIZE, PAGE_SIZE,
+                        GL_RGBA, GL_UNSIGNED_BYTE, page.data.data());
+        dirtyPages.push_back(page.key);
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    if (!dirtyPages.empty()) updatePageTable();
+}
+
+void VirtualTexture::invalidateRegion(const glm::vec2& regionMin, const glm::vec2& regionMax) {
+    for (int mip = 0; mip < mipCount - 1; mip++) {
+        int n = pagesPerSide >> mip;
+        glm::vec2 pageWorld = worldSize / (float)n;
+        // Rand der Pages mitnehmen (PAGE_BORDER Texel ragen in die Nachbarn)
+        glm::vec2 border = pageWorld * ((float)PAGE_BORDER / (float)PAGE_CONTENT);
+        int x0 = std::clamp((int)std::floor((regionMin.x - border.x - worldMin.x) / pageWorld.x), 0, n - 1);
+        int x1 = std::clamp((int)std::floor((regionMax.x + border.x - worldMin.x) / pageWorld.x), 0, n - 1);
+        int z0 = std::clamp((int)std::floor((regionMin.y - border.y - worldMin.y) / pageWorld.y), 0, n - 1);
+        int z1 = std::clamp((int)std::floor((regionMax.y + border.y - worldMin.y) / pageWorld.y), 0, n - 1);
+        for (int z = z0; z <= z1; z++) {
+            for (int x = x0; x <= x1; x++) {
+                pageGeneration[mip][(size_t)z * n + x]++; // auch Pages in der Queue oder im Loader
+                int& slot = pageSlot[mip][(size_t)z * n + x];
+                if (slot < 0) continue;
+                dirtyPages.push_back(slots[slot].key);
+                slots[slot] = Slot();
+                slot = -1;
+                residentCount--;
+            }
+        }
+    }
+}
+
+// Jeder Eintrag zeigt auf die eigene Page oder (falls nicht geladen) auf den nächsten geladenen Vorfahren.
+// Eine geänderte Page betrifft nur ihren eigenen Eintrag und die Einträge darunter, die sie überdeckt
+// (2^k x 2^k auf k Stufen tiefer). Nur diese Rechtecke werden neu geschrieben und hochgeladen.
+void VirtualTexture::updatePageTable() {
+    // Grobe Pages zuerst, Pages mit ebenfalls geänderten Vorfahren deckt deren Rechteck schon ab
+    std::sort(dirtyPages.begin(), dirtyPages.end(), [](uint32_t a, uint32_t b) { return keyMip(a) > keyMip(b); });
+    std::unordered_set<uint32_t> written;
+
+    glBindTexture(GL_TEXTURE_2D, pageTableTexture);
+    for (uint32_t key : dirtyPages) {
+        int mip = keyMip(key), x = keyX(key), z = keyZ(key);
+        bool covered = false;
+        for (int m = mip + 1, px = x >> 1, pz = z >> 1; m < mipCount && !covered; m++, px >>= 1, pz >>= 1)
+            covered = written.count(makeKey(m, px, pz)) > 0;
+        if (covered || !written.insert(key).second) continue;
+        writePageTableRegion(mip, x, z);
+    }
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    dirtyPages.clear();
+}
+
+// Eintrag (mip, x, z) und alle überdeckten Einträge der feineren Stufen, Page Table gebunden
+void VirtualTexture::writePageTableRegion(int mip, int x, int z) {
+    for (int m = mip, size = 1; m >= 0; m--, x <<= 1, z <<= 1, size <<= 1) {
+        int n = pagesPerSide >> m;
+        for (int tz = z; tz < z + size; tz++) {
+            for (int tx = x; tx < x + size; tx++) {
+                size_t i = (size_t)tz * n + tx;
+                int slot = pageSlot[m][i];
+                if (slot >= 0) {
+                    uint32_t sx = slot % physicalPagesPerSide, sy = slot / physicalPagesPerSide;
+                    pageTable[m][i] = sx | (sy << 8) | ((uint32_t)m << 16) | (255u << 24);
+                } else if (m < mipCount - 1) {
+                    pageTable[m][i] = pageTable[m + 1][(size_t)(tz >> 1) * (n >> 1) + (tx >> 1)];
+                } else {
+                    pageTable[m][i] = 0; // Alpha 0 = noch nichts geladen
+                }
+            }
+        }
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, n);
+        glTexSubImage2D(GL_TEXTURE_2D, m, x, z, size, size, GL_RGBA, GL_UNSIGNED_BYTE, &pageTable[m][(size_t)z * n + x]);
+    }
+}
+
+void VirtualTexture::bind(Shader& shader) const {
+    glActiveTexture(GL_TEXTURE0 + PAGE_TABLE_UNIT); glBindTexture(GL_TEXTURE_2D, pageTableTexture);
+    glActiveTexture(GL_TEXTURE0 + PHYSICAL_UNIT); glBindTexture(GL_TEXTURE_2D, physicalTexture);
+    glActiveTexture(GL_TEXTURE0);
+
+    shader.use();
+    shader.setBool("useVirtualTexture", true);
+    shader.setInt("vtPageTable", PAGE_TABLE_UNIT);
+    shader.setInt("vtPhysical", PHYSICAL_UNIT);
+    shader.setVec2("vtWorldMin", worldMin);
+    shader.setVec2("vtWorldSize", worldSize);
+    shader.setFloat("vtPagesPerSide", (float)pagesPerSide);
+    shader.setFloat("vtMaxMip", (float)(mipCount - 1));
+    shader.setFloat("vtPhysicalPages", (float)physicalPagesPerSide);
+}
+
+// --- LOADER THREAD ---
+void VirtualTexture::loaderLoop() {
+    while (true) {
+        PageRequest request;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueCondition.wait(lock, [this] { return stopLoader || !loadQueue.empty(); });
+            if (stopLoader) return;
+            request = loadQueue.front();
+            loadQueue.pop_front();
+        }
+
+        LoadedPage page;
+        page.key = request.key;
+        page.generation = request.generation;
+        loadPage(request.key, page.data);
+
+        std::lock_guard<std::mutex> lock(queueMutex);
+        loadedPages.push_back(std::move(page));
+    }
+}
+
+void VirtualTexture::loadPage(uint32_t key, std::vector<unsigned char>& out) const {
+    int mip = keyMip(key), x = keyX(key), z = keyZ(key);
+    out.assign((size_t)PAGE_SIZE * PAGE_SIZE * 4, 0);
+
+    // 1. Von der Platte
+    std::string path = tileDirectory + "/" + std::to_string(mip) + "/" + std::to_string(x) + "_" + std::to_string(z) + ".png";
+    int w, h, n;
+    unsigned char* data = stbi_load(path.c_str(), &w, &h, &n, 4);
+    if (data) {
+        if (w == PAGE_SIZE && h == PAGE_SIZE) {
+            std::copy(data, data + out.size(), out.begin());
+            stbi_image_free(data);
+            return;
+        }
+        std::cout << "Virtual Texture: falsche Page-Größe " << w << "x" << h << ": " << path << std::endl;
+        stbi_image_free(data);
+    }
+
+    // 2. Sonst erzeugen (Weltbereich der Page inkl. Rand)
+    if (generator) {
+        glm::vec2 pageWorld = worldSize / (float)(pagesPerSide >> mip);
+        glm::vec2 texelWorld = pageWorld / (float)PAGE_CONTENT;
+        glm::vec2 regionMin = worldMin + glm::vec2((float)x, (float)z) * pageWorld - texelWorld * (float)PAGE_BORDER;
+        generator(regionMin, texelWorld * (float)PAGE_SIZE, out.data());
+    }
+}
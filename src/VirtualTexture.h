@@ -0,0 +1,131 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include <string>
+#include <deque>
+#include <unordered_set>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+#include "Shader.h"
+
+// Virtual Texturing für die Terrain-Albedo über die XZ-Ausdehnung des Terrains.
+// - Page Table: eine Mip-Stufe pro Virtual-Mip, Eintrag = physischer Slot (+ Mip der Page, die ihn füllt)
+// - Physischer Atlas: feste Anzahl Page-Slots (GPU-Speicher unabhängig von der Größe der Gesamt-Textur)
+// - Feedback: Terrain wird in niedriger Auflösung mit vt_feedback.fs.glsl gerendert und per PBO zurückgelesen
+// - Loader-Thread: lädt Pages von der Platte (<tileDirectory>/<mip>/<x>_<z>.png, PAGE_SIZE² inkl. Rand)
+//   oder erzeugt sie über den PageGenerator, falls keine Datei existiert
+class VirtualTexture {
+public:
+    static constexpr int PAGE_SIZE = 128;   // Texel pro physischer Page (inkl. Rand)
+    static constexpr int PAGE_BORDER = 4;   // Rand für bilineare Filterung an Page-Grenzen
+    static constexpr int PAGE_CONTENT = PAGE_SIZE - 2 * PAGE_BORDER;
+
+    // Füllt eine Page (RGBA8, PAGE_SIZE x PAGE_SIZE). regionMin/regionSize = Weltbereich inkl. Rand.
+    // Läuft im Loader-Thread, darf also nur read-only auf geteilte Daten zugreifen.
+    using PageGenerator = std::function<void(const glm::vec2& regionMin, const glm::vec2& regionSize, unsigned char* out)>;
+
+    // pagesPerSide = Pages auf Mip 0 pro Seite (Zweierpotenz), physicalPagesPerSide = Atlas-Größe in Pages
+    VirtualTexture(const std::string& tileDirectory, const glm::vec2& worldMin, const glm::vec2& worldSize,
+                   PageGenerator generator, int pagesPerSide = 512, int physicalPagesPerSide = 32);
+    ~VirtualTexture();
+
+    // Feedback-Pass: bindet das kleine Integer-FBO, dazwischen Terrain mit getFeedbackShader() zeichnen
+    void beginFeedback(int screenWidth, int screenHeight);
+    void endFeedback();
+
+    // Fertig geladene Pages hochladen und Page Table aktualisieren (1x pro Frame)
+    void update();
+
+    // Verwirft alle geladenen Pages über dem Weltbereich (z.B. nach einem Terrain-Edit),
+    // das Feedback fordert sie danach neu an. Die gröbste Page bleibt als Fallback.
+    void invalidateRegion(const glm::vec2& regionMin, const glm::vec2& regionMax);
+
+    // Page Table + Atlas binden und die vt*-Uniforms setzen
+    void bind(Shader& shader) const;
+
+    Shader& getFeedbackShader() { return *feedbackShader; }
+    int getResidentPages() const { return residentCount; }
+    int getPendingPages() const { return (int)requestedPages.size(); }
+
+private:
+    static constexpr int PAGE_TABLE_UNIT = 12;
+    static constexpr int PHYSICAL_UNIT = 13;
+    static constexpr int FEEDBACK_SCALE = 8;      // Feedback in 1/8 der Bildschirmauflösung
+    static constexpr int MAX_UPLOADS_PER_FRAME = 16;
+    static constexpr uint32_t INVALID_PAGE = 0xFFFFFFFFu;
+
+    std::string tileDirectory;
+    glm::vec2 worldMin, worldSize;
+    int pagesPerSide;
+    int physicalPagesPerSide;
+    int mipCount;
+
+    // Page-Schlüssel: mip | z | x (je 13 Bit für x/z)
+    static uint32_t makeKey(int mip, int x, int z) { return ((uint32_t)mip << 26) | ((uint32_t)z << 13) | (uint32_t)x; }
+    static int keyMip(uint32_t key) { return (int)(key >> 26); }
+    static int keyZ(uint32_t key) { return (int)((key >> 13) & 0x1FFF); }
+    static int keyX(uint32_t key) { return (int)(key & 0x1FFF); }
+
+    // GPU
+    unsigned int pageTableTexture = 0;
+    unsigned int physicalTexture = 0;
+    std::vector<std::vector<uint32_t>> pageTable; // RGBA8 pro Mip: (slotX, slotY, pageMip, 255)
+    std::vector<uint32_t> dirtyPages;             // geladen oder verdrängt seit dem letzten updatePageTable()
+
+    // Physische Slots (LRU über lastUsed)
+    struct Slot {
+        uint32_t key = INVALID_PAGE;
+        uint64_t lastUsed = 0;
+    };
+    std::vector<Slot> slots;
+    std::vector<std::vector<int>> pageSlot;       // pro Mip/Page: Slot-Index oder -1
+    std::vector<std::vector<uint32_t>> pageGeneration; // pro Mip/Page: erhöht bei invalidateRegion, ältere Ergebnisse werden verworfen
+    std::unordered_set<uint32_t> requestedPages;  // in der Queue, im Loader oder fertig aber noch nicht hochgeladen
+    int residentCount = 0;
+    uint64_t frame = 0;
+
+    // Feedback
+    Shader* feedbackShader = nullptr;
+    unsigned int feedbackFBO = 0, feedbackColor = 0, feedbackDepth = 0;
+    unsigned int feedbackPBO[2] = { 0, 0 };
+    bool feedbackPending[2] = { false, false };
+    int feedbackIndex = 0;
+    int feedbackWidth = 0, feedbackHeight = 0;
+    GLint savedFramebuffer = 0;
+    GLint savedViewport[4] = { 0, 0, 0, 0 };
+
+    // Loader-Thread
+    struct PageRequest {
+        uint32_t key;
+        uint32_t generation;
+    };
+    struct LoadedPage {
+        uint32_t key;
+        uint32_t generation;
+        std::vector<unsigned char> data;
+    };
+    PageGenerator generator;
+    std::thread loaderThread;
+    std::mutex queueMutex;
+    std::condition_variable queueCondition;
+    bool stopLoader = false;
+    std::deque<PageRequest> loadQueue;
+    std::vector<LoadedPage> loadedPages;
+
+    void createFeedbackTargets(int width, int height);
+    void processFeedback(const uint16_t* pixels, int count);
+    uint32_t generationOf(uint32_t key) const {
+        return pageGeneration[keyMip(key)][(size_t)keyZ(key) * (pagesPerSide >> keyMip(key)) + keyX(key)];
+    }
+    void updatePageTable();
+    void writePageTableRegion(int mip, int x, int z);
+    int acquireSlot();
+
+    void loaderLoop();
+    void loadPage(uint32_t key, std::vector<unsigned char>& out) const;
+};
@@ -19,25 +19,58 @@
 #include "Skybox.h"
 #include "GrassSystem.h"
 #include "ForestSystem.h" // Neu
+#include "TerrainQuery.h"
+#include "HeightmapTerrain.h"
+#include "VirtualTexture.h"
+#include "TerrainBVH.h"
+#include "TerrainCache.h"
+#include "TerrainSculptor.h"
+#include "TerrainStreamer.h"
+#include "TerrainLightBake.h"
+#include "TerrainGenerator.h"
 
 #include <iostream>
 #include <vector>
 #include <string>
 #include <thread>
+#include <memory>
+#include <cstdlib>
+#include <algorithm>
 
 const unsigned int SCR_WIDTH = 1280, SCR_HEIGHT = 720;
 const float NEAR_PLANE = 0.1f, FAR_PLANE = 1000.0f;
 
 bool useNormalMap = true, useARMMap = true, limitFps = true, enableFog = true, isDay = true;
 int fpsLimit = 120;
+TerrainSettings terrainSettings;
 float fogDensity = 0.025f;
 
 glm::vec3 fogColorDay(0.5f, 0.6f, 0.7f), fogColorNight(0.05f, 0.05f, 0.1f);
 
 void framebuffer_size_callback(GLFWwindow* window, int width, int height) { glViewport(0, 0, width, height); }
 
-int main()
+int main(int argc, char** argv)
 {
+    // --procedural [seed] [size]: Testwelt aus dem TerrainGenerator statt landscape.glb (für Last- und Skalierungstests)
+    bool proceduralTerrain = false;
+    TerrainGeneratorSettings proceduralSettings;
+    float proceduralSize = 1024.0f;
+    // --grass-patches: dichtes Gras als prozedurale Patches im Vertex-Shader statt 800k Instanzen pro Typ
+    bool grassPatches = false;
+    // --grass-ring: Gras in Tiles um die Kamera nachladen statt einmal im Radius 190 um den Ursprung
+    bool grassRing = false;
+    // --grass-seed <seed>: Gras-Platzierung, unabhängig vom Terrain-Seed (gleiches Gras bei jedem --procedural Seed)
+    uint32_t grassSeed = 1;
+    for (int i = 1; i < argc; i++) {
+        if (std::string(argv[i]) == "--grass-patches") grassPatches = true;
+        if (std::string(argv[i]) == "--grass-ring") grassRing = true;
+        if (std::string(argv[i]) == "--grass-seed" && i + 1 < argc) grassSeed = (uint32_t)std::strtoul(argv[++i], nullptr, 10);
+        if (std::string(argv[i]) != "--procedural") continue;
+        proceduralTerrain = true;
+        if (i + 1 < argc && argv[i + 1][0] != '-') proceduralSettings.seed = (uint32_t)std::strtoul(argv[++i], nullptr, 10);
+        if (i + 1 < argc && argv[i + 1][0] != '-') proceduralSize = std::max(64.0f, std::strtof(argv[++i], nullptr));
+    }
+
     glfwInit();
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
@@ -62,11 +95,30 @@ int main()
     int fbW, fbH; glfwGetFramebufferSize(window, &fbW, &fbH);
     PostProcessor postEffects(fbW, fbH);
 
-    Shader terrainShader("../shaders/terrain.vs.glsl", "../shaders/terrain.fs.glsl");
     Shader objectShader("../shaders/object.vs.glsl", "../shaders/object.fs.glsl");
     Shader waterShader("../shaders/water.vs.glsl", "../shaders/water.fs.glsl");
 
-    Terrain terrain("../assets/terrain/landscape.glb");
+    // Abgeleitete Terrain-Daten (GPU-Buffer, Grid, Raster, Splat Map, BVH) liegen nach dem ersten Start
+    // in landscape.glb.cache und werden dann per mmap geladen statt neu importiert
+    const std::string terrainPath = "../assets/terrain/landscape.glb";
+    const float terrainScale = 60.0f;
+    TerrainCache terrainCache(terrainPath, Terrain::cacheSignature() + " " + TerrainQuery::cacheSignature(terrainScale));
+    TerrainCache* cache = proceduralTerrain ? nullptr : &terrainCache;
+
+    // Generiertes Mesh: ca. 2 Welteinheiten pro Quad, zentriert um den Ursprung
+    Terrain terrain = [&]() {
+        if (!proceduralTerrain) return Terrain(terrainPath, cache);
+        TerrainGenerator generator(proceduralSettings);
+        std::vector<float> vertices;
+        std::vector<unsigned int> indices;
+        int resolution = (int)(proceduralSize / 2.0f) + 1;
+        generator.generateMesh(glm::vec2(-0.5f * proceduralSize), proceduralSize, resolution, terrainScale, vertices, indices);
+        std::cout << "Prozedurales Terrain: Seed " << proceduralSettings.seed << ", " << resolution << "x" << resolution << " Vertices" << std::endl;
+        return Terrain(std::move(vertices), std::move(indices));
+    }();
+    // Eine Shader-Variante pro Material-Klasse, die volle Variante nutzt auch das Heightmap-Terrain
+    terrain.loadShaders("../shaders/terrain.vs.glsl", "../shaders/terrain.fs.glsl");
+    Shader& terrainShader = terrain.getShader(TerrainMaterialClass::All);
     WaterPlane waterPlane(800.0f, 800);
 
     std::vector<std::string> dayFaces = {
@@ -79,12 +131,41 @@ int main()
     };
     Skybox skybox(dayFaces, nightFaces);
 
+    // --- TERRAIN QUERY (eine geteilte Kopie + Grid für Gras, Wald & Picking) ---
+    TerrainQuery terrainQuery(terrain, terrainScale, cache);
+    terrain.releaseGeometry();
+    terrain.bakeSplatMap(terrainQuery, cache);
+
+    // CDLOD-Variante aus dem gebackenen Raster (in den Settings umschaltbar)
+    HeightmapTerrain heightmapTerrain(terrainQuery);
+
+    // BVH für Raycasts gegen das Terrain (Editor-Platzierung, Kamera-Clamp, Sichtlinien)
+    TerrainBVH terrainBVH(terrainQuery, cache);
+    inputManager.setTerrainBVH(&terrainBVH);
+
+    // Nach einem Neubau den Cache schreiben, danach das Mapping freigeben (alle Daten sind übernommen)
+    if (cache) terrainCache.save();
+    terrainCache.release();
+
+    // Virtual Texturing wird erst beim Einschalten angelegt (Atlas + Loader-Thread)
+    std::unique_ptr<VirtualTexture> virtualTexture;
+
+    // Gekachelte Welt aus ../assets/world (ersetzt beim Einschalten Landschaft, Wald und Gras; beim Ausschalten freigegeben)
+    std::unique_ptr<TerrainStreamer> terrainStreamer;
+    int streamerSeed = 0;
+
     // --- GRASS SETUP ---
     GrassSystem grassSystem;
-    grassSystem.initTerrainData(terrain.getVertices(), terrain.getIndices(), 60.0f);
+    grassSystem.initTerrainData(terrainQuery);
+    grassSystem.setPlacementSeed(grassSeed);
+    if (grassRing) grassSystem.enableRing(6, 3); // 13x13 Tiles a 32m, deckt die LOD-Maximaldistanz (180) ab
     std::string gp = "../assets/grass/"; float sp = 190.0f;
 
-    for (int i = 1; i <= 6; i++) grassSystem.addGrassType(gp + "grass_" + (i<10?"0":"") + std::to_string(i) + ".png", 800000, sp, 0.15f, false);
+    for (int i = 1; i <= 6; i++) {
+        std::string path = gp + "grass_" + (i<10?"0":"") + std::to_string(i) + ".png";
+        if (grassPatches) grassSystem.addPatchGrassType(path, 8, 1.25f, 120.0f, 0.15f);
+        else grassSystem.addGrassType(path, 800000, sp, 0.15f, false);
+    }
     for (int i = 7; i <= 10; i++) grassSystem.addGrassType(gp + "grass_" + (i<10?"0":"") + std::to_string(i) + ".png", 8000, sp, 0.2f, false);
     for (int i = 11; i <= 12; i++) grassSystem.addGrassType(gp + "grass_" + std::to_string(i) + ".png", 1000, sp, 0.2f, false);
     grassSystem.addGrassType(gp + "grass_13.png", 8000, sp, 0.2f, false);
@@ -93,7 +174,7 @@ int main()
 
     // --- FOREST SETUP ---
     ForestSystem forest;
-    forest.initTerrainData(terrain.getVertices(), terrain.getIndices(), 60.0f);
+    forest.initTerrainData(terrainQuery);
 
     std::string fp = "../assets/forrest/";
 
@@ -111,15 +192,20 @@ int main()
     // 100 Gruppen Gestrüpp (verbindet die Wälder)
     forest.addBiomeCluster("Scrub", 100, fp);
 
+    // Terrain-Editor (Pinsel im Menü-Modus, siehe Settings)
+    TerrainSculptor sculptor(terrainQuery, terrain, heightmapTerrain, terrainBVH, grassSystem, forest);
+
     // Shader config
-    terrainShader.use();
-    terrainShader.setInt("pebblesAlbedo", 0); terrainShader.setInt("pebblesNormal", 1); terrainShader.setInt("pebblesARM", 2);
-    terrainShader.setInt("groundAlbedo", 3); terrainShader.setInt("groundNormal", 4); terrainShader.setInt("groundARM", 5);
-    terrainShader.setInt("rockAlbedo", 6); terrainShader.setInt("rockNormal", 7); terrainShader.setInt("rockARM", 8);
-    terrainShader.setFloat("tiling", 60.0f);
+    for (Shader* s : terrain.getShaders()) { s->use(); s->setFloat("tiling", 60.0f); }
 
     glm::vec3 sunPosDay(50.0f, 100.0f, 50.0f), sunColorDay(1.0f);
     glm::vec3 sunPosNight(50.0f, 100.0f, -50.0f), sunColorNight(0.1f, 0.1f, 0.3f);
+
+    // Gebackene Großflächen-Beleuchtung (AO + Horizont zu Sonne und Mond), nach dem Wald wegen der Baumkronen
+    std::vector<glm::vec4> canopies;
+    forest.collectOccluders(canopies);
+    TerrainLightBake lightBake(terrainQuery, terrainBVH, canopies, { sunPosDay, sunPosNight });
+    sculptor.setLightBake(&lightBake);
     double lastFrame = 0.0;
 
     while (!glfwWindowShouldClose(window))
@@ -134,33 +220,131 @@ int main()
         skybox.setDay(isDay);
         skybox.setNightFactor(isDay ? 0.0f : 1.0f);
 
-        auto setLight = [&](Shader& s) { s.use(); s.setVec3("lightPos", curSunPos); s.setVec3("lightColor", curSunCol); };
-        setLight(terrainShader); setLight(objectShader); setLight(waterShader);
-
         inputManager.processInput(deltaTime);
+
+        const bool streaming = terrainSettings.useTerrainStreaming;
+
+        // Gebackene Beleuchtung nur über der Landschaft (Licht 0 = Sonne, 1 = Mond)
+        const bool bakedLighting = terrainSettings.useBakedLighting && !streaming;
+        auto setLight = [&](Shader& s) {
+            s.use(); s.setVec3("lightPos", curSunPos); s.setVec3("lightColor", curSunCol);
+            lightBake.apply(s, isDay ? 0 : 1, bakedLighting);
+        };
+        for (Shader* s : terrain.getShaders()) setLight(*s);
+        setLight(objectShader); setLight(grassSystem.getShader()); setLight(grassSystem.getPatchShader());
+        waterShader.use(); waterShader.setVec3("lightPos", curSunPos); waterShader.setVec3("lightColor", curSunCol);
+
+        if (streaming) {
+            // Fehlende Tiles erzeugt der TerrainGenerator, neuer Seed -> Streamer neu anlegen
+            if (terrainStreamer && streamerSeed != terrainSettings.worldSeed) terrainStreamer.reset();
+            if (!terrainStreamer) {
+                TerrainGeneratorSettings worldSettings;
+                worldSettings.seed = (uint32_t)terrainSettings.worldSeed;
+                TerrainGenerator worldGenerator(worldSettings);
+                terrainStreamer = std::make_unique<TerrainStreamer>("../assets/world",
+                    [worldGenerator](int tileX, int tileZ, float tileSize, int resolution, TerrainTileData& out) {
+                        return worldGenerator.generateTile(tileX, tileZ, tileSize, resolution, out);
+                    });
+                streamerSeed = terrainSettings.worldSeed;
+            }
+            terrainStreamer->setMemoryBudget((size_t)terrainSettings.streamingBudgetMB * 1024 * 1024);
+            terrainStreamer->setLoadRadius(terrainSettings.streamingRadius);
+            terrainStreamer->update(camera.getPosition(), deltaTime, grassSystem);
+        } else if (terrainStreamer) {
+            terrainStreamer.reset();
+        }
+
+        // Pinsel und BVH beziehen sich auf die Landschaft, nicht auf die gestreamte Welt
+        const bool sculpting = terrainSettings.sculptMode > 0 && !streaming;
+        inputManager.setTerrainEditing(sculpting);
+        if (sculpting && inputManager.isMenuMode() && !ui.isMouseCaptured() &&
+            glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_LEFT) == GLFW_PRESS) {
+            glm::vec3 cursor;
+            if (inputManager.getTerrainCursor(cursor)) {
+                TerrainBrushMode mode = (TerrainBrushMode)(terrainSettings.sculptMode - 1);
+                sculptor.apply(cursor, terrainSettings.sculptRadius, terrainSettings.sculptStrength * deltaTime, mode);
+            }
+        } else {
+            lightBake.updateDirty(); // erst nach dem Strich, der Bereich ist zu groß für jeden Frame
+        }
+        if (terrainSettings.clampCameraToGround && camera.mode == Camera::FREE) {
+            // Von oben nach unten casten, damit auch eine Kamera unter dem Boden wieder hochkommt
+            const float eyeHeight = 1.5f;
+            glm::vec3 camPos = camera.getPosition();
+            float groundHeight = 0.0f;
+            bool hasGround = false;
+            if (streaming) {
+                hasGround = terrainStreamer->getHeight(camPos.x, camPos.z, groundHeight);
+            } else {
+                TerrainRayHit ground = terrainBVH.raycast(glm::vec3(camPos.x, camPos.y + 1000.0f, camPos.z), glm::vec3(0.0f, -1.0f, 0.0f));
+                hasGround = ground.hit;
+                groundHeight = ground.position.y;
+            }
+            if (hasGround && camPos.y < groundHeight + eyeHeight)
+                camera.setPosition(glm::vec3(camPos.x, groundHeight + eyeHeight, camPos.z));
+        }
         int cw, ch; glfwGetFramebufferSize(window, &cw, &ch);
         if (cw == 0 || ch == 0) { glfwWaitEvents(); continue; }
         postEffects.checkResize(cw, ch);
 
+        glm::mat4 proj = glm::perspective(glm::radians(camera.getFov()), (float)cw/(float)ch, NEAR_PLANE, FAR_PLANE);
+        glm::mat4 view = camera.getViewMatrix();
+        glm::mat4 terrainModel = (terrainSettings.useHeightmapTerrain || streaming)
+            ? glm::mat4(1.0f) // Heightmap und Tiles liegen bereits in Weltkoordinaten
+            : glm::scale(glm::mat4(1.0f), glm::vec3(terrainScale));
+
+        // Virtual Texture: Pages hochladen + Feedback-Pass (vor dem Haupt-Framebuffer), deckt nur die Landschaft ab
+        const bool useVirtualTexture = terrainSettings.useVirtualTexture && !streaming;
+        if (useVirtualTexture) {
+            if (!virtualTexture) {
+                terrain.prepareAlbedoComposer(60.0f);
+                virtualTexture = std::make_unique<VirtualTexture>(
+                    "../assets/terrain/vt", terrain.getSplatWorldMin(), terrain.getSplatWorldSize(),
+                    [&terrain](const glm::vec2& regionMin, const glm::vec2& regionSize, unsigned char* out) {
+                        terrain.composeAlbedo(regionMin, regionSize, VirtualTexture::PAGE_SIZE, out);
+                    });
+                sculptor.setVirtualTexture(virtualTexture.get());
+            }
+            virtualTexture->update();
+
+            virtualTexture->beginFeedback(cw, ch);
+            Shader& feedbackShader = virtualTexture->getFeedbackShader();
+            feedbackShader.setMat4("projection", proj); feedbackShader.setMat4("view", view);
+            feedbackShader.setMat4("model", terrainModel);
+            feedbackShader.setVec3("viewPos", camera.getPosition());
+            if (terrainSettings.useHeightmapTerrain) {
+                terrain.applyStaticUniforms(feedbackShader);
+                heightmapTerrain.draw(feedbackShader, proj * view, camera.getPosition());
+            } else {
+                terrain.drawGeometry(feedbackShader, proj * view * terrainModel);
+            }
+            virtualTexture->endFeedback();
+        }
+
         postEffects.beginRender();
         glClearColor(curFogCol.r, curFogCol.g, curFogCol.b, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        glm::mat4 proj = glm::perspective(glm::radians(camera.getFov()), (float)cw/(float)ch, NEAR_PLANE, FAR_PLANE);
-        glm::mat4 view = camera.getViewMatrix();
-
         // Terrain
-        terrainShader.use();
-        terrainShader.setBool("useNormalMap", useNormalMap);
-        terrainShader.setMat4("projection", proj); terrainShader.setMat4("view", view);
-        terrainShader.setMat4("model", glm::scale(glm::mat4(1.0f), glm::vec3(60.0f)));
-        terrainShader.setVec3("viewPos", camera.getPosition());
-        terrain.draw(terrainShader);
-
-        // [FIX] Textur-Slots säubern, damit Bäume nicht Terrain-Texturen erben
-        glActiveTexture(GL_TEXTURE0); glBindTexture(GL_TEXTURE_2D, 0);
-        glActiveTexture(GL_TEXTURE1); glBindTexture(GL_TEXTURE_2D, 0);
-        glActiveTexture(GL_TEXTURE2); glBindTexture(GL_TEXTURE_2D, 0);
+        for (Shader* s : terrain.getShaders()) {
+            s->use();
+            s->setBool("useNormalMap", useNormalMap);
+            s->setMat4("projection", proj); s->setMat4("view", view);
+            s->setMat4("model", terrainModel);
+            s->setVec3("viewPos", camera.getPosition());
+            if (useVirtualTexture) virtualTexture->bind(*s);
+            else s->setBool("useVirtualTexture", false);
+        }
+        if (streaming) {
+            terrain.bindMaterials();
+            terrainStreamer->draw(terrainShader, proj * view, camera.getPosition());
+            terrain.applyStaticUniforms(terrainShader); // Splat-Bereich der Landschaft wiederherstellen
+        } else if (terrainSettings.useHeightmapTerrain) {
+            terrain.bindMaterials();
+            heightmapTerrain.draw(terrainShader, proj * view, camera.getPosition());
+        } else {
+            terrain.draw(proj * view * terrainModel);
+        }
 
         // Objects & Forest
         objectShader.use();
@@ -170,10 +354,16 @@ int main()
         objectShader.setVec3("viewPos", camera.getPosition());
 
         sceneManager.drawAll(objectShader); // Manuell platzierte Objekte
-        forest.draw(objectShader, view, proj, camera.getPosition()); // Automatisch generierter Wald
-
-        // Grass & Skybox
-        grassSystem.draw(view, proj, (float)glfwGetTime(), camera.getPosition(), curSunPos, curSunCol);
+        if (!streaming) forest.draw(objectShader, view, proj, camera.getPosition()); // Automatisch generierter Wald
+
+        // Grass & Skybox (gestreamte Welt: nur das Gras der nahen Tiles)
+        grassSystem.setLodDistances(terrainSettings.grassFullDensityDistance, terrainSettings.grassMaxDistance);
+        if (streaming) {
+            grassSystem.drawBatches(terrainStreamer->getVisibleGrass(), view, proj, (float)glfwGetTime(),
+                                    camera.getPosition(), curSunPos, curSunCol);
+        } else {
+            grassSystem.draw(view, proj, (float)glfwGetTime(), camera.getPosition(), curSunPos, curSunCol);
+        }
         skybox.draw(view, proj);
 
         // Water
@@ -188,8 +378,43 @@ int main()
 
         postEffects.endRender(NEAR_PLANE, FAR_PLANE, curFogCol, enableFog ? fogDensity : 0.0f);
 
+        RenderStats stats;
+        stats.sculptMs = sculptor.getLastEditMs();
+        stats.lightBakeMs = lightBake.getBakeMs();
+        stats.terrainChunksVisible = terrain.getStats().chunksVisible;
+        stats.terrainChunksTotal = terrain.getStats().chunksTotal;
+        stats.terrainTrianglesDrawn = terrain.getStats().trianglesDrawn;
+        stats.terrainTrianglesTotal = terrain.getStats().trianglesTotal;
+        if (terrainSettings.useHeightmapTerrain) {
+            stats.terrainPatches = heightmapTerrain.getPatchesDrawn();
+            stats.terrainLodCount = heightmapTerrain.getLodCount();
+            stats.terrainTrianglesDrawn = heightmapTerrain.getTrianglesDrawn();
+        }
+        if (streaming) {
+            const TerrainStreamStats& streamStats = terrainStreamer->getStats();
+            stats.streamTilesResident = streamStats.tilesResident;
+            stats.streamTilesPending = streamStats.tilesPending;
+            stats.streamTilesDrawn = streamStats.tilesDrawn;
+            stats.streamMemoryMB = (float)streamStats.residentBytes / (1024.0f * 1024.0f);
+        }
+        // Gestreamt: Batches der nahen Tiles (drawBatches), sonst Chunks, Ring und Patches (draw)
+        const GrassStats& grassStats = grassSystem.getStats();
+        stats.grassChunksVisible = grassStats.chunksVisible;
+        stats.grassChunksTotal = grassStats.chunksTotal;
+        stats.grassInstancesDrawn = grassStats.instancesDrawn;
+        stats.grassInstancesTotal = grassStats.instancesTotal;
+        stats.grassDrawCalls = grassStats.drawCalls;
+        stats.grassPatchCardsDrawn = grassStats.patchCardsDrawn;
+        stats.grassRingTilesResident = grassStats.ringTilesResident;
+        stats.grassRingTilesPending = grassStats.ringTilesPending;
+        stats.grassRingBufferMB = grassStats.ringBufferMB;
+        if (virtualTexture && useVirtualTexture) {
+            stats.vtResidentPages = virtualTexture->getResidentPages();
+            stats.vtPendingPages = virtualTexture->getPendingPages();
+        }
+
         ui.beginFrame();
-        ui.renderUI(camera, sceneManager, view, proj, useNormalMap, useARMMap, limitFps, fpsLimit, enableFog, fogDensity, isDay);
+        ui.renderUI(camera, sceneManager, view, proj, useNormalMap, useARMMap, limitFps, fpsLimit, enableFog, fogDensity, isDay, terrainSettings, stats);
         ui.endFrame();
 
         glfwSwapBuffers(window);